@@ -1,4 +1,8 @@
+// Expose pread(), pwrite(), mmap() and posix_fadvise() despite -std=c99:
+#define _GNU_SOURCE
+
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <math.h>
 #include <node_api.h>
@@ -6,11 +10,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
+
+#include "reed_solomon.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define RESOURCE_NAME "@ronomon/reed-solomon"
 
+// The call is evaluated even if NDEBUG is defined:
 #define OK(call)                                                               \
-  assert((call) == napi_ok);
+  do {                                                                         \
+    napi_status ok_status = (call);                                            \
+    assert(ok_status == napi_ok);                                              \
+    (void) ok_status;                                                          \
+  } while (0);
+
+#define OK_UV(call)                                                            \
+  do {                                                                         \
+    int ok_status = (call);                                                    \
+    assert(ok_status == 0);                                                    \
+    (void) ok_status;                                                          \
+  } while (0);
 
 #define THROW(env, message)                                                    \
   do {                                                                         \
@@ -18,817 +44,102 @@
     return NULL;                                                               \
   } while (0)
 
-#define MAX_K 24
-#define MAX_M 6
-#define MAX_W 8
-
-// Parameters for (k,m) found by `search()` are in PARAMETERS[k-1][m-1]:
-// PARAMETERS[k-1][m-1] = k, m, w, p, x, y, b:
-//
-// k = The number of data shards.
-// m = The number of parity shards.
-// w = The Galois Field exponent. The smaller the exponent, the less bits.
-// p = The primitive polynomial used to generate the Galois Field.
-//
-//     We do not use x or y when m <= 2:
-// x = The column offset used to generate the matrix, -1 when m <= 2.
-// y = The row offset used to generate the matrix, -1 when m <= 2.
-//
-// b = The number of bits in the resulting bit matrix.
-static const int PARAMETERS[24][6][7] = {
-  {
-    {  1, 1, 2,   7,  -1,  -1,    2 },
-    {  1, 2, 2,   7,  -1,  -1,    4 },
-    {  1, 3, 2,   7,   0,   1,    6 },
-    {  1, 4, 4,  19,   0,   1,   16 },
-    {  1, 5, 4,  19,   0,   1,   20 },
-    {  1, 6, 4,  19,   0,   1,   24 }
-  },
-  {
-    {  2, 1, 2,   7,  -1,  -1,    4 },
-    {  2, 2, 2,   7,  -1,  -1,    9 },
-    {  2, 3, 4,  19,   0,   4,   28 },
-    {  2, 4, 4,  19,   0,   5,   40 },
-    {  2, 5, 4,  19,   2,   9,   51 },
-    {  2, 6, 4,  19,   4,  10,   62 }
-  },
-  {
-    {  3, 1, 2,   7,  -1,  -1,    6 },
-    {  3, 2, 4,  19,  -1,  -1,   26 },
-    {  3, 3, 4,  19,   0,   9,   44 },
-    {  3, 4, 4,  19,   1,   8,   63 },
-    {  3, 5, 4,  19,   1,   9,   82 },
-    {  3, 6, 4,  19,   0,   9,  101 }
-  },
-  {
-    {  4, 1, 4,  19,  -1,  -1,   16 },
-    {  4, 2, 4,  19,  -1,  -1,   36 },
-    {  4, 3, 4,  19,   0,   9,   63 },
-    {  4, 4, 4,  19,   3,  11,   89 },
-    {  4, 5, 4,  19,   3,  11,  116 },
-    {  4, 6, 4,  19,  11,   4,  145 }
-  },
-  {
-    {  5, 1, 4,  19,  -1,  -1,   20 },
-    {  5, 2, 4,  19,  -1,  -1,   47 },
-    {  5, 3, 4,  19,   4,  13,   82 },
-    {  5, 4, 4,  19,   3,  12,  118 },
-    {  5, 5, 4,  19,   0,   9,  152 },
-    {  5, 6, 4,  19,   0,   9,  185 }
-  },
-  {
-    {  6, 1, 4,  19,  -1,  -1,   24 },
-    {  6, 2, 4,  19,  -1,  -1,   58 },
-    {  6, 3, 4,  19,   2,  12,  102 },
-    {  6, 4, 4,  19,   2,  12,  144 },
-    {  6, 5, 4,  19,   0,   9,  186 },
-    {  6, 6, 4,  19,   0,   9,  231 }
-  },
-  {
-    {  7, 1, 4,  19,  -1,  -1,   28 },
-    {  7, 2, 4,  19,  -1,  -1,   71 },
-    {  7, 3, 4,  19,   1,  13,  123 },
-    {  7, 4, 4,  19,   2,  12,  174 },
-    {  7, 5, 4,  19,   0,   9,  226 },
-    {  7, 6, 4,  19,   7,   0,  277 }
-  },
-  {
-    {  8, 1, 4,  19,  -1,  -1,   32 },
-    {  8, 2, 4,  19,  -1,  -1,   84 },
-    {  8, 3, 4,  19,   2,  13,  142 },
-    {  8, 4, 4,  19,   2,  12,  205 },
-    {  8, 5, 4,  19,   0,   9,  265 },
-    {  8, 6, 4,  19,   0,   8,  328 }
-  },
-  {
-    {  9, 1, 4,  19,  -1,  -1,   36 },
-    {  9, 2, 4,  19,  -1,  -1,   97 },
-    {  9, 3, 4,  19,   1,  13,  162 },
-    {  9, 4, 4,  19,   2,  12,  237 },
-    {  9, 5, 4,  19,   0,   9,  308 },
-    {  9, 6, 4,  19,   1,  10,  376 }
-  },
-  {
-    { 10, 1, 4,  19,  -1,  -1,   40 },
-    { 10, 2, 4,  19,  -1,  -1,  111 },
-    { 10, 3, 4,  19,   1,  13,  186 },
-    { 10, 4, 4,  19,   0,  12,  268 },
-    { 10, 5, 4,  19,   0,  11,  347 },
-    { 10, 6, 4,  19,   0,  10,  426 }
-  },
-  {
-    { 11, 1, 4,  19,  -1,  -1,   44 },
-    { 11, 2, 4,  19,  -1,  -1,  125 },
-    { 11, 3, 4,  19,   0,  13,  211 },
-    { 11, 4, 4,  19,   0,  12,  300 },
-    { 11, 5, 4,  19,   0,  11,  390 },
-    { 11, 6, 8, 135,  58, 188, 1401 }
-  },
-  {
-    { 12, 1, 4,  19,  -1,  -1,   48 },
-    { 12, 2, 4,  19,  -1,  -1,  139 },
-    { 12, 3, 4,  19,   3,   0,  234 },
-    { 12, 4, 4,  19,   0,  12,  334 },
-    { 12, 5, 8, 113,  24, 208, 1269 },
-    { 12, 6, 8, 135,  57, 188, 1577 }
-  },
-  {
-    { 13, 1, 4,  19,  -1,  -1,   52 },
-    { 13, 2, 4,  19,  -1,  -1,  155 },
-    { 13, 3, 4,  19,   0,  13,  261 },
-    { 13, 4, 8, 135,  59, 189, 1037 },
-    { 13, 5, 8, 113,  27, 236, 1393 },
-    { 13, 6, 8, 113,  27, 236, 1733 }
-  },
-  {
-    { 14, 1, 4,  19,  -1,  -1,   56 },
-    { 14, 2, 4,  19,  -1,  -1,  171 },
-    { 14, 3, 8, 169,   4, 252,  777 },
-    { 14, 4, 8, 135,  58, 189, 1121 },
-    { 14, 5, 8, 135,  58, 189, 1508 },
-    { 14, 6, 8, 135,  58, 188, 1880 }
-  },
-  {
-    { 15, 1, 4,  19,  -1,  -1,   60 },
-    { 15, 2, 8, 135,  -1,  -1,  353 },
-    { 15, 3, 8, 113,  24, 209,  836 },
-    { 15, 4, 8, 135,  58, 189, 1225 },
-    { 15, 5, 8, 101,  28, 232, 1644 },
-    { 15, 6, 8, 113, 120, 241, 2037 }
-  },
-  {
-    { 16, 1, 8,  29,  -1,  -1,  128 },
-    { 16, 2, 8, 135,  -1,  -1,  380 },
-    { 16, 3, 8, 113,  22, 213,  901 },
-    { 16, 4, 8, 113,  22, 212, 1324 },
-    { 16, 5, 8, 101,  28, 232, 1765 },
-    { 16, 6, 8, 101,  28, 232, 2195 }
-  },
-  {
-    { 17, 1, 8,  29,  -1,  -1,  136 },
-    { 17, 2, 8, 135,  -1,  -1,  407 },
-    { 17, 3, 8, 113,  22, 213,  960 },
-    { 17, 4, 8, 135,  58, 189, 1423 },
-    { 17, 5, 8, 101,  27, 232, 1880 },
-    { 17, 6, 8, 101,  27, 232, 2343 }
-  },
-  {
-    { 18, 1, 8,  29,  -1,  -1,  144 },
-    { 18, 2, 8, 135,  -1,  -1,  434 },
-    { 18, 3, 8, 113,  24, 213, 1027 },
-    { 18, 4, 8, 113,  22, 212, 1513 },
-    { 18, 5, 8, 195,   8,  32, 2019 },
-    { 18, 6, 8, 113, 205, 126, 2500 }
-  },
-  {
-    { 19, 1, 8,  29,  -1,  -1,  152 },
-    { 19, 2, 8, 135,  -1,  -1,  462 },
-    { 19, 3, 8, 113,  22, 213, 1086 },
-    { 19, 4, 8, 113,  23, 212, 1604 },
-    { 19, 5, 8, 195,   7,  32, 2131 },
-    { 19, 6, 8, 195,   3,  60, 2654 }
-  },
-  {
-    { 20, 1, 8,  29,  -1,  -1,  160 },
-    { 20, 2, 8, 135,  -1,  -1,  490 },
-    { 20, 3, 8, 113,  22, 213, 1147 },
-    { 20, 4, 8, 113,  22, 212, 1695 },
-    { 20, 5, 8, 195,   4, 238, 2270 },
-    { 20, 6, 8, 113,  21, 233, 2816 }
-  },
-  {
-    { 21, 1, 8,  29,  -1,  -1,  168 },
-    { 21, 2, 8, 135,  -1,  -1,  518 },
-    { 21, 3, 8, 113,  21, 213, 1225 },
-    { 21, 4, 8, 113,  21, 212, 1801 },
-    { 21, 5, 8, 195,   3,  60, 2395 },
-    { 21, 6, 8, 195,   3,  60, 2980 }
-  },
-  {
-    { 22, 1, 8,  29,  -1,  -1,  176 },
-    { 22, 2, 8, 135,  -1,  -1,  546 },
-    { 22, 3, 8, 113,  20, 213, 1292 },
-    { 22, 4, 8, 113,  21, 212, 1906 },
-    { 22, 5, 8, 195,  35,  28, 2512 },
-    { 22, 6, 8, 195,   3,  60, 3135 }
-  },
-  {
-    { 23, 1, 8,  29,  -1,  -1,  184 },
-    { 23, 2, 8, 135,  -1,  -1,  574 },
-    { 23, 3, 8, 113,  19, 213, 1366 },
-    { 23, 4, 8, 113,  19, 212, 2008 },
-    { 23, 5, 8, 195,   3, 238, 2652 },
-    { 23, 6, 8, 113, 205, 126, 3291 }
-  },
-  {
-    { 24, 1, 8,  29,  -1,  -1,  192 },
-    { 24, 2, 8, 135,  -1,  -1,  603 },
-    { 24, 3, 8, 113,  18, 213, 1437 },
-    { 24, 4, 8, 195, 125,  91, 2110 },
-    { 24, 5, 8, 195,   3, 238, 2787 },
-    { 24, 6, 8, 195,  42, 225, 3466 }
-  }
-};
-
-static int g_divide(
-  const int* log,
-  const int* exp,
-  const int w,
-  const int a,
-  const int b
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  const int y = (1 << w) - 1;
-  assert(a <= y);
-  assert(b <= y);
-  assert(b >= 1);
-  if (a == 0) return 0;
-  return exp[(log[a] + y - log[b]) % y];
-}
-
-static int g_multiply(
-  const int* log,
-  const int* exp,
-  const int w,
-  const int a,
-  const int b
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  const int y = (1 << w) - 1;
-  assert(a <= y);
-  assert(b <= y);
-  if (a == 0 || b == 0) return 0;
-  return exp[(log[a] + log[b]) % y];
-}
+#define MAX_K REED_SOLOMON_MAX_K
+#define MAX_M REED_SOLOMON_MAX_M
+#define MAX_W REED_SOLOMON_MAX_W
 
-static int bitmatrix_m0_optimized(
-  const int w,
-  const int k,
-  const uint8_t* bitmatrix
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(k < (1 << w));
-  // We assume that bitmatrix is an encoding (not decoding) bitmatrix.
-  // If row 0 is all ones then an erasure of shard < k + 1 can be optimized.
-  for (int c = 0; c < k; c++) {
-    for (int a = 0; a < w; a++) {
-      if (a == 0) {
-        if (bitmatrix[c * w + a] != 1) return 0;
-      } else {
-        if (bitmatrix[c * w + a] != 0) return 0;
-      }
-    }
-  }
+static int arg_shared(napi_env env, napi_value value, napi_value* view) {
+  // Returns 1 and a Uint8Array view if value is a SharedArrayBuffer, which
+  // N-API (before Node 24) cannot otherwise read:
+  napi_valuetype type;
+  OK(napi_typeof(env, value, &type));
+  if (type != napi_object) return 0;
+  napi_value global;
+  OK(napi_get_global(env, &global));
+  napi_value constructor;
+  OK(napi_get_named_property(env, global, "SharedArrayBuffer", &constructor));
+  OK(napi_typeof(env, constructor, &type));
+  if (type != napi_function) return 0;
+  bool is_shared = 0;
+  OK(napi_instanceof(env, value, constructor, &is_shared));
+  if (!is_shared) return 0;
+  OK(napi_get_named_property(env, global, "Uint8Array", &constructor));
+  OK(napi_new_instance(env, constructor, 1, &value, view));
   return 1;
 }
 
-static void create_bitmatrix_decoding_swap(
-  uint8_t* buffer,
-  const int x,
-  const int y
-) {
-  const uint8_t tmp = buffer[x];
-  buffer[x] = buffer[y];
-  buffer[y] = tmp;
-}
-
-static void create_bitmatrix_decoding_invert(
-  uint8_t* source,
-  uint8_t* target,
-  const int rows
-) {
-  const int cols = rows;
-  int k = 0;
-  for (int r = 0; r < rows; r++) {
-    for (int c = 0; c < cols; c++) {
-      target[k++] = (r == c) ? 1 : 0;
-    }
-  }
-  for (int c = 0; c < cols; c++) {
-    if ((source[c * cols + c]) == 0) {
-      int r = c + 1;
-      while (r < rows && source[r * cols + c] == 0) r++;
-      // Assert that matrix is invertible:
-      assert(r != rows);
-      for (int k = 0; k < cols; k++) {
-        create_bitmatrix_decoding_swap(source, c * cols + k, r * cols + k);
-        create_bitmatrix_decoding_swap(target, c * cols + k, r * cols + k);
-      }
-    }
-    for (int r = c + 1; r != rows; r++) {
-      if (source[r * cols + c] != 0) {
-        for (int k = 0; k < cols; k++) {
-          source[r * cols + k] ^= source[c * cols + k];
-          target[r * cols + k] ^= target[c * cols + k];
-        }
-      }
-    }
-  }
-  for (int r = rows - 1; r >= 0; r--) {
-    for (int c = 0; c < r; c++) {
-      if (source[c * cols + r]) {
-        for (int k = 0; k < cols; k++) {
-          source[c * cols + k] ^= source[r * cols + k]; 
-          target[c * cols + k] ^= target[r * cols + k];
-        }
-      }
-    }
-  }
-}
-
-static void create_bitmatrix_decoding(
-  const int w,
-  const int k,
-  const int m,
-  const int* sourceIndex,
-  const uint8_t* source,
-  uint8_t* target
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(m >= 1);
-  assert(m <= MAX_M);
-  assert(k + m <= (1 << w));
-  const int kww = k * w * w;
-  uint8_t matrix[MAX_K * MAX_K * MAX_W * MAX_W];
-  for (int a = 0; a < k; a++) {
-    if (sourceIndex[a] < k) {
-      for (int b = 0; b < kww; b++) matrix[kww * a + b] = 0;
-      int index = kww * a + sourceIndex[a] * w;
-      for (int b = 0; b < w; b++) {
-        matrix[index] = 1;
-        index += (k * w + 1);
-      }
-    } else {
-      for (int b = 0; b < kww; b++) {
-        matrix[kww * a + b] = source[kww * (sourceIndex[a] - k) + b];
-      }
-    }
-  }
-  create_bitmatrix_decoding_invert(matrix, target, k * w);
-}
-
-static int create_bitmatrix_encoding(
-  const int* log,
-  const int* exp,
-  const int w,
-  const int k,
-  const int m,
-  const uint8_t* matrix,
-  uint8_t* bitmatrix
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(m >= 1);
-  assert(m <= MAX_M);
-  assert(k + m <= (1 << w));
-  int count = 0;
-  for (int r = 0; r < m; r++) {
-    for (int c = 0; c < k; c++) {
-      int x = matrix[(k * r) + c];
-      for (int a = 0; a < w; a++) {
-        for (int b = 0; b < w; b++) {
-          int y = (x & (1 << b)) ? 1 : 0;
-          bitmatrix[(r * w * k * w) + (w * c) + a + (k * w * b)] = y;
-          count += y;
-        }
-        x = g_multiply(log, exp, w, x, 2);
-      }
-    }
-  }
-  assert(count > 0);
-  return count;
-}
-
-static int create_matrix(
-  const int* log,
-  const int* exp,
-  const int* bit,
-  const int* min,
-  const int w,
-  const int k,
-  const int m,
-  const int x,
-  const int y,
-  uint8_t* matrix
+static int arg_bytes(
+  napi_env env,
+  napi_value value,
+  uint8_t** buffer,
+  uint64_t* buffer_length
 ) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(m >= 1);
-  assert(m <= MAX_M);
-  assert(k + m <= (1 << w));
-  const int z = 1 << w;
-  int count = bit[1] * k;
-  if (m == 1) {
-    // Use XOR for row 0.
-    assert(x == -1);
-    assert(y == -1);
-    for (int c = 0; c < k; c++) matrix[c] = 1;
-  } else if (m == 2) {
-    // Use XOR for row 0.
-    // Use integers with least number of bits for row 1.
-    assert(x == -1);
-    assert(y == -1);
-    for (int c = 0; c < k; c++) matrix[c] = 1;
-    for (int c = 0; c < k; c++) {
-      matrix[k + c] = min[c + 1];
-      if (c == 0) assert(matrix[k + c] == 1);
-      assert(matrix[k + c] > 0);
-      count += bit[matrix[k + c]];
-    }
-  } else {
-    // Use XOR for row 0.
-    // Use generic matrix thereafter.
-    assert(x + k <= z);
-    assert(y + m <= z);
-    assert(x != y);
-    if (x < y) {
-      assert(x + k <= y);
-    } else {
-      assert(y + m <= x);
-    }
-    for (int r = 0; r < m; r++) {
-      for (int c = 0; c < k; c++) {
-        assert(y + r < z);
-        assert(x + c < z);
-        matrix[r * k + c] = g_divide(log, exp, w, 1, (y + r) ^ (x + c));
-      }
-    }
-    // Divide rows by row 0:
-    for (int r = 1; r < m; r++) {
-      for (int c = 0; c < k; c++) {
-        matrix[r * k + c] = g_divide(log, exp, w, matrix[r * k + c], matrix[c]);
-      }
-    }
-    // Divide row 0 by itself to set row 0 to 1:
-    for (int c = 0; c < k; c++) {
-      matrix[c] = g_divide(log, exp, w, matrix[c], matrix[c]);
-      assert(matrix[c] == 1);
-    }
-    // Divide columns by the column which minimizes the resulting ones (if any):
-    for (int r = 1; r < m; r++) {
-      const int rk = r * k;
-      int result = 0;
-      int column = -1;
-      for (int c = 0; c < k; c++) result += bit[matrix[rk + c]];
-      for (int c = 0; c < k; c++) {
-        int bits = 0;
-        for (int d = 0; d < k; d++) {
-          bits += bit[g_divide(log, exp, w, matrix[rk + d], matrix[rk + c])];
-        }
-        if (bits < result) {
-          result = bits;
-          column = matrix[rk + c];
-        }
-      }
-      if (column >= 0) {
-        for (int c = 0; c < k; c++) {
-          matrix[rk + c] = g_divide(log, exp, w, matrix[rk + c], column);
-        }
-      }
-      count += result;
-    }
+  // A Buffer, TypedArray, DataView, ArrayBuffer or SharedArrayBuffer of any
+  // length (stripes over mapped segments may exceed 4 GB). The caller must
+  // reference value (and not a view of it) for as long as it uses buffer:
+  assert(value != NULL);
+  assert(*buffer == NULL);
+  assert(*buffer_length == 0);
+  bool is_type = 0;
+  size_t length = 0;
+  napi_value view = NULL;
+  OK(napi_is_buffer(env, value, &is_type));
+  if (is_type) {
+    OK(napi_get_buffer_info(env, value, (void**) buffer, &length));
+    goto done;
   }
-  for (int c = 0; c < k; c++) assert(matrix[c] == 1);
-  assert(count > 0);
-  return count;
-}
-
-static int create_tables_bits(
-  const int* log,
-  const int* exp,
-  const int w,
-  int n
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  int count = 0;
-  for (int r = 0; r < w; r++) {
-    for (int c = 0; c < w; c++) {
-      count += (n & (1 << c)) ? 1 : 0;
-    }
-    n = g_multiply(log, exp, w, n, 2);
+  OK(napi_is_typedarray(env, value, &is_type));
+  if (!is_type && arg_shared(env, value, &view)) {
+    value = view;
+    is_type = 1;
   }
-  return count;
-}
-
-static void create_tables(
-  const int w,
-  const int p,
-  int* log,
-  int* exp,
-  int* bit,
-  int* min
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  const int y = (1 << w) - 1;
-  const int z = (1 << w);
-  // Generate log and exp tables:
-  for (int a = 0; a < z; a++) {
-    log[a] = y;
-    exp[a] = 0;
-  }
-  int b = 1;
-  for (int a = 0; a < y; a++) {
-    assert(b < z);
-    assert(log[b] == y);
-    assert(exp[a] == 0);
-    log[b] = a;
-    exp[a] = b;
-    b = b << 1;
-    if (b & z) b = (b ^ p) & y;
-  }
-  // The logarithm of zero must not be defined:
-  assert(log[0] == y);
-  // The last byte of the exponents table must not be defined:
-  assert(exp[y] == 0);
-  // Generate bit table (number of bits per matrix number):
-  for (int n = 0; n < z; n++) {
-    bit[n] = create_tables_bits(log, exp, w, n);
-    if (n == 0) {
-      assert(bit[n] == 0);
-    } else {
-      assert(bit[n] > 0);
+  if (is_type) {
+    // The data of a TypedArray is already offset by its byteOffset:
+    napi_typedarray_type type;
+    size_t elements = 0;
+    OK(napi_get_typedarray_info(env, value, &type, &elements,
+      (void**) buffer, NULL, NULL));
+    size_t size = 1;
+    if (type == napi_int16_array || type == napi_uint16_array) {
+      size = 2;
+    } else if (
+      type == napi_int32_array ||
+      type == napi_uint32_array ||
+      type == napi_float32_array
+    ) {
+      size = 4;
+    } else if (
+      type == napi_float64_array ||
+      type == napi_bigint64_array ||
+      type == napi_biguint64_array
+    ) {
+      size = 8;
     }
+    length = elements * size;
+    goto done;
   }
-  // Generate min table (matrix numbers sorted by least number of bits):
-  assert(bit[0] == 0);
-  min[0] = 0;
-  for (int a = 1; a < z; a++) {
-    assert(a > 0);
-    int c = min[a - 1];
-    int d = -1;
-    for (int b = 1; b < z; b++) {
-      assert(b > 0);
-      assert(bit[b] > 0);
-      if (bit[b] < bit[c]) continue;
-      if (bit[b] == bit[c] && b <= c) continue;
-      if (d == -1 || bit[b] < bit[d]) d = b;
-    }
-    assert(d > 0);
-    assert(d < z);
-    min[a] = d;
+  OK(napi_is_dataview(env, value, &is_type));
+  if (is_type) {
+    OK(napi_get_dataview_info(env, value, &length, (void**) buffer, NULL,
+      NULL));
+    goto done;
   }
-  assert(min[y] > 0);
-}
-
-static uintptr_t unaligned64(const uint8_t* pointer) {
-  return ((uintptr_t) pointer) & ((uintptr_t) 7);
-}
-
-static uint32_t dot_chunk_size(
-  const int w,
-  const int k,
-  const uint32_t shardSize
-) {
-  // Every dot loop pair (b * k, c * w) uses ((1 + k * w) * chunkSize) of cache.
-  // Avoiding cache misses yields a 40-100% improvement when shardSize is large.
-  // We therefore reduce the chunkSize if necessary to stay within the cache.
-  // The shardSize should ideally be a power of 2 to do this optimally.
-  // N.B. The chunkSize changes the encoded parity result.
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(k < (1 << w));
-  assert(shardSize % w == 0);
-  uint32_t chunkSize = shardSize / w;
-  while (
-    chunkSize > 64 &&
-    chunkSize % 2 == 0 &&
-    (1 + k * w) * chunkSize > 1048576
-  ) {
-    chunkSize /= 2;
+  OK(napi_is_arraybuffer(env, value, &is_type));
+  if (is_type) {
+    OK(napi_get_arraybuffer_info(env, value, (void**) buffer, &length));
+    goto done;
   }
-  assert(chunkSize > 0);
-  assert(shardSize % (w * chunkSize) == 0);
-  return chunkSize;
-}
-
-static void dot_cpy(uint8_t* source, uint8_t* target, uint32_t length) {
-  assert(length > 0);
-  assert(source != target);
-  memcpy(target, source, length);
-}
-
-static void dot_xor(uint8_t* source, uint8_t* target, uint32_t length) {
-  assert(source != target);
-  assert(length > 0);
-  uint8_t* sourceEnd = source + length;
-  uint8_t* targetEnd = target + length;
-  // XOR 8-bit words if source and target alignment cannot be corrected:
-  if (unaligned64(source) != unaligned64(target)) {
-    while (length > 0) {
-      *target++ ^= *source++;
-      length--;
-    }
-    assert(source == sourceEnd);
-    assert(target == targetEnd);
+  return 0;
+done:
+  if (*buffer == NULL) {
+    // Empty (or detached) buffers may have no backing store:
+    static uint8_t empty[1];
     assert(length == 0);
-    return;
-  }
-  // XOR 8-bit words to correct source and target alignment:
-  while (unaligned64(source) && length > 0) {
-    *target++ ^= *source++;
-    length--;
-  }
-  if (length == 0) {
-    assert(source == sourceEnd);
-    assert(target == targetEnd);
-    return;
-  }
-  assert(unaligned64(source) == 0);
-  assert(unaligned64(target) == 0);
-  // XOR as many 64-bit words as possible:
-  uint32_t words = length / 8;
-  if (words > 0) {
-    uint32_t width = words * 8;
-    assert(width <= length);
-    uint64_t* source64 = (uint64_t*) source;
-    uint64_t* target64 = (uint64_t*) target;
-    while (words > 0) {
-      *target64++ ^= *source64++;
-      words--;
-    }
-    assert(words == 0);
-    source += width;
-    target += width;
-    length -= width;
-  }
-  // XOR 8-bit words remainder:
-  assert(length < 8);
-  while (length > 0) {
-    *target++ ^= *source++;
-    length--;
-  }
-  assert(source == sourceEnd);
-  assert(target == targetEnd);
-  assert(length == 0);
-}
-
-static void dot(
-  const int w,
-  const int k,
-  uint8_t** shards,
-  const uint32_t shardSize,
-  const uint8_t* row,
-  const int* sourceIndex,
-  const int targetIndex
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(k < (1 << w));
-  assert(shardSize % w == 0);
-  uint32_t chunkSize = dot_chunk_size(w, k, shardSize);
-  assert(w * chunkSize <= shardSize);
-  assert(shardSize % (w * chunkSize) == 0);
-  uint32_t shardOffset = 0;
-  while (shardOffset < shardSize) {
-    int column = 0;
-    for (int a = 0; a < w; a++) {
-      int copied = 0;
-      uint8_t* target = shards[targetIndex] + shardOffset + a * chunkSize;
-      for (int b = 0; b < k; b++) {
-        uint8_t* source = shards[sourceIndex[b]];
-        for (int c = 0; c < w; c++) {
-          if (row[column]) {
-            if (!copied) {
-              dot_cpy(source + shardOffset + c * chunkSize, target, chunkSize);
-              copied = 1;
-            } else {
-              dot_xor(source + shardOffset + c * chunkSize, target, chunkSize);
-            }
-          }
-          column++;
-        }
-      }
-    }
-    shardOffset += w * chunkSize;
-  }
-  assert(shardOffset == shardSize);
-}
-
-static int flags_count(uint32_t flags) {
-  int count = 0;
-  while (flags > 0) {
-    if (flags & 1) count++; // Check lower bit.
-    flags >>= 1; // Shift lower bit.
-  }
-  return count;
-}
-
-static int flags_first(const uint32_t flags) {
-  int i = 0;
-  while ((flags & (1 << i)) == 0) i++;
-  assert((flags & (1 << i)) != 0);
-  return i;
-}
-
-static void reed_solomon_encode(
-  const int w,
-  const int k,
-  const int m,
-  const uint8_t* bitmatrixEncoding,
-  const uint32_t sources,
-  const uint32_t targets,
-  uint8_t** shards,
-  const uint32_t shardSize
-) {
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  assert(m >= 1);
-  assert(m <= MAX_M);
-  assert(k + m <= (1 << w));
-  if (k == 1) {
-    // Optimization for pure replication, encoding only targets:
-    uint8_t* source = shards[flags_first(sources)];
-    for (int i = 0; i < k + m; i++) {
-      if (targets & (1 << i)) dot_cpy(source, shards[i], shardSize);
-    }
-    return;
-  }
-  if (
-    flags_count(targets) == 1 &&
-    flags_count(sources & ((1 << (k + 1)) - 1)) == k &&
-    flags_count(targets & ((1 << (k + 1)) - 1)) == 1
-  ) {
-    // Optimization for 1 erasure (i < k + 1), encoding only targets:
-    uint8_t* target = shards[flags_first(targets)];
-    int copied = 0;
-    for (int i = 0; i < k + 1; i++) {
-      if (sources & (1 << i)) {
-        if (!copied) {
-          dot_cpy(shards[i], target, shardSize);
-          copied = 1;
-        } else {
-          dot_xor(shards[i], target, shardSize);
-        }
-      }
-    }
-    return;
-  }
-  const int kww = k * w * w;
-  int max = k;
-  int kerasures = 0;
-  for (int i = 0; i < k; i++) {
-    if (!(sources & (1 << i))) {
-      max = i;
-      kerasures++;
-    }
-  }
-  if (!(sources & (1 << k))) max = k;
-  if (kerasures > 1 || (kerasures == 1 && !(sources & (1 << k)))) {
-    int s[MAX_K];
-    int si = 0;
-    int sj = 0;
-    while (sj < k) {
-      if (sources & (1 << si)) s[sj++] = si;
-      si++;
-    }
-    uint8_t bitmatrixDecoding[MAX_K * MAX_K * MAX_W * MAX_W];
-    create_bitmatrix_decoding(
-      w,
-      k,
-      m,
-      s,
-      bitmatrixEncoding,
-      bitmatrixDecoding
-    );
-    for (int i = 0; kerasures > 0 && i < max; i++) {
-      if (!(sources & (1 << i))) {
-        dot(w, k, shards, shardSize, bitmatrixDecoding + kww * i, s, i);
-        kerasures--;
-      }
-    }
-  }
-  if (kerasures > 0) {
-    int s[MAX_K];
-    for (int si = 0; si < k; si++) s[si] = (si < max) ? si : si + 1;
-    dot(w, k, shards, shardSize, bitmatrixEncoding, s, max);
-  }
-  for (int i = 0; i < m; i++) {
-    if (!(sources & (1 << (k + i)))) {
-      int s[MAX_K];
-      for (int si = 0; si < k; si++) s[si] = si;
-      dot(w, k, shards, shardSize, bitmatrixEncoding + kww * i, s, k + i);
-    }
+    *buffer = empty;
   }
+  assert(*buffer != NULL);
+  *buffer_length = length;
+  return 1;
 }
 
 static int arg_buf(
@@ -837,17 +148,12 @@ static int arg_buf(
   uint8_t** buffer,
   uint32_t* buffer_length
 ) {
-  assert(value != NULL);
-  assert(*buffer == NULL);
-  assert(*buffer_length == 0);
-  bool is_buffer = 0;
-  OK(napi_is_buffer(env, value, &is_buffer));
-  if (!is_buffer) return 0;
-  size_t length = 0;
-  OK(napi_get_buffer_info(env, value, (void**) buffer, &length));
-  assert(*buffer != NULL);
-  assert(length <= UINT32_MAX);
-  *buffer_length = length;
+  // As for arg_bytes(), for a Buffer of at most 4 GB (such as a context):
+  uint64_t length = 0;
+  if (!arg_bytes(env, value, buffer, &length) || length > UINT32_MAX) {
+    return 0;
+  }
+  *buffer_length = (uint32_t) length;
   return 1;
 }
 
@@ -872,6 +178,55 @@ static int arg_int(napi_env env, napi_value value, uint32_t* integer) {
   return 1;
 }
 
+static int arg_offset(napi_env env, napi_value value, uint64_t* integer) {
+  assert(*integer == 0);
+  double temp = 0;
+  if (
+    // As for arg_int(), but allowing any safe integer (files and mapped
+    // stripes exceed 4 GB):
+    napi_get_value_double(env, value, &temp) != napi_ok ||
+    temp < 0 ||
+    isnan(temp) ||
+    temp > 9007199254740991.0 ||
+    (double) ((uint64_t) temp) != temp
+  ) {
+    return 0;
+  }
+  *integer = (uint64_t) temp;
+  return 1;
+}
+
+static int arg_fds(napi_env env, napi_value value, int* fds, const int length) {
+  // An array of file descriptors, where -1 marks a file which is not needed:
+  bool is_array = 0;
+  if (napi_is_array(env, value, &is_array) != napi_ok || !is_array) return 0;
+  uint32_t array_length = 0;
+  OK(napi_get_array_length(env, value, &array_length));
+  if (array_length != (uint32_t) length) return 0;
+  for (int index = 0; index < length; index++) {
+    napi_value element;
+    OK(napi_get_element(env, value, index, &element));
+    int32_t fd = 0;
+    if (napi_get_value_int32(env, element, &fd) != napi_ok) return 0;
+    double temp = 0;
+    OK(napi_get_value_double(env, element, &temp));
+    if ((double) fd != temp || fd < -1) return 0;
+    fds[index] = fd;
+  }
+  return 1;
+}
+
+static int arg_path(napi_env env, napi_value value, char* path, size_t size) {
+  // A string of fewer than size bytes (as UTF-8) without any null bytes:
+  size_t length = 0;
+  if (napi_get_value_string_utf8(env, value, NULL, 0, &length) != napi_ok) {
+    return 0;
+  }
+  if (length == 0 || length >= size) return 0;
+  OK(napi_get_value_string_utf8(env, value, path, size, &length));
+  return strlen(path) == length;
+}
+
 void set_int(
   napi_env env,
   napi_value object,
@@ -895,253 +250,3143 @@ void set_method(
   OK(napi_set_named_property(env, object, name, value));
 }
 
+// Completed tasks are pushed onto a lock-free stack when completions are
+// batched, so that the JavaScript thread is woken once for many tasks:
+#if defined(_MSC_VER)
+  #define ATOMIC_CAS(pointer, expect, value)                                   \
+    (InterlockedCompareExchangePointer(                                        \
+      (PVOID volatile*) (pointer),                                             \
+      (value),                                                                 \
+      (expect)                                                                 \
+    ) == (expect))
+  #define ATOMIC_EXCHANGE(pointer, value)                                      \
+    InterlockedExchangePointer((PVOID volatile*) (pointer), (value))
+  #define ATOMIC_LOAD(pointer) (*(void* volatile*) (pointer))
+  #define ATOMIC_CAS_INT(pointer, expect, value)                               \
+    (InterlockedCompareExchange(                                               \
+      (LONG volatile*) (pointer),                                              \
+      (value),                                                                 \
+      (expect)                                                                 \
+    ) == (expect))
+#else
+  #define ATOMIC_CAS(pointer, expect, value)                                   \
+    __sync_bool_compare_and_swap((pointer), (expect), (value))
+  #define ATOMIC_EXCHANGE(pointer, value)                                      \
+    __atomic_exchange_n((pointer), (value), __ATOMIC_ACQ_REL)
+  #define ATOMIC_LOAD(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+  #define ATOMIC_CAS_INT(pointer, expect, value)                               \
+    __sync_bool_compare_and_swap((pointer), (expect), (value))
+#endif
+
+// The number of recently used contexts and callbacks whose references are kept
+// for reuse (when enabled), instead of creating and deleting a reference for
+// every task:
+#define REF_CACHE_SIZE 4
+
+struct ref_cache {
+  napi_ref refs[REF_CACHE_SIZE];
+  uint32_t uses[REF_CACHE_SIZE];
+};
+
+struct task_data;
+
+// Tasks are scheduled in two priority classes, foreground and background:
+#define PRIORITY_FOREGROUND 0
+#define PRIORITY_BACKGROUND 1
+
+// A task may be cancelled only while it is queued (and not yet encoding):
+#define TASK_QUEUED 0
+#define TASK_RUNNING 1
+#define TASK_CANCELLED 2
+
+struct instance {
+  napi_threadsafe_function tsfn;
+  uint64_t pending; // Tasks delivered through tsfn and not yet completed.
+  int batch;
+  int reuse;
+  struct task_data* completed; // A lock-free stack of completed tasks.
+  struct ref_cache contexts;
+  struct ref_cache callbacks;
+  // The remaining fields are accessed only by the JavaScript thread:
+  uint32_t id; // The id of the last task submitted.
+  struct task_data** ids; // Unfinished tasks by id (a table of chains).
+  uint32_t idsSize; // A power of 2.
+  uint32_t idsCount;
+  struct task_data* held[2]; // Tasks held back by the scheduler, per class.
+  struct task_data* heldTail[2];
+  uint32_t running[2]; // Tasks dispatched and not yet finished, per class.
+  uint32_t concurrency; // The limit of tasks running (or 0 if unlimited).
+  uint32_t background; // The limit of background tasks running (or 0).
+};
+
 struct task_data {
   uint8_t* context;
   uint32_t contextSize;
   uint32_t sources;
   uint32_t targets;
   uint8_t* buffer;
-  uint32_t bufferSize;
+  uint64_t bufferSize;
   uint8_t* parity;
-  uint32_t paritySize;
+  uint64_t paritySize;
   uint32_t shardSize;
+  uint32_t remaining;
   napi_ref ref_context;
   napi_ref ref_buffer;
   napi_ref ref_parity;
   napi_ref ref_callback;
   napi_async_work async_work;
+  napi_threadsafe_function tsfn;
+  struct instance* instance;
+  struct task_data* next;
+  uv_work_t work;
+  uint8_t pooled;
+  uint8_t batch;
+  uint8_t cached_context;
+  uint8_t cached_callback;
+  uint8_t priority;
+  uint8_t held;
+  int32_t state;
+  uint32_t id;
+  struct task_data* id_next;
+  struct task_data* held_next;
+  struct encoder* encoder; // The encoder which owns the task, if any.
+  uint32_t slot;
+  uint32_t unit; // The stripe unit of an interleaved layout, else 0.
+  uint32_t rotation;
+  uint64_t stride;
+  uint8_t* scratch; // Regions gathered from units smaller than a region.
 };
 
-void task_execute(napi_env env, void* data) {
-  struct task_data* task = data;
-  assert(task->context != NULL);
-  assert(task->contextSize > 3);
-  assert(task->buffer != NULL);
-  assert(task->parity != NULL);
-  assert(task->shardSize > 0);
-  const int w = task->context[0];
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  const int k = task->context[1];
-  assert(k >= 1);
-  assert(k <= MAX_K);
-  const int m = task->context[2];
+// An encoder binds a context to a fixed number of preallocated task slots,
+// each with its own async work, which are reused by every run() instead of
+// being allocated (and their references created) for every stripe. The buffer,
+// parity and end callback of each slot are held in a single array:
+#define ENCODER_MAX_SLOTS 65536
+
+struct encoder {
+  uint8_t* context;
+  uint32_t contextSize;
+  napi_ref ref_context;
+  napi_ref ref_values; // [buffer, parity, end] for each slot.
+  napi_ref ref_self; // Strong only while slots are busy.
+  uint32_t slots;
+  uint32_t busy;
+  struct task_data* free; // Slots which are not busy, linked through next.
+  struct task_data* tasks;
+};
+
+static napi_value encoder_release(
+  napi_env env,
+  struct encoder* encoder,
+  struct task_data* task
+) {
+  // Returns the slot of a finished task and its end callback:
+  napi_value values;
+  OK(napi_get_reference_value(env, encoder->ref_values, &values));
+  napi_value callback;
+  OK(napi_get_element(env, values, task->slot * 3 + 2, &callback));
+  napi_value undefined;
+  OK(napi_get_undefined(env, &undefined));
+  for (uint32_t index = 0; index < 3; index++) {
+    OK(napi_set_element(env, values, task->slot * 3 + index, undefined));
+  }
+  task->next = encoder->free;
+  encoder->free = task;
+  assert(encoder->busy > 0);
+  if (--encoder->busy == 0) {
+    OK(napi_reference_unref(env, encoder->ref_self, NULL));
+  }
+  return callback;
+}
+
+static uint32_t task_shard_size(const struct task_data* task) {
+  // Parity shards are padded to a multiple of 8 bytes:
+  const int m = task->context[2];
+  assert(m >= 1);
+  assert(task->paritySize % m == 0);
+  assert(task->paritySize / m <= UINT32_MAX);
+  const uint32_t paddedSize = (uint32_t) (task->paritySize / m);
+  assert(paddedSize >= task->shardSize);
+  assert(paddedSize % 8 == 0);
+  return paddedSize;
+}
+
+static uint32_t task_range_size(const struct task_data* task) {
+  // Ranges (and regions) are of each substripe of a shard:
+  const int substripes = reed_solomon_substripes(task->context,
+    task->contextSize);
+  assert(task_shard_size(task) % (8 * substripes) == 0);
+  return task_shard_size(task) / substripes;
+}
+
+static void task_encode(
+  struct task_data* task,
+  const uint32_t offset,
+  const uint32_t size
+) {
+  assert(task->context != NULL);
+  assert(task->contextSize > 3);
+  assert(task->buffer != NULL);
+  assert(task->parity != NULL);
+  assert(task->shardSize > 0);
+  const int w = task->context[0];
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  const int k = task->context[1];
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  const int m = task->context[2];
   assert(m >= 1);
   assert(m <= MAX_M);
-  assert(k + m <= (1 << w));
-  assert(task->contextSize == (uint32_t) (3 + k * w * m * w));
-  const uint8_t* bitmatrix = task->context + 3;
+  (void) w;
   uint8_t* shards[MAX_K + MAX_M];
-  assert(task->shardSize * k <= task->bufferSize);
+  uint32_t shardLengths[MAX_K + MAX_M];
+  if (task->unit != 0) {
+    // Data shards are interleaved in units (and are never short):
+    for (int index = 0; index < m; index++) {
+      shards[index] = task->parity + (uint64_t) task->shardSize * index;
+    }
+    reed_solomon_encode_layout(
+      task->context,
+      task->contextSize,
+      task->sources,
+      task->targets,
+      task->buffer,
+      task->stride,
+      task->unit,
+      task->rotation,
+      shards,
+      task->shardSize,
+      offset,
+      size,
+      task->scratch
+    );
+    return;
+  }
+  // Data shards are contiguous and the last data shards may be short or empty:
   for (int index = 0; index < k; index++) {
-    shards[index] = task->buffer + task->shardSize * index;
+    uint64_t shardOffset = (uint64_t) task->shardSize * index;
+    shards[index] = task->buffer + shardOffset;
+    if (shardOffset >= task->bufferSize) {
+      shardLengths[index] = 0;
+    } else if (task->bufferSize - shardOffset < task->shardSize) {
+      shardLengths[index] = (uint32_t) (task->bufferSize - shardOffset);
+    } else {
+      shardLengths[index] = task->shardSize;
+    }
   }
-  assert(task->shardSize * m <= task->paritySize);
+  const uint32_t paddedSize = task_shard_size(task);
   for (int index = 0; index < m; index++) {
-    shards[index + k] = task->parity + task->shardSize * index;
+    shards[index + k] = task->parity + (uint64_t) paddedSize * index;
+    shardLengths[index + k] = paddedSize;
   }
-  reed_solomon_encode(
-    w,
-    k,
-    m,
-    bitmatrix,
+  reed_solomon_encode_range(
+    task->context,
+    task->contextSize,
     task->sources,
     task->targets,
     shards,
-    task->shardSize
+    shardLengths,
+    paddedSize,
+    offset,
+    size
   );
 }
 
-void task_complete(napi_env env, napi_status status, void* data) {
+static int task_start(struct task_data* task) {
+  // Returns 0 if the task was cancelled before it could start encoding:
+  return ATOMIC_CAS_INT(&task->state, TASK_QUEUED, TASK_RUNNING);
+}
+
+void task_execute(napi_env env, void* data) {
   struct task_data* task = data;
-  assert(status == napi_ok);
+  if (task_start(task)) task_encode(task, 0, task_range_size(task));
+}
+
+static int ref_acquire(
+  napi_env env,
+  struct ref_cache* cache,
+  napi_value value,
+  napi_ref* ref
+) {
+  // Returns 1 if the reference is cached, else 0 (the caller must delete it):
+  int empty = -1;
+  int idle = -1;
+  for (int index = 0; index < REF_CACHE_SIZE; index++) {
+    if (cache->refs[index] == NULL) {
+      if (empty < 0) empty = index;
+      continue;
+    }
+    napi_value cached;
+    OK(napi_get_reference_value(env, cache->refs[index], &cached));
+    if (cached == NULL) {
+      // An idle reference is weak and its value has been garbage collected:
+      assert(cache->uses[index] == 0);
+      OK(napi_delete_reference(env, cache->refs[index]));
+      cache->refs[index] = NULL;
+      if (empty < 0) empty = index;
+      continue;
+    }
+    bool equal = false;
+    OK(napi_strict_equals(env, cached, value, &equal));
+    if (equal) {
+      OK(napi_reference_ref(env, cache->refs[index], NULL));
+      cache->uses[index]++;
+      *ref = cache->refs[index];
+      return 1;
+    }
+    if (cache->uses[index] == 0 && idle < 0) idle = index;
+  }
+  const int index = empty >= 0 ? empty : idle;
+  if (index < 0) {
+    OK(napi_create_reference(env, value, 1, ref));
+    return 0;
+  }
+  if (cache->refs[index] != NULL) {
+    OK(napi_delete_reference(env, cache->refs[index]));
+  }
+  OK(napi_create_reference(env, value, 1, &cache->refs[index]));
+  cache->uses[index] = 1;
+  *ref = cache->refs[index];
+  return 1;
+}
+
+static void ref_release(
+  napi_env env,
+  struct ref_cache* cache,
+  napi_ref ref,
+  const int cached
+) {
+  if (!cached) {
+    OK(napi_delete_reference(env, ref));
+    return;
+  }
+  for (int index = 0; index < REF_CACHE_SIZE; index++) {
+    if (cache->refs[index] != ref) continue;
+    assert(cache->uses[index] > 0);
+    cache->uses[index]--;
+    // The reference becomes weak when idle, so that the value may be collected:
+    OK(napi_reference_unref(env, ref, NULL));
+    return;
+  }
+  assert(0);
+}
+
+static int task_insert(struct instance* instance, struct task_data* task) {
+  // Assigns the task an id, returning 0 if there is insufficient memory:
+  if (instance->idsCount >= instance->idsSize) {
+    const uint32_t size = instance->idsSize ? instance->idsSize * 2 : 64;
+    struct task_data** ids = calloc(size, sizeof(struct task_data*));
+    // Chains may grow longer if the table cannot:
+    if (!ids && instance->ids == NULL) return 0;
+    if (ids) {
+      for (uint32_t index = 0; index < instance->idsSize; index++) {
+        struct task_data* chain = instance->ids[index];
+        while (chain != NULL) {
+          struct task_data* next = chain->id_next;
+          chain->id_next = ids[chain->id & (size - 1)];
+          ids[chain->id & (size - 1)] = chain;
+          chain = next;
+        }
+      }
+      free(instance->ids);
+      instance->ids = ids;
+      instance->idsSize = size;
+    }
+  }
+  // Ids wrap around after 2^32 - 1 tasks, skipping 0:
+  if (++instance->id == 0) instance->id = 1;
+  task->id = instance->id;
+  struct task_data** chain = &instance->ids[task->id & (instance->idsSize - 1)];
+  task->id_next = *chain;
+  *chain = task;
+  instance->idsCount++;
+  return 1;
+}
+
+static struct task_data* task_lookup(
+  struct instance* instance,
+  const uint32_t id
+) {
+  if (instance->ids == NULL || id == 0) return NULL;
+  struct task_data* task = instance->ids[id & (instance->idsSize - 1)];
+  while (task != NULL && task->id != id) task = task->id_next;
+  return task;
+}
+
+static void task_remove(struct instance* instance, struct task_data* task) {
+  struct task_data** chain = &instance->ids[task->id & (instance->idsSize - 1)];
+  while (*chain != task) {
+    assert(*chain != NULL);
+    chain = &(*chain)->id_next;
+  }
+  *chain = task->id_next;
+  assert(instance->idsCount > 0);
+  instance->idsCount--;
+}
+
+static void task_drain(napi_env env, struct instance* instance);
+
+static void task_finish(napi_env env, struct task_data* task) {
   napi_value scope;
   OK(napi_get_global(env, &scope));
-  napi_value callback;
-  OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  napi_value callback = NULL;
+  if (task->encoder == NULL) {
+    OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  }
+  struct instance* instance = task->instance;
+  task_remove(instance, task);
+  assert(instance->running[task->priority] > 0);
+  instance->running[task->priority]--;
+  size_t argc = 0;
+  napi_value error = NULL;
+  if (task->state == TASK_CANCELLED) {
+    napi_value message;
+    OK(napi_create_string_utf8(env, "cancelled", NAPI_AUTO_LENGTH, &message));
+    OK(napi_create_error(env, NULL, message, &error));
+    argc = 1;
+  } else {
+    assert(task->state == TASK_RUNNING);
+  }
+  if (task->encoder != NULL) {
+    // Release the slot first, so that the callback may run the encoder again:
+    callback = encoder_release(env, task->encoder, task);
+    napi_call_function(env, scope, callback, argc, &error, NULL);
+    task_drain(env, instance);
+    return;
+  }
   // Do not assert the return status of napi_call_function():
   // If the callback throws then the return status will not be napi_ok.
-  napi_call_function(env, scope, callback, 0, NULL, NULL);
+  napi_call_function(env, scope, callback, argc, &error, NULL);
   assert(task->ref_context != NULL);
   assert(task->ref_buffer != NULL);
   assert(task->ref_parity != NULL);
   assert(task->ref_callback != NULL);
+  ref_release(env, &task->instance->contexts, task->ref_context,
+    task->cached_context);
+  OK(napi_delete_reference(env, task->ref_buffer));
+  OK(napi_delete_reference(env, task->ref_parity));
+  ref_release(env, &task->instance->callbacks, task->ref_callback,
+    task->cached_callback);
+  if (task->async_work != NULL) {
+    OK(napi_delete_async_work(env, task->async_work));
+  }
+  free(task->scratch);
+  free(task);
+  task = NULL;
+  task_drain(env, instance);
+}
+
+void task_complete(napi_env env, napi_status status, void* data) {
+  struct task_data* task = data;
+  assert(status == napi_ok);
   assert(task->async_work != NULL);
+  task_finish(env, task);
+}
+
+// An optional pool of threads dedicated to encoding, so that encoding need not
+// compete with fs, dns and crypto in Node's threadpool (and vice versa).
+//
+// Each thread owns a deque of jobs. A thread pops jobs from the bottom of its
+// own deque and, when its own deque is empty, steals jobs from the top of the
+// deques of other threads. A thread splits a large stripe into ranges of
+// regions, pushing all but one range onto its own deque for others to steal.
+// The last range to finish delivers the task to the JavaScript thread through
+// a threadsafe function.
+
+#define POOL_MAX_THREADS 256
+
+// Split stripes only into ranges of at least this many bytes per shard:
+#define POOL_RANGE_SIZE 65536
+
+struct pool_job {
+  struct task_data* task;
+  uint32_t offset;
+  uint32_t size; // Zero if the task has not yet been split into ranges.
+};
+
+struct pool_deque {
+  uv_mutex_t mutex;
+  struct pool_job* jobs;
+  uint32_t capacity; // A power of 2, so that top and bottom may wrap around.
+  uint32_t top;
+  uint32_t bottom;
+};
+
+static struct {
+  uv_mutex_t mutex; // Protects all fields except deques (each has a mutex).
+  uv_cond_t cond;
+  int threads;
+  int pin;
+  int stop;
+  uv_thread_t* handles;
+  struct pool_deque* deques;
+  uint64_t pending; // Jobs waiting in deques.
+  uint64_t tasks; // Tasks submitted and not yet delivered.
+  uint32_t next; // The deque to receive the next task submitted.
+} pool;
+
+// Serializes configuration of the pool by multiple JavaScript threads:
+static uv_mutex_t pool_config;
+static uv_once_t pool_once = UV_ONCE_INIT;
+
+static void pool_init(void) {
+  OK_UV(uv_mutex_init(&pool_config));
+  OK_UV(uv_mutex_init(&pool.mutex));
+  OK_UV(uv_cond_init(&pool.cond));
+}
+
+static int pool_deque_init(struct pool_deque* deque) {
+  deque->capacity = 64;
+  deque->top = 0;
+  deque->bottom = 0;
+  deque->jobs = malloc(deque->capacity * sizeof(struct pool_job));
+  if (!deque->jobs) return 0;
+  OK_UV(uv_mutex_init(&deque->mutex));
+  return 1;
+}
+
+static void pool_deque_destroy(struct pool_deque* deque) {
+  assert(deque->top == deque->bottom);
+  uv_mutex_destroy(&deque->mutex);
+  free(deque->jobs);
+  deque->jobs = NULL;
+}
+
+static int pool_deque_push(struct pool_deque* deque, struct pool_job* job) {
+  uv_mutex_lock(&deque->mutex);
+  if (deque->bottom - deque->top == deque->capacity) {
+    const uint32_t capacity = deque->capacity * 2;
+    struct pool_job* jobs = malloc(capacity * sizeof(struct pool_job));
+    if (!jobs) {
+      uv_mutex_unlock(&deque->mutex);
+      return 0;
+    }
+    uint32_t count = 0;
+    for (uint32_t index = deque->top; index != deque->bottom; index++) {
+      jobs[count++] = deque->jobs[index & (deque->capacity - 1)];
+    }
+    free(deque->jobs);
+    deque->jobs = jobs;
+    deque->capacity = capacity;
+    deque->top = 0;
+    deque->bottom = count;
+  }
+  deque->jobs[deque->bottom++ & (deque->capacity - 1)] = *job;
+  uv_mutex_unlock(&deque->mutex);
+  return 1;
+}
+
+static int pool_deque_pop(struct pool_deque* deque, struct pool_job* job) {
+  int popped = 0;
+  uv_mutex_lock(&deque->mutex);
+  if (deque->bottom != deque->top) {
+    *job = deque->jobs[--deque->bottom & (deque->capacity - 1)];
+    popped = 1;
+  }
+  uv_mutex_unlock(&deque->mutex);
+  return popped;
+}
+
+static int pool_deque_steal(struct pool_deque* deque, struct pool_job* job) {
+  int stolen = 0;
+  uv_mutex_lock(&deque->mutex);
+  if (deque->bottom != deque->top) {
+    *job = deque->jobs[deque->top++ & (deque->capacity - 1)];
+    stolen = 1;
+  }
+  uv_mutex_unlock(&deque->mutex);
+  return stolen;
+}
+
+static int pool_next(const int id, struct pool_job* job) {
+  while (1) {
+    int found = pool_deque_pop(&pool.deques[id], job);
+    for (int index = 1; !found && index < pool.threads; index++) {
+      found = pool_deque_steal(
+        &pool.deques[(id + index) % pool.threads],
+        job
+      );
+    }
+    uv_mutex_lock(&pool.mutex);
+    if (found) {
+      assert(pool.pending > 0);
+      pool.pending--;
+      uv_mutex_unlock(&pool.mutex);
+      return 1;
+    }
+    while (pool.pending == 0 && !pool.stop) {
+      uv_cond_wait(&pool.cond, &pool.mutex);
+    }
+    const int stop = pool.stop && pool.pending == 0;
+    uv_mutex_unlock(&pool.mutex);
+    if (stop) return 0;
+  }
+}
+
+static void pool_split(const int id, struct pool_job* job) {
+  // Split a large stripe into ranges of regions, keeping the first range:
+  struct task_data* task = job->task;
+  const uint32_t size = task_range_size(task);
+  const uint32_t regionSize = reed_solomon_region_size(
+    task->context[0],
+    task->context[1],
+    size
+  );
+  const uint32_t regions = size / regionSize;
+  uint32_t ranges = size / POOL_RANGE_SIZE;
+  if (ranges > (uint32_t) pool.threads) ranges = pool.threads;
+  // A layout with scratch has a single range (and so a single scratch):
+  if (task->scratch != NULL) ranges = 1;
+  if (ranges > regions) ranges = regions;
+  if (ranges < 1) ranges = 1;
+  const uint32_t rangeRegions = (regions + ranges - 1) / ranges;
+  const uint32_t rangeSize = rangeRegions * regionSize;
+  ranges = (regions + rangeRegions - 1) / rangeRegions;
+  job->offset = 0;
+  job->size = rangeSize < size ? rangeSize : size;
+  // Ranges are counted as pending as they are pushed, under the pool mutex
+  // (as for pool_submit()), so that a thief never takes a range before it is
+  // counted:
+  uint32_t unpushed[POOL_MAX_THREADS];
+  uint32_t unpushedCount = 0;
+  uv_mutex_lock(&pool.mutex);
+  task->remaining = ranges;
+  uint32_t pushed = 0;
+  for (uint32_t range = 1; range < ranges; range++) {
+    struct pool_job sub;
+    sub.task = task;
+    sub.offset = range * rangeSize;
+    sub.size = size - sub.offset < rangeSize ? size - sub.offset : rangeSize;
+    if (!pool_deque_push(&pool.deques[id], &sub)) {
+      unpushed[unpushedCount++] = range;
+      continue;
+    }
+    pool.pending++;
+    pushed++;
+  }
+  if (pushed == 1) {
+    uv_cond_signal(&pool.cond);
+  } else if (pushed > 1) {
+    uv_cond_broadcast(&pool.cond);
+  }
+  uv_mutex_unlock(&pool.mutex);
+  if (unpushedCount == 0) return;
+  // Encode the ranges ourselves which the deque could not grow to hold:
+  for (uint32_t index = 0; index < unpushedCount; index++) {
+    const uint32_t offset = unpushed[index] * rangeSize;
+    task_encode(task, offset, size - offset < rangeSize ?
+      size - offset : rangeSize);
+  }
+  uv_mutex_lock(&pool.mutex);
+  // Our own range is still to be counted down by pool_run():
+  assert(task->remaining > unpushedCount);
+  task->remaining -= unpushedCount;
+  uv_mutex_unlock(&pool.mutex);
+}
+
+static void task_deliver(struct task_data* task) {
+  // Called by any thread once a task has been encoded:
+  if (!task->batch) {
+    OK(napi_call_threadsafe_function(task->tsfn, task, napi_tsfn_nonblocking));
+    return;
+  }
+  struct instance* instance = task->instance;
+  struct task_data* head;
+  do {
+    head = ATOMIC_LOAD(&instance->completed);
+    task->next = head;
+  } while (!ATOMIC_CAS(&instance->completed, head, task));
+  // Wake the JavaScript thread only if it has not already been woken:
+  if (head == NULL) {
+    OK(napi_call_threadsafe_function(task->tsfn, NULL, napi_tsfn_nonblocking));
+  }
+}
+
+static void pool_run(const int id, struct pool_job* job) {
+  struct task_data* task = job->task;
+  // A cancelled task is delivered without being split or encoded:
+  if (job->size == 0 && task_start(task)) pool_split(id, job);
+  if (job->size > 0) task_encode(task, job->offset, job->size);
+  uv_mutex_lock(&pool.mutex);
+  assert(task->remaining > 0);
+  const int last = --task->remaining == 0;
+  uv_mutex_unlock(&pool.mutex);
+  if (last) task_deliver(task);
+}
+
+static void pool_pin(const int id) {
+  #if UV_VERSION_HEX >= 0x012D00
+    const int size = uv_cpumask_size();
+    const unsigned int cpus = uv_available_parallelism();
+    if (size <= 0 || cpus == 0) return;
+    char* mask = calloc(size, 1);
+    if (!mask) return;
+    mask[(unsigned int) id % cpus % (unsigned int) size] = 1;
+    uv_thread_t self = uv_thread_self();
+    // Pinning is best effort:
+    uv_thread_setaffinity(&self, mask, NULL, size);
+    free(mask);
+  #endif
+}
+
+static void pool_worker(void* arg) {
+  const int id = (int) (intptr_t) arg;
+  if (pool.pin) pool_pin(id);
+  struct pool_job job;
+  while (pool_next(id, &job)) pool_run(id, &job);
+}
+
+static void pool_stop(void) {
+  // The caller must hold pool_config and there must be no tasks in the pool:
+  if (pool.threads == 0) return;
+  uv_mutex_lock(&pool.mutex);
+  assert(pool.tasks == 0);
+  pool.stop = 1;
+  uv_cond_broadcast(&pool.cond);
+  uv_mutex_unlock(&pool.mutex);
+  for (int id = 0; id < pool.threads; id++) {
+    OK_UV(uv_thread_join(&pool.handles[id]));
+  }
+  for (int id = 0; id < pool.threads; id++) {
+    pool_deque_destroy(&pool.deques[id]);
+  }
+  free(pool.handles);
+  free(pool.deques);
+  uv_mutex_lock(&pool.mutex);
+  pool.handles = NULL;
+  pool.deques = NULL;
+  pool.threads = 0;
+  pool.stop = 0;
+  uv_mutex_unlock(&pool.mutex);
+}
+
+static int pool_start(const int threads, const int pin) {
+  // The caller must hold pool_config and the pool must be stopped:
+  assert(pool.threads == 0);
+  pool.handles = calloc(threads, sizeof(uv_thread_t));
+  pool.deques = calloc(threads, sizeof(struct pool_deque));
+  if (!pool.handles || !pool.deques) {
+    free(pool.handles);
+    free(pool.deques);
+    pool.handles = NULL;
+    pool.deques = NULL;
+    return 0;
+  }
+  for (int id = 0; id < threads; id++) {
+    if (!pool_deque_init(&pool.deques[id])) {
+      while (id--) pool_deque_destroy(&pool.deques[id]);
+      free(pool.handles);
+      free(pool.deques);
+      pool.handles = NULL;
+      pool.deques = NULL;
+      return 0;
+    }
+  }
+  pool.pin = pin;
+  pool.next = 0;
+  // Threads read pool.threads, which is set before any thread starts:
+  pool.threads = threads;
+  for (int id = 0; id < threads; id++) {
+    OK_UV(uv_thread_create(
+      &pool.handles[id],
+      pool_worker,
+      (void*) (intptr_t) id
+    ));
+  }
+  return 1;
+}
+
+static void instance_settle(
+  napi_env env,
+  struct instance* instance,
+  const uint64_t tasks
+) {
+  assert(instance->pending >= tasks);
+  instance->pending -= tasks;
+  // Let the event loop exit once no more tasks are pending:
+  if (instance->pending == 0 && env != NULL) {
+    OK(napi_unref_threadsafe_function(env, instance->tsfn));
+  }
+}
+
+static void report_exception(napi_env env) {
+  // Raises an exception thrown by a callback as an uncaught exception (rather
+  // than leaving it pending for Node to warn about and discard):
+  bool exception = false;
+  OK(napi_is_exception_pending(env, &exception));
+  if (exception) {
+    napi_value error;
+    OK(napi_get_and_clear_last_exception(env, &error));
+    napi_fatal_exception(env, error);
+  }
+}
+
+static void pool_complete(
+  napi_env env,
+  napi_value js_callback,
+  void* context,
+  void* data
+) {
+  // Runs on the JavaScript thread, for a single task, or for a batch of tasks
+  // if data is NULL:
+  struct instance* instance = context;
+  struct task_data* task = data;
+  if (task != NULL) {
+    assert(task->pooled);
+    uv_mutex_lock(&pool.mutex);
+    assert(pool.tasks > 0);
+    pool.tasks--;
+    uv_mutex_unlock(&pool.mutex);
+    instance_settle(env, instance, 1);
+    // The environment is shutting down if env is NULL:
+    if (env == NULL) return;
+    napi_handle_scope scope;
+    OK(napi_open_handle_scope(env, &scope));
+    task_finish(env, task);
+    report_exception(env);
+    OK(napi_close_handle_scope(env, scope));
+    return;
+  }
+  // Take the whole stack and reverse it to complete tasks in order:
+  struct task_data* head = ATOMIC_EXCHANGE(&instance->completed, NULL);
+  uint64_t tasks = 0;
+  uint64_t pooled = 0;
+  while (head != NULL) {
+    struct task_data* next = head->next;
+    head->next = task;
+    task = head;
+    head = next;
+    tasks++;
+    if (task->pooled) pooled++;
+  }
+  if (pooled > 0) {
+    uv_mutex_lock(&pool.mutex);
+    assert(pool.tasks >= pooled);
+    pool.tasks -= pooled;
+    uv_mutex_unlock(&pool.mutex);
+  }
+  instance_settle(env, instance, tasks);
+  if (env == NULL) return;
+  while (task != NULL) {
+    struct task_data* next = task->next;
+    napi_handle_scope scope;
+    OK(napi_open_handle_scope(env, &scope));
+    task_finish(env, task);
+    // Report an exception thrown by a callback without losing the rest:
+    report_exception(env);
+    OK(napi_close_handle_scope(env, scope));
+    task = next;
+  }
+}
+
+static void instance_pending(napi_env env, struct instance* instance) {
+  if (instance->tsfn == NULL) {
+    napi_value name;
+    OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+    OK(napi_create_threadsafe_function(
+      env,
+      NULL,
+      NULL,
+      name,
+      0,
+      1,
+      NULL,
+      NULL,
+      instance,
+      pool_complete,
+      &instance->tsfn
+    ));
+    OK(napi_unref_threadsafe_function(env, instance->tsfn));
+  }
+  // Keep the event loop alive while tasks are pending:
+  if (instance->pending++ == 0) {
+    OK(napi_ref_threadsafe_function(env, instance->tsfn));
+  }
+}
+
+static int pool_submit(napi_env env, struct task_data* task) {
+  // Returns 0 if the pool is disabled (the caller uses Node's threadpool):
+  uv_mutex_lock(&pool.mutex);
+  if (pool.threads == 0) {
+    uv_mutex_unlock(&pool.mutex);
+    return 0;
+  }
+  instance_pending(env, task->instance);
+  task->tsfn = task->instance->tsfn;
+  task->pooled = 1;
+  task->remaining = 1;
+  struct pool_job job;
+  job.task = task;
+  job.offset = 0;
+  job.size = 0;
+  const int id = pool.next++ % pool.threads;
+  // The deque grows if it can, else the thread submitting encodes the task:
+  pool.tasks++;
+  const int pushed = pool_deque_push(&pool.deques[id], &job);
+  if (pushed) {
+    pool.pending++;
+    uv_cond_signal(&pool.cond);
+  }
+  uv_mutex_unlock(&pool.mutex);
+  if (!pushed) {
+    if (task_start(task)) task_encode(task, 0, task_range_size(task));
+    task_deliver(task);
+  }
+  return 1;
+}
+
+static void batch_work(uv_work_t* work) {
+  task_execute(NULL, work->data);
+}
+
+static void batch_after_work(uv_work_t* work, int status) {
+  assert(status == 0);
+  task_deliver(work->data);
+}
+
+static void batch_submit(napi_env env, struct task_data* task) {
+  // Encode in Node's threadpool and complete through the batch:
+  uv_loop_t* loop = NULL;
+  OK(napi_get_uv_event_loop(env, &loop));
+  instance_pending(env, task->instance);
+  task->tsfn = task->instance->tsfn;
+  task->work.data = task;
+  OK_UV(uv_queue_work(loop, &task->work, batch_work, batch_after_work));
+}
+
+static napi_value completions(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t batch = 0;
+  uint32_t reuse = 0;
+  if (
+    argc != 2 ||
+    !arg_int(env, argv[0], &batch) ||
+    !arg_int(env, argv[1], &reuse)
+  ) {
+    THROW(env, "bad arguments, expected: (int batch, int reuse)");
+  }
+  if (batch > 1) THROW(env, "batch != 0, 1");
+  if (reuse > 1) THROW(env, "reuse != 0, 1");
+  struct instance* instance = NULL;
+  OK(napi_get_instance_data(env, (void**) &instance));
+  assert(instance != NULL);
+  // Tasks already submitted keep the mode they were submitted with:
+  instance->batch = (int) batch;
+  instance->reuse = (int) reuse;
+  return NULL;
+}
+
+static void task_dispatch(napi_env env, struct task_data* task) {
+  if (pool_submit(env, task)) return;
+  if (task->batch) {
+    batch_submit(env, task);
+    return;
+  }
+  // The async work of an encoder's slot is created once and then requeued:
+  if (task->async_work == NULL) {
+    napi_value name;
+    OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+    OK(napi_create_async_work(
+      env,
+      NULL,
+      name,
+      task_execute,
+      task_complete,
+      task,
+      &task->async_work
+    ));
+  }
+  OK(napi_queue_async_work(env, task->async_work));
+}
+
+static void task_hold(struct instance* instance, struct task_data* task) {
+  const int priority = task->priority;
+  task->held = 1;
+  task->held_next = NULL;
+  if (instance->held[priority] == NULL) {
+    instance->held[priority] = task;
+  } else {
+    instance->heldTail[priority]->held_next = task;
+  }
+  instance->heldTail[priority] = task;
+}
+
+static void task_unhold(struct instance* instance, struct task_data* task) {
+  const int priority = task->priority;
+  struct task_data* previous = NULL;
+  struct task_data** link = &instance->held[priority];
+  while (*link != task) {
+    assert(*link != NULL);
+    previous = *link;
+    link = &previous->held_next;
+  }
+  *link = task->held_next;
+  if (instance->heldTail[priority] == task) {
+    instance->heldTail[priority] = previous;
+  }
+  task->held = 0;
+  task->held_next = NULL;
+}
+
+static void task_drain(napi_env env, struct instance* instance) {
+  // Dispatch held tasks, foreground before background, within the limits:
+  while (1) {
+    const uint32_t running = instance->running[0] + instance->running[1];
+    if (instance->concurrency > 0 && running >= instance->concurrency) return;
+    int priority = PRIORITY_FOREGROUND;
+    if (instance->held[priority] == NULL) {
+      priority = PRIORITY_BACKGROUND;
+      if (instance->held[priority] == NULL) return;
+      if (
+        instance->background > 0 &&
+        instance->running[priority] >= instance->background
+      ) {
+        return;
+      }
+    }
+    struct task_data* task = instance->held[priority];
+    task_unhold(instance, task);
+    instance->running[priority]++;
+    task_dispatch(env, task);
+  }
+}
+
+static napi_value schedule(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t concurrency = 0;
+  uint32_t background = 0;
+  if (
+    argc != 2 ||
+    !arg_int(env, argv[0], &concurrency) ||
+    !arg_int(env, argv[1], &background)
+  ) {
+    THROW(env, "bad arguments, expected: (int concurrency, int background)");
+  }
+  struct instance* instance = NULL;
+  OK(napi_get_instance_data(env, (void**) &instance));
+  assert(instance != NULL);
+  instance->concurrency = concurrency;
+  instance->background = background;
+  // Raising a limit may release held tasks:
+  task_drain(env, instance);
+  return NULL;
+}
+
+static napi_value cancel(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t id = 0;
+  if (argc != 1 || !arg_int(env, argv[0], &id)) {
+    THROW(env, "bad arguments, expected: (int id)");
+  }
+  struct instance* instance = NULL;
+  OK(napi_get_instance_data(env, (void**) &instance));
+  assert(instance != NULL);
+  struct task_data* task = task_lookup(instance, id);
+  int cancelled = 0;
+  if (task != NULL && task->held) {
+    // Dispatch a held task at once, to call back asynchronously (as usual)
+    // without encoding:
+    task_unhold(instance, task);
+    task->state = TASK_CANCELLED;
+    instance->running[task->priority]++;
+    task_dispatch(env, task);
+    cancelled = 1;
+  } else if (task != NULL) {
+    cancelled = ATOMIC_CAS_INT(&task->state, TASK_QUEUED, TASK_CANCELLED);
+  }
+  // Returns true only if the end callback will be called with an error:
+  napi_value result;
+  OK(napi_get_boolean(env, cancelled, &result));
+  return result;
+}
+
+static napi_value jit_enable(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t enable = 0;
+  if (argc != 1 || !arg_int(env, argv[0], &enable)) {
+    THROW(env, "bad arguments, expected: (int enable)");
+  }
+  if (enable > 1) THROW(env, "enable != 0, 1");
+  // Returns true only if the JIT is supported (and therefore enabled):
+  napi_value result;
+  OK(napi_get_boolean(env, reed_solomon_jit((int) enable), &result));
+  return result;
+}
+
+struct calibrate_task {
+  uint8_t* context;
+  uint32_t contextSize;
+  uint32_t shardSize;
+  int kernel;
+  double nanoseconds[4];
+  napi_ref ref_context;
+  napi_ref ref_callback;
+  napi_async_work async_work;
+};
+
+static void calibrate_execute(napi_env env, void* data) {
+  // Times every kernel off the JavaScript thread (for tens of milliseconds):
+  struct calibrate_task* task = data;
+  task->kernel = reed_solomon_calibrate(
+    task->context,
+    task->contextSize,
+    task->shardSize,
+    task->nanoseconds
+  );
+}
+
+static void calibrate_complete(napi_env env, napi_status status, void* data) {
+  struct calibrate_task* task = data;
+  assert(status == napi_ok);
+  napi_value scope;
+  OK(napi_get_global(env, &scope));
+  napi_value callback;
+  OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  napi_value argv[2];
+  if (task->kernel < 0) {
+    napi_value message;
+    OK(napi_create_string_utf8(env, "insufficient memory", NAPI_AUTO_LENGTH,
+      &message));
+    OK(napi_create_error(env, NULL, message, &argv[0]));
+    OK(napi_get_undefined(env, &argv[1]));
+  } else {
+    // The kernel chosen and the time taken by each kernel available:
+    OK(napi_get_null(env, &argv[0]));
+    OK(napi_create_object(env, &argv[1]));
+    napi_value name;
+    OK(napi_create_string_utf8(env, reed_solomon_kernel_name(task->kernel),
+      NAPI_AUTO_LENGTH, &name));
+    OK(napi_set_named_property(env, argv[1], "kernel", name));
+    for (int index = 1; index < 4; index++) {
+      if (task->nanoseconds[index] == 0) continue;
+      napi_value value;
+      OK(napi_create_double(env, task->nanoseconds[index], &value));
+      OK(napi_set_named_property(env, argv[1],
+        reed_solomon_kernel_name(index), value));
+    }
+  }
+  // Do not assert the return status of napi_call_function():
+  // If the callback throws then the return status will not be napi_ok.
+  napi_call_function(env, scope, callback, 2, argv, NULL);
+  OK(napi_delete_reference(env, task->ref_context));
+  OK(napi_delete_reference(env, task->ref_callback));
+  OK(napi_delete_async_work(env, task->async_work));
+  free(task);
+  task = NULL;
+}
+
+static napi_value calibrate(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t shardSize = 0;
+  napi_valuetype callback_type;
+  if (
+    argc != 3 ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_int(env, argv[1], &shardSize) ||
+    napi_typeof(env, argv[2], &callback_type) != napi_ok ||
+    callback_type != napi_function
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, int shardSize, function end)"
+    );
+  }
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  if (shardSize == 0) THROW(env, "shardSize == 0");
+  if (shardSize % 8 != 0) THROW(env, "shardSize % 8 != 0");
+  if (shardSize % (8 * reed_solomon_substripes(context, contextLength)) != 0) {
+    THROW(env, "shardSize % 16 != 0");
+  }
+  struct calibrate_task* task = calloc(1, sizeof(struct calibrate_task));
+  if (!task) THROW(env, "insufficient memory");
+  task->context = context;
+  task->contextSize = contextLength;
+  task->shardSize = shardSize;
+  OK(napi_create_reference(env, argv[0], 1, &task->ref_context));
+  OK(napi_create_reference(env, argv[2], 1, &task->ref_callback));
+  napi_value name;
+  OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+  OK(napi_create_async_work(
+    env,
+    NULL,
+    name,
+    calibrate_execute,
+    calibrate_complete,
+    task,
+    &task->async_work
+  ));
+  OK(napi_queue_async_work(env, task->async_work));
+  return NULL;
+}
+
+static napi_value dispatch(napi_env env, napi_callback_info info) {
+  size_t argc = 0;
+  OK(napi_get_cb_info(env, info, &argc, NULL, NULL, NULL));
+  if (argc != 0) THROW(env, "expected no arguments");
+  // Returns every calibrated entry of the dispatch table:
+  napi_value entries;
+  OK(napi_create_array(env, &entries));
+  uint32_t length = 0;
+  const int ws[] = { 2, 4, 8 };
+  for (int wi = 0; wi < 3; wi++) {
+    for (int k = 1; k <= MAX_K; k++) {
+      for (int size = 3; size < 32; size++) {
+        const uint32_t shardSize = (uint32_t) 1 << size;
+        const int kernel = reed_solomon_dispatch_get(ws[wi], k, shardSize);
+        if (kernel == REED_SOLOMON_KERNEL_DEFAULT) continue;
+        napi_value entry;
+        OK(napi_create_object(env, &entry));
+        set_int(env, entry, "w", ws[wi]);
+        set_int(env, entry, "k", k);
+        set_int(env, entry, "shardSize", shardSize);
+        napi_value name;
+        OK(napi_create_string_utf8(env, reed_solomon_kernel_name(kernel),
+          NAPI_AUTO_LENGTH, &name));
+        OK(napi_set_named_property(env, entry, "kernel", name));
+        OK(napi_set_element(env, entries, length++, entry));
+      }
+    }
+  }
+  return entries;
+}
+
+static napi_value dispatch_file(
+  napi_env env,
+  napi_callback_info info,
+  const int save
+) {
+  size_t argc = 1;
+  napi_value argv[1];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  char path[4096];
+  if (argc != 1 || !arg_path(env, argv[0], path, sizeof(path))) {
+    THROW(env, "bad arguments, expected: (string path)");
+  }
+  const int result = save ?
+    reed_solomon_dispatch_save(path) :
+    reed_solomon_dispatch_load(path);
+  if (result != 0) {
+    char message[256];
+    snprintf(
+      message,
+      sizeof(message),
+      "%s: %s",
+      save ? "saveDispatch" : "loadDispatch",
+      strerror(errno)
+    );
+    THROW(env, message);
+  }
+  return NULL;
+}
+
+static napi_value saveDispatch(napi_env env, napi_callback_info info) {
+  return dispatch_file(env, info, 1);
+}
+
+static napi_value loadDispatch(napi_env env, napi_callback_info info) {
+  return dispatch_file(env, info, 0);
+}
+
+static uv_once_t dispatch_once = UV_ONCE_INIT;
+
+static void dispatch_init(void) {
+  // Load a dispatch table saved by saveDispatch(), if any, at startup:
+  const char* path = getenv("REED_SOLOMON_DISPATCH");
+  if (path != NULL && path[0] != 0) reed_solomon_dispatch_load(path);
+}
+
+static napi_value threads(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t count = 0;
+  uint32_t pin = 0;
+  if (
+    argc != 2 ||
+    !arg_int(env, argv[0], &count) ||
+    !arg_int(env, argv[1], &pin)
+  ) {
+    THROW(env, "bad arguments, expected: (int threads, int pin)");
+  }
+  if (count > POOL_MAX_THREADS) THROW(env, "threads > POOL_MAX_THREADS");
+  if (pin > 1) THROW(env, "pin != 0, 1");
+  uv_once(&pool_once, pool_init);
+  uv_mutex_lock(&pool_config);
+  uv_mutex_lock(&pool.mutex);
+  const uint64_t tasks = pool.tasks;
+  uv_mutex_unlock(&pool.mutex);
+  if (tasks > 0) {
+    uv_mutex_unlock(&pool_config);
+    THROW(env, "pool is busy");
+  }
+  pool_stop();
+  const int started = count == 0 || pool_start(count, pin);
+  uv_mutex_unlock(&pool_config);
+  if (!started) THROW(env, "insufficient memory");
+  return NULL;
+}
+
+static napi_value create(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t ku = 0;
+  uint32_t mu = 0;
+  if (argc != 2 || !arg_int(env, argv[0], &ku) || !arg_int(env, argv[1], &mu)) {
+    THROW(env, "bad arguments, expected: (int k, int m)");
+  }
+  if (ku < 1) THROW(env, "k < 1");
+  if (ku > MAX_K) THROW(env, "k > MAX_K");
+  if (mu < 1) THROW(env, "m < 1");
+  if (mu > MAX_M) THROW(env, "m > MAX_M");
+  assert(MAX_K <= INT_MAX);
+  assert(MAX_M <= INT_MAX);
+  uint8_t source[REED_SOLOMON_CONTEXT_SIZE];
+  const uint32_t contextSize = reed_solomon_create((int) ku, (int) mu, source);
+  assert(contextSize > 0);
+  uint8_t* context = NULL;
+  napi_value buffer = NULL;
+  OK(napi_create_buffer_copy(env, contextSize, source, (void**) &context,
+    &buffer));
+  assert(context != NULL);
+  assert(buffer != NULL);
+  return buffer;
+}
+
+static napi_value createLRC(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t ku = 0;
+  uint32_t lu = 0;
+  uint32_t ru = 0;
+  if (
+    argc != 3 ||
+    !arg_int(env, argv[0], &ku) ||
+    !arg_int(env, argv[1], &lu) ||
+    !arg_int(env, argv[2], &ru)
+  ) {
+    THROW(env, "bad arguments, expected: (int k, int l, int r)");
+  }
+  if (ku < 1) THROW(env, "k < 1");
+  if (ku > MAX_K) THROW(env, "k > MAX_K");
+  if (lu < 1) THROW(env, "l < 1");
+  if (lu > ku) THROW(env, "l > k");
+  if (ru > MAX_M || lu + ru > MAX_M) THROW(env, "l + r > MAX_M");
+  uint8_t source[REED_SOLOMON_CONTEXT_SIZE];
+  const uint32_t contextSize = reed_solomon_create_lrc(
+    (int) ku,
+    (int) lu,
+    (int) ru,
+    source
+  );
+  assert(contextSize > 0);
+  uint8_t* context = NULL;
+  napi_value buffer = NULL;
+  OK(napi_create_buffer_copy(env, contextSize, source, (void**) &context,
+    &buffer));
+  assert(context != NULL);
+  assert(buffer != NULL);
+  return buffer;
+}
+
+static napi_value createPiggyback(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t ku = 0;
+  uint32_t mu = 0;
+  if (argc != 2 || !arg_int(env, argv[0], &ku) || !arg_int(env, argv[1], &mu)) {
+    THROW(env, "bad arguments, expected: (int k, int m)");
+  }
+  if (ku < 1) THROW(env, "k < 1");
+  if (ku > MAX_K) THROW(env, "k > MAX_K");
+  if (mu < 2) THROW(env, "m < 2");
+  if (mu > MAX_M) THROW(env, "m > MAX_M");
+  uint8_t source[REED_SOLOMON_CONTEXT_SIZE];
+  const uint32_t contextSize = reed_solomon_create_piggyback(
+    (int) ku,
+    (int) mu,
+    source
+  );
+  assert(contextSize > 0);
+  uint8_t* context = NULL;
+  napi_value buffer = NULL;
+  OK(napi_create_buffer_copy(env, contextSize, source, (void**) &context,
+    &buffer));
+  assert(context != NULL);
+  assert(buffer != NULL);
+  return buffer;
+}
+
+static const char* check_stripe(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint64_t bufferLength,
+  const uint64_t bufferOffset,
+  const uint64_t bufferSize,
+  const uint64_t parityLength,
+  const uint64_t parityOffset,
+  const uint64_t paritySize,
+  uint32_t* shardSize
+) {
+  // The context must have been checked by reed_solomon_check_context():
+  const int w = (int) context[0];
+  const int k = (int) context[1];
+  const int m = (int) context[2];
+  if (bufferSize == 0) return "bufferSize == 0";
+  // Offsets and sizes are safe integers, so their sum cannot overflow:
+  if (bufferOffset + bufferSize > bufferLength) {
+    return "bufferOffset + bufferSize > buffer.length";
+  }
+  // The last data shard may be short and is padded virtually with zeroes.
+  // The stripe may exceed 4 GB, but each shard (as padded) may not:
+  const uint64_t size = bufferSize / k + (bufferSize % k ? 1 : 0);
+  if (size > 4294967288) return "bufferSize / k > 4294967288";
+  *shardSize = (uint32_t) size;
+  assert(*shardSize != 0);
+  // Parity shards are padded to a multiple of 8 bytes (and therefore of w) for
+  // each substripe:
+  const uint64_t align = 8 * reed_solomon_substripes(context, contextSize);
+  const uint64_t paddedSize = ((uint64_t) *shardSize + align - 1) &
+    ~(align - 1);
+  assert(paddedSize % w == 0);
+  (void) w; // Used only by asserts.
+  if (paritySize == 0) return "paritySize == 0";
+  if (paritySize % m != 0) return "paritySize % m != 0";
+  if (paritySize / m != paddedSize) {
+    return "paritySize / m != paddedShardSize";
+  }
+  if (parityOffset + paritySize > parityLength) {
+    return "parityOffset + paritySize > parity.length";
+  }
+  return NULL;
+}
+
+static napi_value task_submit(
+  napi_env env,
+  struct task_data* task,
+  napi_value context,
+  napi_value buffer,
+  napi_value parity,
+  napi_value end
+) {
+  // Takes ownership of task (and its scratch), which must have been allocated
+  // with calloc():
+  struct instance* instance = NULL;
+  OK(napi_get_instance_data(env, (void**) &instance));
+  assert(instance != NULL);
+  if (!task_insert(instance, task)) {
+    free(task->scratch);
+    free(task);
+    THROW(env, "insufficient memory");
+  }
+  task->instance = instance;
+  task->batch = (uint8_t) instance->batch;
+  if (instance->reuse) {
+    task->cached_context = ref_acquire(env, &instance->contexts,
+      context, &task->ref_context);
+    task->cached_callback = ref_acquire(env, &instance->callbacks,
+      end, &task->ref_callback);
+  } else {
+    OK(napi_create_reference(env, context, 1, &task->ref_context));
+    OK(napi_create_reference(env, end, 1, &task->ref_callback));
+  }
+  OK(napi_create_reference(env, buffer, 1, &task->ref_buffer));
+  OK(napi_create_reference(env, parity, 1, &task->ref_parity));
+  // Hold the task behind any others of its class, then dispatch what we can:
+  task_hold(instance, task);
+  task_drain(env, instance);
+  // Returns the id of the task, to cancel it while it is queued:
+  napi_value id;
+  OK(napi_create_uint32(env, task->id, &id));
+  return id;
+}
+
+static napi_value encode(napi_env env, napi_callback_info info) {
+  size_t argc = 11;
+  napi_value argv[11];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t sources = 0;
+  uint32_t targets = 0;
+  uint8_t* buffer = NULL;
+  uint64_t bufferLength = 0;
+  uint64_t bufferOffset = 0;
+  uint64_t bufferSize = 0;
+  uint8_t* parity = NULL;
+  uint64_t parityLength = 0;
+  uint64_t parityOffset = 0;
+  uint64_t paritySize = 0;
+  uint32_t priority = PRIORITY_FOREGROUND;
+  // The priority is optional, and the end callback is always the last argument:
+  napi_value end = argv[argc == 11 ? 10 : 9];
+  napi_valuetype callback_type;
+  OK(napi_typeof(env, end, &callback_type));
+  if (
+    (argc != 10 && argc != 11) ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_int(env, argv[1], &sources) ||
+    !arg_int(env, argv[2], &targets) ||
+    !arg_bytes(env, argv[3], &buffer, &bufferLength) ||
+    !arg_offset(env, argv[4], &bufferOffset) ||
+    !arg_offset(env, argv[5], &bufferSize) ||
+    !arg_bytes(env, argv[6], &parity, &parityLength) ||
+    !arg_offset(env, argv[7], &parityOffset) ||
+    !arg_offset(env, argv[8], &paritySize) ||
+    (argc == 11 && !arg_int(env, argv[9], &priority)) ||
+    callback_type != napi_function
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, int sources, int targets, "
+      "Buffer buffer, int bufferOffset, int bufferSize, "
+      "Buffer parity, int parityOffset, int paritySize, [int priority], "
+      "function end)"
+    );
+  }
+  if (priority > PRIORITY_BACKGROUND) THROW(env, "priority != 0, 1");
+  assert(context != NULL);
+  assert(buffer != NULL);
+  assert(parity != NULL);
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  error = reed_solomon_check_flags(context, contextLength, sources, targets);
+  if (error) THROW(env, error);
+  uint32_t shardSize = 0;
+  error = check_stripe(context, contextLength, bufferLength, bufferOffset,
+    bufferSize, parityLength, parityOffset, paritySize, &shardSize);
+  if (error) THROW(env, error);
+  struct task_data* task = calloc(1, sizeof(struct task_data));
+  if (!task) THROW(env, "insufficient memory");
+  task->context = context;
+  task->contextSize = contextLength;
+  task->sources = sources;
+  task->targets = targets;
+  task->buffer = buffer + bufferOffset;
+  task->bufferSize = bufferSize;
+  task->parity = parity + parityOffset;
+  task->paritySize = paritySize;
+  task->shardSize = shardSize;
+  task->priority = (uint8_t) priority;
+  task->state = TASK_QUEUED;
+  return task_submit(env, task, argv[0], argv[3], argv[6], end);
+}
+
+static int arg_layout(
+  napi_env env,
+  napi_value value,
+  uint32_t* unit,
+  uint64_t* stride,
+  uint32_t* rotation
+) {
+  // An array of [int unit, int stride, int rotation]:
+  bool is_array = 0;
+  if (napi_is_array(env, value, &is_array) != napi_ok || !is_array) return 0;
+  uint32_t array_length = 0;
+  OK(napi_get_array_length(env, value, &array_length));
+  if (array_length != 3) return 0;
+  napi_value elements[3];
+  for (uint32_t index = 0; index < 3; index++) {
+    OK(napi_get_element(env, value, index, &elements[index]));
+  }
+  return (
+    arg_int(env, elements[0], unit) &&
+    arg_offset(env, elements[1], stride) &&
+    arg_int(env, elements[2], rotation)
+  );
+}
+
+static napi_value encodeLayout(napi_env env, napi_callback_info info) {
+  size_t argc = 12;
+  napi_value argv[12];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t unit = 0;
+  uint64_t stride = 0;
+  uint32_t rotation = 0;
+  uint32_t sources = 0;
+  uint32_t targets = 0;
+  uint8_t* buffer = NULL;
+  uint64_t bufferLength = 0;
+  uint64_t bufferOffset = 0;
+  uint64_t bufferSize = 0;
+  uint8_t* parity = NULL;
+  uint64_t parityLength = 0;
+  uint64_t parityOffset = 0;
+  uint64_t paritySize = 0;
+  uint32_t priority = PRIORITY_FOREGROUND;
+  // The priority is optional, and the end callback is always the last argument:
+  napi_value end = argv[argc == 12 ? 11 : 10];
+  napi_valuetype callback_type;
+  OK(napi_typeof(env, end, &callback_type));
+  if (
+    (argc != 11 && argc != 12) ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_layout(env, argv[1], &unit, &stride, &rotation) ||
+    !arg_int(env, argv[2], &sources) ||
+    !arg_int(env, argv[3], &targets) ||
+    !arg_bytes(env, argv[4], &buffer, &bufferLength) ||
+    !arg_offset(env, argv[5], &bufferOffset) ||
+    !arg_offset(env, argv[6], &bufferSize) ||
+    !arg_bytes(env, argv[7], &parity, &parityLength) ||
+    !arg_offset(env, argv[8], &parityOffset) ||
+    !arg_offset(env, argv[9], &paritySize) ||
+    (argc == 12 && !arg_int(env, argv[10], &priority)) ||
+    callback_type != napi_function
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, Array layout, int sources, "
+      "int targets, Buffer buffer, int bufferOffset, int bufferSize, "
+      "Buffer parity, int parityOffset, int paritySize, [int priority], "
+      "function end)"
+    );
+  }
+  if (priority > PRIORITY_BACKGROUND) THROW(env, "priority != 0, 1");
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  error = reed_solomon_check_flags(context, contextLength, sources, targets);
+  if (error) THROW(env, error);
+  if (reed_solomon_substripes(context, contextLength) != 1) {
+    THROW(env, "layout of substripes");
+  }
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  if (unit == 0) THROW(env, "unit == 0");
+  if (unit % 8 != 0) THROW(env, "unit % 8 != 0");
+  if (stride < (uint64_t) k * unit) THROW(env, "stride < k * unit");
+  if (rotation >= (uint32_t) k) THROW(env, "rotation >= k");
+  if (bufferSize == 0) THROW(env, "bufferSize == 0");
+  if (bufferOffset + bufferSize > bufferLength) {
+    THROW(env, "bufferOffset + bufferSize > buffer.length");
+  }
+  // The buffer is a whole number of rows, each with a unit of every shard:
+  if (bufferSize % stride != 0) THROW(env, "bufferSize % stride != 0");
+  const uint64_t size = bufferSize / stride * unit;
+  if (size > 4294967288) THROW(env, "shardSize > 4294967288");
+  const uint32_t shardSize = (uint32_t) size;
+  if (paritySize % m != 0) THROW(env, "paritySize % m != 0");
+  if (paritySize / m != shardSize) THROW(env, "paritySize / m != shardSize");
+  if (parityOffset + paritySize > parityLength) {
+    THROW(env, "parityOffset + paritySize > parity.length");
+  }
+  const uint32_t regionSize = reed_solomon_region_size(w, k, shardSize);
+  uint8_t* scratch = NULL;
+  if (unit % regionSize != 0) {
+    scratch = malloc((size_t) k * regionSize);
+    if (!scratch) THROW(env, "insufficient memory");
+  }
+  struct task_data* task = calloc(1, sizeof(struct task_data));
+  if (!task) {
+    free(scratch);
+    THROW(env, "insufficient memory");
+  }
+  task->context = context;
+  task->contextSize = contextLength;
+  task->sources = sources;
+  task->targets = targets;
+  task->buffer = buffer + bufferOffset;
+  task->bufferSize = bufferSize;
+  task->parity = parity + parityOffset;
+  task->paritySize = paritySize;
+  task->shardSize = shardSize;
+  task->priority = (uint8_t) priority;
+  task->state = TASK_QUEUED;
+  task->unit = unit;
+  task->stride = stride;
+  task->rotation = rotation;
+  task->scratch = scratch;
+  return task_submit(env, task, argv[0], argv[4], argv[7], end);
+}
+
+static napi_value reads(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t sources = 0;
+  uint32_t targets = 0;
+  uint32_t substripe = 0;
+  if (
+    (argc != 3 && argc != 4) ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_int(env, argv[1], &sources) ||
+    !arg_int(env, argv[2], &targets) ||
+    (argc == 4 && !arg_int(env, argv[3], &substripe))
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, int sources, int targets, "
+      "[int substripe])"
+    );
+  }
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  error = reed_solomon_check_flags(context, contextLength, sources, targets);
+  if (error) THROW(env, error);
+  const int substripes = reed_solomon_substripes(context, contextLength);
+  if (substripe >= (uint32_t) substripes) THROW(env, "substripe >= substripes");
+  // Returns the sources which encode() reads to encode the targets (or of which
+  // it reads the substripe):
+  napi_value result;
+  OK(napi_create_uint32(
+    env,
+    argc == 4 ?
+      reed_solomon_reads_substripe(context, contextLength, sources, targets,
+        (int) substripe) :
+      reed_solomon_reads(context, contextLength, sources, targets),
+    &result
+  ));
+  return result;
+}
+
+struct locate_task {
+  uint8_t* context;
+  uint32_t contextSize;
+  uint8_t* buffer;
+  uint64_t bufferSize;
+  uint8_t* parity;
+  uint32_t shardSize;
+  uint32_t paddedSize;
+  uint32_t substripes;
+  uint32_t regions;
+  int* located;
+  int inconsistent;
+  napi_ref ref_context;
+  napi_ref ref_buffer;
+  napi_ref ref_parity;
+  napi_ref ref_callback;
+  napi_async_work async_work;
+};
+
+void locate_execute(napi_env env, void* data) {
+  struct locate_task* task = data;
+  const int k = task->context[1];
+  const int m = task->context[2];
+  uint8_t* shards[MAX_K + MAX_M];
+  uint32_t shardLengths[MAX_K + MAX_M];
+  // The same layout as task_encode(), with short or empty last data shards:
+  for (int index = 0; index < k; index++) {
+    uint64_t offset = (uint64_t) task->shardSize * index;
+    shards[index] = task->buffer + offset;
+    if (offset >= task->bufferSize) {
+      shardLengths[index] = 0;
+    } else if (task->bufferSize - offset < task->shardSize) {
+      shardLengths[index] = (uint32_t) (task->bufferSize - offset);
+    } else {
+      shardLengths[index] = task->shardSize;
+    }
+  }
+  for (int index = 0; index < m; index++) {
+    shards[index + k] = task->parity + (uint64_t) task->paddedSize * index;
+    shardLengths[index + k] = task->paddedSize;
+  }
+  task->inconsistent = reed_solomon_locate(
+    task->context,
+    task->contextSize,
+    shards,
+    shardLengths,
+    task->paddedSize,
+    task->located
+  );
+}
+
+void locate_complete(napi_env env, napi_status status, void* data) {
+  struct locate_task* task = data;
+  assert(status == napi_ok);
+  napi_value scope;
+  OK(napi_get_global(env, &scope));
+  napi_value callback;
+  OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  napi_value argv[2];
+  if (task->inconsistent < 0) {
+    napi_value message;
+    OK(napi_create_string_utf8(env, "insufficient memory", NAPI_AUTO_LENGTH,
+      &message));
+    OK(napi_create_error(env, NULL, message, &argv[0]));
+    OK(napi_get_undefined(env, &argv[1]));
+  } else {
+    // An array of the regions which are not consistent, where shard is -1 if
+    // the corrupt shard could not be located:
+    OK(napi_get_null(env, &argv[0]));
+    OK(napi_create_array_with_length(env, task->inconsistent, &argv[1]));
+    // Regions are of each substripe in turn:
+    const uint32_t substripeSize = task->paddedSize / task->substripes;
+    const uint32_t substripeRegions = task->regions / task->substripes;
+    const uint32_t regionSize = substripeSize / substripeRegions;
+    uint32_t index = 0;
+    for (uint32_t region = 0; region < task->regions; region++) {
+      const int located = task->located[region];
+      if (located == REED_SOLOMON_LOCATE_CONSISTENT) continue;
+      napi_value object;
+      OK(napi_create_object(env, &object));
+      napi_value value;
+      OK(napi_create_int32(
+        env,
+        located == REED_SOLOMON_LOCATE_UNKNOWN ? -1 : located,
+        &value
+      ));
+      OK(napi_set_named_property(env, object, "shard", value));
+      OK(napi_create_uint32(
+        env,
+        region / substripeRegions * substripeSize +
+          region % substripeRegions * regionSize,
+        &value
+      ));
+      OK(napi_set_named_property(env, object, "offset", value));
+      OK(napi_create_uint32(env, regionSize, &value));
+      OK(napi_set_named_property(env, object, "size", value));
+      OK(napi_set_element(env, argv[1], index++, object));
+    }
+    assert(index == (uint32_t) task->inconsistent);
+  }
+  // Do not assert the return status of napi_call_function():
+  // If the callback throws then the return status will not be napi_ok.
+  napi_call_function(env, scope, callback, 2, argv, NULL);
+  OK(napi_delete_reference(env, task->ref_context));
+  OK(napi_delete_reference(env, task->ref_buffer));
+  OK(napi_delete_reference(env, task->ref_parity));
+  OK(napi_delete_reference(env, task->ref_callback));
+  OK(napi_delete_async_work(env, task->async_work));
+  free(task->located);
+  free(task);
+  task = NULL;
+}
+
+static napi_value locate(napi_env env, napi_callback_info info) {
+  size_t argc = 8;
+  napi_value argv[8];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint8_t* buffer = NULL;
+  uint64_t bufferLength = 0;
+  uint64_t bufferOffset = 0;
+  uint64_t bufferSize = 0;
+  uint8_t* parity = NULL;
+  uint64_t parityLength = 0;
+  uint64_t parityOffset = 0;
+  uint64_t paritySize = 0;
+  napi_valuetype callback_type;
+  if (
+    argc != 8 ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_bytes(env, argv[1], &buffer, &bufferLength) ||
+    !arg_offset(env, argv[2], &bufferOffset) ||
+    !arg_offset(env, argv[3], &bufferSize) ||
+    !arg_bytes(env, argv[4], &parity, &parityLength) ||
+    !arg_offset(env, argv[5], &parityOffset) ||
+    !arg_offset(env, argv[6], &paritySize) ||
+    napi_typeof(env, argv[7], &callback_type) != napi_ok ||
+    callback_type != napi_function
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, "
+      "Buffer buffer, int bufferOffset, int bufferSize, "
+      "Buffer parity, int parityOffset, int paritySize, function end)"
+    );
+  }
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  uint32_t shardSize = 0;
+  error = check_stripe(context, contextLength, bufferLength, bufferOffset,
+    bufferSize, parityLength, parityOffset, paritySize, &shardSize);
+  if (error) THROW(env, error);
+  struct locate_task* task = calloc(1, sizeof(struct locate_task));
+  if (!task) THROW(env, "insufficient memory");
+  task->context = context;
+  task->contextSize = contextLength;
+  task->buffer = buffer + bufferOffset;
+  task->bufferSize = bufferSize;
+  task->parity = parity + parityOffset;
+  task->shardSize = shardSize;
+  task->paddedSize = (uint32_t) (paritySize / context[2]);
+  task->substripes = reed_solomon_substripes(context, contextLength);
+  const uint32_t substripeSize = task->paddedSize / task->substripes;
+  task->regions = task->substripes * (substripeSize /
+    reed_solomon_region_size(context[0], context[1], substripeSize));
+  task->located = calloc(task->regions, sizeof(int));
+  if (!task->located) {
+    free(task);
+    THROW(env, "insufficient memory");
+  }
+  OK(napi_create_reference(env, argv[0], 1, &task->ref_context));
+  OK(napi_create_reference(env, argv[1], 1, &task->ref_buffer));
+  OK(napi_create_reference(env, argv[4], 1, &task->ref_parity));
+  OK(napi_create_reference(env, argv[7], 1, &task->ref_callback));
+  napi_value name;
+  OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+  OK(napi_create_async_work(
+    env,
+    NULL,
+    name,
+    locate_execute,
+    locate_complete,
+    task,
+    &task->async_work
+  ));
+  OK(napi_queue_async_work(env, task->async_work));
+  return NULL;
+}
+
+static void encoder_finalize(napi_env env, void* data, void* hint) {
+  struct encoder* encoder = data;
+  // The encoder is strongly referenced while slots are busy, unless the
+  // environment is shutting down (when busy slots are leaked):
+  if (encoder->busy > 0) return;
+  for (uint32_t slot = 0; slot < encoder->slots; slot++) {
+    if (encoder->tasks[slot].async_work != NULL) {
+      OK(napi_delete_async_work(env, encoder->tasks[slot].async_work));
+    }
+  }
+  OK(napi_delete_reference(env, encoder->ref_context));
+  OK(napi_delete_reference(env, encoder->ref_values));
+  OK(napi_delete_reference(env, encoder->ref_self));
+  free(encoder->tasks);
+  free(encoder);
+}
+
+static napi_value encoder_run(napi_env env, napi_callback_info info) {
+  size_t argc = 10;
+  napi_value argv[10];
+  napi_value self;
+  OK(napi_get_cb_info(env, info, &argc, argv, &self, NULL));
+  struct encoder* encoder = NULL;
+  uint32_t sources = 0;
+  uint32_t targets = 0;
+  uint8_t* buffer = NULL;
+  uint64_t bufferLength = 0;
+  uint64_t bufferOffset = 0;
+  uint64_t bufferSize = 0;
+  uint8_t* parity = NULL;
+  uint64_t parityLength = 0;
+  uint64_t parityOffset = 0;
+  uint64_t paritySize = 0;
+  uint32_t priority = PRIORITY_FOREGROUND;
+  // The priority is optional, and the end callback is always the last argument:
+  napi_value end = argv[argc == 10 ? 9 : 8];
+  napi_valuetype callback_type;
+  OK(napi_typeof(env, end, &callback_type));
+  if (
+    napi_unwrap(env, self, (void**) &encoder) != napi_ok ||
+    (argc != 9 && argc != 10) ||
+    !arg_int(env, argv[0], &sources) ||
+    !arg_int(env, argv[1], &targets) ||
+    !arg_bytes(env, argv[2], &buffer, &bufferLength) ||
+    !arg_offset(env, argv[3], &bufferOffset) ||
+    !arg_offset(env, argv[4], &bufferSize) ||
+    !arg_bytes(env, argv[5], &parity, &parityLength) ||
+    !arg_offset(env, argv[6], &parityOffset) ||
+    !arg_offset(env, argv[7], &paritySize) ||
+    (argc == 10 && !arg_int(env, argv[8], &priority)) ||
+    callback_type != napi_function
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (int sources, int targets, "
+      "Buffer buffer, int bufferOffset, int bufferSize, "
+      "Buffer parity, int parityOffset, int paritySize, [int priority], "
+      "function end)"
+    );
+  }
+  if (priority > PRIORITY_BACKGROUND) THROW(env, "priority != 0, 1");
+  assert(encoder != NULL);
+  const char* error = reed_solomon_check_flags(
+    encoder->context,
+    encoder->contextSize,
+    sources,
+    targets
+  );
+  if (error) THROW(env, error);
+  uint32_t shardSize = 0;
+  error = check_stripe(encoder->context, encoder->contextSize, bufferLength,
+    bufferOffset, bufferSize, parityLength, parityOffset, paritySize,
+    &shardSize);
+  if (error) THROW(env, error);
+  if (encoder->free == NULL) THROW(env, "encoder is busy");
+  struct instance* instance = NULL;
+  OK(napi_get_instance_data(env, (void**) &instance));
+  assert(instance != NULL);
+  struct task_data* task = encoder->free;
+  if (!task_insert(instance, task)) THROW(env, "insufficient memory");
+  encoder->free = task->next;
+  task->next = NULL;
+  task->sources = sources;
+  task->targets = targets;
+  task->buffer = buffer + bufferOffset;
+  task->bufferSize = bufferSize;
+  task->parity = parity + parityOffset;
+  task->paritySize = paritySize;
+  task->shardSize = shardSize;
+  task->remaining = 0;
+  task->tsfn = NULL;
+  task->instance = instance;
+  task->pooled = 0;
+  task->batch = (uint8_t) instance->batch;
+  task->priority = (uint8_t) priority;
+  task->state = TASK_QUEUED;
+  napi_value values;
+  OK(napi_get_reference_value(env, encoder->ref_values, &values));
+  OK(napi_set_element(env, values, task->slot * 3 + 0, argv[2]));
+  OK(napi_set_element(env, values, task->slot * 3 + 1, argv[5]));
+  OK(napi_set_element(env, values, task->slot * 3 + 2, end));
+  // Keep the encoder (and its context) alive while any slot is busy:
+  if (encoder->busy++ == 0) {
+    OK(napi_reference_ref(env, encoder->ref_self, NULL));
+  }
+  task_hold(instance, task);
+  task_drain(env, instance);
+  // Returns the id of the task, to cancel it while it is queued:
+  napi_value id;
+  OK(napi_create_uint32(env, task->id, &id));
+  return id;
+}
+
+static napi_value createEncoder(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t slots = 0;
+  if (
+    argc != 2 ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_int(env, argv[1], &slots)
+  ) {
+    THROW(env, "bad arguments, expected: (Buffer context, int slots)");
+  }
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  if (slots < 1) THROW(env, "slots < 1");
+  if (slots > ENCODER_MAX_SLOTS) THROW(env, "slots > ENCODER_MAX_SLOTS");
+  struct encoder* encoder = calloc(1, sizeof(struct encoder));
+  if (!encoder) THROW(env, "insufficient memory");
+  encoder->tasks = calloc(slots, sizeof(struct task_data));
+  if (!encoder->tasks) {
+    free(encoder);
+    THROW(env, "insufficient memory");
+  }
+  encoder->context = context;
+  encoder->contextSize = contextLength;
+  encoder->slots = slots;
+  for (uint32_t slot = slots; slot-- > 0;) {
+    struct task_data* task = &encoder->tasks[slot];
+    task->context = context;
+    task->contextSize = contextLength;
+    task->encoder = encoder;
+    task->slot = slot;
+    task->next = encoder->free;
+    encoder->free = task;
+  }
+  napi_value object;
+  OK(napi_create_object(env, &object));
+  napi_value values;
+  OK(napi_create_array_with_length(env, slots * 3, &values));
+  OK(napi_create_reference(env, argv[0], 1, &encoder->ref_context));
+  OK(napi_create_reference(env, values, 1, &encoder->ref_values));
+  OK(napi_wrap(env, object, encoder, encoder_finalize, NULL, NULL));
+  OK(napi_create_reference(env, object, 0, &encoder->ref_self));
+  set_method(env, object, "run", encoder_run);
+  return object;
+}
+
+// A volume lays out stripes end to end, each of k data shards in buffer (the
+// last stripe may be short and is padded virtually with zeroes) and m parity
+// shards in parity, with a bit per stripe whose parity is stale. mark() marks
+// the stripes of a write, and flush() drains them through the threadpool in
+// runs of adjacent stripes, at most concurrency runs at a time:
+#define VOLUME_MAX_CONCURRENCY 256
+#define VOLUME_RUN_STRIPES 64
+
+struct volume;
+
+struct volume_work {
+  struct volume* volume;
+  uint64_t first;
+  uint64_t count; // Zero if the work only completes a flush.
+  napi_async_work async_work;
+  struct volume_work* next;
+};
+
+struct volume {
+  uint8_t* context;
+  uint32_t contextSize;
+  uint8_t* buffer;
+  uint64_t bufferSize;
+  uint8_t* parity;
+  uint32_t shardSize;
+  uint64_t stripes;
+  uint64_t* dirty; // Stripes whose parity is stale.
+  uint64_t* running; // Stripes being encoded, which are not taken again.
+  uint64_t dirtyCount;
+  uint64_t cursor; // Runs are taken in turn from here, around the volume.
+  uint32_t concurrency;
+  uint32_t busy;
+  struct volume_work* free;
+  struct volume_work* works;
+  uint32_t flushes; // End callbacks waiting for the volume to be clean.
+  napi_ref ref_context;
+  napi_ref ref_buffer;
+  napi_ref ref_parity;
+  napi_ref ref_flushes;
+  napi_ref ref_self; // Strong only while flushes are waiting.
+};
+
+static int volume_get(const uint64_t* bits, const uint64_t stripe) {
+  return (bits[stripe / 64] >> (stripe % 64)) & 1;
+}
+
+static void volume_set(uint64_t* bits, const uint64_t stripe, const int bit) {
+  const uint64_t mask = (uint64_t) 1 << (stripe % 64);
+  if (bit) {
+    bits[stripe / 64] |= mask;
+  } else {
+    bits[stripe / 64] &= ~mask;
+  }
+}
+
+static uint64_t volume_find(
+  const struct volume* volume,
+  uint64_t stripe,
+  const uint64_t end
+) {
+  // Returns the first dirty stripe in [stripe, end) not being encoded, or end:
+  while (stripe < end) {
+    const uint64_t word = stripe / 64;
+    uint64_t bits = volume->dirty[word] & ~volume->running[word];
+    bits >>= stripe % 64;
+    if (bits == 0) {
+      stripe = (word + 1) * 64;
+      continue;
+    }
+    while (!(bits & 1)) {
+      bits >>= 1;
+      stripe++;
+    }
+    break;
+  }
+  return stripe < end ? stripe : end;
+}
+
+static uint64_t volume_take(struct volume* volume, uint64_t* first) {
+  // Takes a run of adjacent dirty stripes (cleaning them, and marking them as
+  // running), returning the number of stripes in the run:
+  if (volume->dirtyCount == 0) return 0;
+  uint64_t stripe = volume_find(volume, volume->cursor, volume->stripes);
+  if (stripe == volume->stripes) {
+    stripe = volume_find(volume, 0, volume->cursor);
+    if (stripe == volume->cursor) return 0;
+  }
+  *first = stripe;
+  uint64_t count = 0;
+  while (
+    count < VOLUME_RUN_STRIPES &&
+    stripe < volume->stripes &&
+    volume_get(volume->dirty, stripe) &&
+    !volume_get(volume->running, stripe)
+  ) {
+    volume_set(volume->dirty, stripe, 0);
+    volume_set(volume->running, stripe, 1);
+    count++;
+    stripe++;
+  }
+  assert(count > 0);
+  assert(volume->dirtyCount >= count);
+  volume->dirtyCount -= count;
+  volume->cursor = stripe < volume->stripes ? stripe : 0;
+  return count;
+}
+
+static void volume_execute(napi_env env, void* data) {
+  struct volume_work* work = data;
+  struct volume* volume = work->volume;
+  const int k = volume->context[1];
+  const int m = volume->context[2];
+  const uint64_t stripeSize = (uint64_t) volume->shardSize * k;
+  uint8_t* shards[MAX_K + MAX_M];
+  uint32_t shardLengths[MAX_K + MAX_M];
+  for (uint64_t stripe = work->first; stripe < work->first + work->count;
+    stripe++) {
+    // The same layout as task_encode(), with short or empty last data shards:
+    uint8_t* buffer = volume->buffer + stripe * stripeSize;
+    const uint64_t bufferSize = volume->bufferSize - stripe * stripeSize;
+    for (int index = 0; index < k; index++) {
+      uint64_t offset = (uint64_t) volume->shardSize * index;
+      shards[index] = buffer + offset;
+      if (offset >= bufferSize) {
+        shardLengths[index] = 0;
+      } else if (bufferSize - offset < volume->shardSize) {
+        shardLengths[index] = (uint32_t) (bufferSize - offset);
+      } else {
+        shardLengths[index] = volume->shardSize;
+      }
+    }
+    uint8_t* parity = volume->parity +
+      stripe * (uint64_t) volume->shardSize * m;
+    for (int index = 0; index < m; index++) {
+      shards[index + k] = parity + (uint64_t) volume->shardSize * index;
+      shardLengths[index + k] = volume->shardSize;
+    }
+    reed_solomon_encode(
+      volume->context,
+      volume->contextSize,
+      ((uint32_t) 1 << k) - 1,
+      (((uint32_t) 1 << m) - 1) << k,
+      shards,
+      shardLengths,
+      volume->shardSize
+    );
+  }
+}
+
+static void volume_dispatch(
+  napi_env env,
+  struct volume* volume,
+  const uint64_t first,
+  const uint64_t count
+) {
+  struct volume_work* work = volume->free;
+  assert(work != NULL);
+  volume->free = work->next;
+  work->next = NULL;
+  work->first = first;
+  work->count = count;
+  volume->busy++;
+  OK(napi_queue_async_work(env, work->async_work));
+}
+
+static void volume_fill(napi_env env, struct volume* volume) {
+  // Dispatches runs to idle works:
+  uint64_t first = 0;
+  uint64_t count = 0;
+  while (volume->free != NULL && (count = volume_take(volume, &first)) > 0) {
+    volume_dispatch(env, volume, first, count);
+  }
+}
+
+static void volume_pump(napi_env env, struct volume* volume) {
+  // Calls every end callback once the volume is clean (and no work is running):
+  volume_fill(env, volume);
+  if (volume->busy > 0) return;
+  assert(volume->dirtyCount == 0);
+  assert(volume->flushes > 0);
+  napi_value flushes;
+  OK(napi_get_reference_value(env, volume->ref_flushes, &flushes));
+  napi_value empty;
+  OK(napi_create_array(env, &empty));
+  OK(napi_delete_reference(env, volume->ref_flushes));
+  OK(napi_create_reference(env, empty, 1, &volume->ref_flushes));
+  const uint32_t length = volume->flushes;
+  volume->flushes = 0;
+  OK(napi_reference_unref(env, volume->ref_self, NULL));
+  napi_value scope;
+  OK(napi_get_global(env, &scope));
+  for (uint32_t index = 0; index < length; index++) {
+    napi_handle_scope handleScope;
+    OK(napi_open_handle_scope(env, &handleScope));
+    napi_value callback;
+    OK(napi_get_element(env, flushes, index, &callback));
+    // Do not assert the return status of napi_call_function():
+    // If the callback throws then the return status will not be napi_ok.
+    napi_call_function(env, scope, callback, 0, NULL, NULL);
+    // Report an exception thrown by a callback without losing the rest:
+    report_exception(env);
+    OK(napi_close_handle_scope(env, handleScope));
+  }
+}
+
+static void volume_complete(napi_env env, napi_status status, void* data) {
+  struct volume_work* work = data;
+  struct volume* volume = work->volume;
+  assert(status == napi_ok);
+  for (uint64_t stripe = work->first; stripe < work->first + work->count;
+    stripe++) {
+    volume_set(volume->running, stripe, 0);
+  }
+  work->next = volume->free;
+  volume->free = work;
+  assert(volume->busy > 0);
+  volume->busy--;
+  volume_pump(env, volume);
+}
+
+static void volume_finalize(napi_env env, void* data, void* hint) {
+  struct volume* volume = data;
+  // The volume is strongly referenced while flushes are waiting, unless the
+  // environment is shutting down (when the volume is leaked):
+  if (volume->flushes > 0) return;
+  for (uint32_t index = 0; index < volume->concurrency; index++) {
+    if (volume->works[index].async_work != NULL) {
+      OK(napi_delete_async_work(env, volume->works[index].async_work));
+    }
+  }
+  OK(napi_delete_reference(env, volume->ref_context));
+  OK(napi_delete_reference(env, volume->ref_buffer));
+  OK(napi_delete_reference(env, volume->ref_parity));
+  OK(napi_delete_reference(env, volume->ref_flushes));
+  OK(napi_delete_reference(env, volume->ref_self));
+  free(volume->works);
+  free(volume->dirty);
+  free(volume->running);
+  free(volume);
+}
+
+static napi_value volume_mark(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  napi_value self;
+  OK(napi_get_cb_info(env, info, &argc, argv, &self, NULL));
+  struct volume* volume = NULL;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  if (
+    napi_unwrap(env, self, (void**) &volume) != napi_ok ||
+    argc != 2 ||
+    !arg_offset(env, argv[0], &offset) ||
+    !arg_offset(env, argv[1], &size)
+  ) {
+    THROW(env, "bad arguments, expected: (int offset, int size)");
+  }
+  assert(volume != NULL);
+  if (offset + size > volume->bufferSize) {
+    THROW(env, "offset + size > buffer.length");
+  }
+  // Marks every stripe which overlaps [offset, offset + size) of buffer:
+  const uint64_t stripeSize = (uint64_t) volume->shardSize * volume->context[1];
+  uint64_t stripe = offset / stripeSize;
+  const uint64_t end = size == 0 ? stripe :
+    (offset + size - 1) / stripeSize + 1;
+  while (stripe < end) {
+    if (stripe % 64 == 0 && end - stripe >= 64) {
+      // Whole words at a time:
+      uint64_t clean = ~volume->dirty[stripe / 64];
+      while (clean) {
+        clean &= clean - 1;
+        volume->dirtyCount++;
+      }
+      volume->dirty[stripe / 64] = ~(uint64_t) 0;
+      stripe += 64;
+      continue;
+    }
+    if (!volume_get(volume->dirty, stripe)) {
+      volume_set(volume->dirty, stripe, 1);
+      volume->dirtyCount++;
+    }
+    stripe++;
+  }
+  return NULL;
+}
+
+static napi_value volume_dirty(napi_env env, napi_callback_info info) {
+  napi_value self;
+  OK(napi_get_cb_info(env, info, NULL, NULL, &self, NULL));
+  struct volume* volume = NULL;
+  if (napi_unwrap(env, self, (void**) &volume) != napi_ok) {
+    THROW(env, "bad arguments, expected: ()");
+  }
+  // Stripes being encoded are not dirty unless they have been marked again:
+  napi_value count;
+  OK(napi_create_double(env, (double) volume->dirtyCount, &count));
+  return count;
+}
+
+static napi_value volume_flush(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_value self;
+  OK(napi_get_cb_info(env, info, &argc, argv, &self, NULL));
+  struct volume* volume = NULL;
+  napi_valuetype callback_type;
+  if (
+    napi_unwrap(env, self, (void**) &volume) != napi_ok ||
+    argc != 1 ||
+    napi_typeof(env, argv[0], &callback_type) != napi_ok ||
+    callback_type != napi_function
+  ) {
+    THROW(env, "bad arguments, expected: (function end)");
+  }
+  assert(volume != NULL);
+  // End is called once no stripe is dirty, including stripes marked after
+  // flush() (and while the flush drains):
+  napi_value flushes;
+  OK(napi_get_reference_value(env, volume->ref_flushes, &flushes));
+  OK(napi_set_element(env, flushes, volume->flushes, argv[0]));
+  if (volume->flushes++ > 0) return NULL;
+  // Keep the volume (and its buffers) alive while flushes are waiting:
+  OK(napi_reference_ref(env, volume->ref_self, NULL));
+  volume_fill(env, volume);
+  // A clean volume still completes asynchronously, through an empty run:
+  if (volume->busy == 0) volume_dispatch(env, volume, 0, 0);
+  return NULL;
+}
+
+static napi_value createVolume(napi_env env, napi_callback_info info) {
+  size_t argc = 5;
+  napi_value argv[5];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* context = NULL;
+  uint32_t contextLength = 0;
+  uint32_t shardSize = 0;
+  uint8_t* buffer = NULL;
+  uint64_t bufferLength = 0;
+  uint8_t* parity = NULL;
+  uint64_t parityLength = 0;
+  uint32_t concurrency = 0;
+  if (
+    argc != 5 ||
+    !arg_buf(env, argv[0], &context, &contextLength) ||
+    !arg_int(env, argv[1], &shardSize) ||
+    !arg_bytes(env, argv[2], &buffer, &bufferLength) ||
+    !arg_bytes(env, argv[3], &parity, &parityLength) ||
+    !arg_int(env, argv[4], &concurrency)
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, int shardSize, "
+      "Buffer buffer, Buffer parity, int concurrency)"
+    );
+  }
+  const char* error = reed_solomon_check_context(context, contextLength);
+  if (error) THROW(env, error);
+  if (shardSize == 0) THROW(env, "shardSize == 0");
+  if (shardSize % 8 != 0) THROW(env, "shardSize % 8 != 0");
+  if (shardSize % (8 * reed_solomon_substripes(context, contextLength)) != 0) {
+    THROW(env, "shardSize % 16 != 0");
+  }
+  if (shardSize > 4294967288) THROW(env, "shardSize > 4294967288");
+  if (bufferLength == 0) THROW(env, "buffer.length == 0");
+  const int k = context[1];
+  const int m = context[2];
+  const uint64_t stripes = (bufferLength + (uint64_t) shardSize * k - 1) /
+    ((uint64_t) shardSize * k);
+  if (parityLength / m / shardSize < stripes) {
+    THROW(env, "parity.length < stripes * m * shardSize");
+  }
+  if (concurrency < 1) THROW(env, "concurrency < 1");
+  if (concurrency > VOLUME_MAX_CONCURRENCY) {
+    THROW(env, "concurrency > VOLUME_MAX_CONCURRENCY");
+  }
+  struct volume* volume = calloc(1, sizeof(struct volume));
+  if (!volume) THROW(env, "insufficient memory");
+  const uint64_t words = (stripes + 63) / 64;
+  volume->dirty = calloc(words, sizeof(uint64_t));
+  volume->running = calloc(words, sizeof(uint64_t));
+  volume->works = calloc(concurrency, sizeof(struct volume_work));
+  if (!volume->dirty || !volume->running || !volume->works) {
+    free(volume->dirty);
+    free(volume->running);
+    free(volume->works);
+    free(volume);
+    THROW(env, "insufficient memory");
+  }
+  volume->context = context;
+  volume->contextSize = contextLength;
+  volume->buffer = buffer;
+  volume->bufferSize = bufferLength;
+  volume->parity = parity;
+  volume->shardSize = shardSize;
+  volume->stripes = stripes;
+  volume->concurrency = concurrency;
+  napi_value name;
+  OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+  for (uint32_t index = concurrency; index-- > 0;) {
+    struct volume_work* work = &volume->works[index];
+    work->volume = volume;
+    OK(napi_create_async_work(
+      env,
+      NULL,
+      name,
+      volume_execute,
+      volume_complete,
+      work,
+      &work->async_work
+    ));
+    work->next = volume->free;
+    volume->free = work;
+  }
+  napi_value object;
+  OK(napi_create_object(env, &object));
+  napi_value flushes;
+  OK(napi_create_array(env, &flushes));
+  OK(napi_create_reference(env, argv[0], 1, &volume->ref_context));
+  OK(napi_create_reference(env, argv[2], 1, &volume->ref_buffer));
+  OK(napi_create_reference(env, argv[3], 1, &volume->ref_parity));
+  OK(napi_create_reference(env, flushes, 1, &volume->ref_flushes));
+  OK(napi_wrap(env, object, volume, volume_finalize, NULL, NULL));
+  OK(napi_create_reference(env, object, 0, &volume->ref_self));
+  set_method(env, object, "mark", volume_mark);
+  set_method(env, object, "dirty", volume_dirty);
+  set_method(env, object, "flush", volume_flush);
+  return object;
+}
+
+// Stripes are read and written in batches of about this many bytes of data:
+#define FILE_BATCH_SIZE 4194304
+
+struct file_task {
+  uint8_t* context;
+  uint32_t contextSize;
+  uint32_t sources;
+  uint32_t targets;
+  uint32_t shardSize;
+  int fd;
+  uint64_t fdOffset;
+  uint64_t fdSize;
+  int parityFds[MAX_M];
+  uint64_t parityOffset;
+  int error; // A libuv error code, or 0.
+  const char* syscall;
+  napi_ref ref_context;
+  napi_ref ref_callback;
+  napi_async_work async_work;
+};
+
+#ifndef _WIN32
+
+struct file_region {
+  uint8_t* data;
+  void* base;
+  size_t baseSize;
+  int mapped;
+};
+
+static int file_fail(struct file_task* task, const char* syscall, int error) {
+  if (task->error == 0) {
+    task->error = error;
+    task->syscall = syscall;
+  }
+  return 0;
+}
+
+static void file_advise(
+  const int fd,
+  const uint64_t offset,
+  const size_t size
+) {
+  // Advise the kernel to read ahead the next batch while we encode this batch
+  // (there is no second buffer, so a batch read by pread() does not overlap):
+  #ifdef POSIX_FADV_WILLNEED
+    if (size > 0) {
+      posix_fadvise(fd, (off_t) offset, (off_t) size, POSIX_FADV_WILLNEED);
+    }
+  #endif
+}
+
+static int file_read(
+  struct file_task* task,
+  const int fd,
+  uint8_t* buffer,
+  size_t size,
+  uint64_t offset
+) {
+  while (size > 0) {
+    ssize_t bytes = pread(fd, buffer, size, (off_t) offset);
+    if (bytes < 0 && errno == EINTR) continue;
+    if (bytes < 0) {
+      return file_fail(task, "pread", uv_translate_sys_error(errno));
+    }
+    if (bytes == 0) return file_fail(task, "pread", UV_EOF);
+    buffer += bytes;
+    size -= bytes;
+    offset += bytes;
+  }
+  return 1;
+}
+
+static int file_write(
+  struct file_task* task,
+  const int fd,
+  const uint8_t* buffer,
+  size_t size,
+  uint64_t offset
+) {
+  while (size > 0) {
+    ssize_t bytes = pwrite(fd, buffer, size, (off_t) offset);
+    if (bytes < 0 && errno == EINTR) continue;
+    if (bytes < 0) {
+      return file_fail(task, "pwrite", uv_translate_sys_error(errno));
+    }
+    buffer += bytes;
+    size -= bytes;
+    offset += bytes;
+  }
+  return 1;
+}
+
+static int file_map(
+  struct file_task* task,
+  const int fd,
+  const uint64_t offset,
+  const size_t size,
+  struct file_region* region
+) {
+  // Map a read-only region of a regular file to avoid copying the page cache.
+  // Fall back to pread() for other files, or when the file is too short (where
+  // touching a mapping beyond the end of the file would raise SIGBUS):
+  region->data = NULL;
+  region->base = NULL;
+  region->baseSize = 0;
+  region->mapped = 0;
+  if (size == 0) return 1;
+  struct stat st;
+  if (
+    fstat(fd, &st) == 0 &&
+    S_ISREG(st.st_mode) &&
+    (uint64_t) st.st_size >= offset + size
+  ) {
+    const uint64_t page = (uint64_t) sysconf(_SC_PAGESIZE);
+    const uint64_t aligned = offset - (offset % page);
+    region->baseSize = (size_t) (offset - aligned) + size;
+    region->base = mmap(
+      NULL,
+      region->baseSize,
+      PROT_READ,
+      MAP_SHARED,
+      fd,
+      (off_t) aligned
+    );
+    if (region->base != MAP_FAILED) {
+      region->data = (uint8_t*) region->base + (offset - aligned);
+      region->mapped = 1;
+      return 1;
+    }
+    region->base = NULL;
+  }
+  region->baseSize = size;
+  region->base = malloc(size);
+  if (!region->base) return file_fail(task, "malloc", UV_ENOMEM);
+  region->data = region->base;
+  return file_read(task, fd, region->data, size, offset);
+}
+
+static void file_unmap(struct file_region* region) {
+  if (region->base == NULL) return;
+  if (region->mapped) {
+    munmap(region->base, region->baseSize);
+  } else {
+    free(region->base);
+  }
+  region->base = NULL;
+  region->data = NULL;
+}
+
+static void file_stripes(
+  struct file_task* task,
+  const int k,
+  const int m,
+  uint8_t** scratch,
+  const uint64_t first,
+  const uint64_t count
+) {
+  const uint32_t shardSize = task->shardSize;
+  const uint64_t stripeSize = (uint64_t) k * shardSize;
+  const uint64_t dataOffset = task->fdOffset + first * stripeSize;
+  // The last stripe may be short and is padded virtually with zeroes:
+  uint64_t dataSize = task->fdSize - first * stripeSize;
+  if (dataSize > count * stripeSize) dataSize = count * stripeSize;
+  const uint64_t parityOffset = task->parityOffset + first * shardSize;
+  const uint64_t paritySize = count * shardSize;
+  struct file_region data;
+  struct file_region parity[MAX_M];
+  for (int j = 0; j < m; j++) parity[j].base = NULL;
+  if (!file_map(
+    task,
+    task->fd,
+    dataOffset,
+    (task->sources & ((1 << k) - 1)) ? (size_t) dataSize : 0,
+    &data
+  )) {
+    goto unmap;
+  }
+  for (int j = 0; j < m; j++) {
+    if (!file_map(
+      task,
+      task->parityFds[j],
+      parityOffset,
+      (task->sources & (1 << (k + j))) ? (size_t) paritySize : 0,
+      &parity[j]
+    )) {
+      goto unmap;
+    }
+  }
+  // Advise the kernel to read ahead the next batch:
+  if (data.base) {
+    file_advise(task->fd, dataOffset + dataSize, (size_t) (count * stripeSize));
+  }
+  for (int j = 0; j < m; j++) {
+    if (parity[j].base) {
+      file_advise(task->parityFds[j], parityOffset + paritySize, paritySize);
+    }
+  }
+  for (uint64_t s = 0; s < count; s++) {
+    uint8_t* shards[MAX_K + MAX_M];
+    uint32_t shardLengths[MAX_K + MAX_M];
+    for (int i = 0; i < k; i++) {
+      const uint64_t offset = s * stripeSize + (uint64_t) i * shardSize;
+      shardLengths[i] = 0;
+      if (offset < dataSize) {
+        shardLengths[i] = dataSize - offset < shardSize ?
+          (uint32_t) (dataSize - offset) : shardSize;
+      }
+      if (task->sources & (1 << i)) {
+        shards[i] = data.data + offset;
+      } else {
+        shards[i] = scratch[i] + s * shardSize;
+      }
+    }
+    for (int j = 0; j < m; j++) {
+      shardLengths[k + j] = shardSize;
+      if (task->sources & (1 << (k + j))) {
+        shards[k + j] = parity[j].data + s * shardSize;
+      } else {
+        shards[k + j] = scratch[k + j] + s * shardSize;
+      }
+    }
+    reed_solomon_encode_range(
+      task->context,
+      task->contextSize,
+      task->sources,
+      task->targets,
+      shards,
+      shardLengths,
+      shardSize,
+      0,
+      shardSize
+    );
+    for (int i = 0; i < k; i++) {
+      if (!(task->targets & (1 << i)) || shardLengths[i] == 0) continue;
+      if (!file_write(
+        task,
+        task->fd,
+        shards[i],
+        shardLengths[i],
+        dataOffset + s * stripeSize + (uint64_t) i * shardSize
+      )) {
+        goto unmap;
+      }
+    }
+  }
+  for (int j = 0; j < m; j++) {
+    if (!(task->targets & (1 << (k + j)))) continue;
+    if (!file_write(
+      task,
+      task->parityFds[j],
+      scratch[k + j],
+      (size_t) paritySize,
+      parityOffset
+    )) {
+      goto unmap;
+    }
+  }
+unmap:
+  file_unmap(&data);
+  for (int j = 0; j < m; j++) file_unmap(&parity[j]);
+}
+
+void file_execute(napi_env env, void* data) {
+  struct file_task* task = data;
+  const int k = task->context[1];
+  const int m = task->context[2];
+  assert(task->shardSize > 0);
+  assert(task->shardSize % 8 == 0);
+  const uint64_t stripeSize = (uint64_t) k * task->shardSize;
+  const uint64_t stripes = (task->fdSize + stripeSize - 1) / stripeSize;
+  uint64_t batch = FILE_BATCH_SIZE / stripeSize;
+  if (batch == 0) batch = 1;
+  if (batch > stripes) batch = stripes;
+  // Shards which are not sources are encoded into scratch (even if they are not
+  // targets, since decoding may need to recover them along the way):
+  uint8_t* scratch[MAX_K + MAX_M];
+  for (int i = 0; i < k + m; i++) {
+    scratch[i] = NULL;
+    if (task->sources & (1 << i)) continue;
+    if (batch == 0) continue;
+    scratch[i] = malloc((size_t) (batch * task->shardSize));
+    if (!scratch[i]) {
+      file_fail(task, "malloc", UV_ENOMEM);
+      goto free;
+    }
+  }
+  for (uint64_t first = 0; first < stripes; first += batch) {
+    const uint64_t count = stripes - first < batch ? stripes - first : batch;
+    file_stripes(task, k, m, scratch, first, count);
+    if (task->error) break;
+  }
+free:
+  for (int i = 0; i < k + m; i++) free(scratch[i]);
+}
+
+#else
+
+void file_execute(napi_env env, void* data) {
+  struct file_task* task = data;
+  task->error = UV_ENOSYS;
+  task->syscall = "encodeFile";
+}
+
+#endif
+
+void file_complete(napi_env env, napi_status status, void* data) {
+  struct file_task* task = data;
+  assert(status == napi_ok);
+  napi_value scope;
+  OK(napi_get_global(env, &scope));
+  napi_value callback;
+  OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  napi_value argv[1];
+  size_t argc = 0;
+  if (task->error) {
+    char message[256];
+    snprintf(
+      message,
+      sizeof(message),
+      "%s: %s, %s",
+      uv_err_name(task->error),
+      uv_strerror(task->error),
+      task->syscall
+    );
+    napi_value code;
+    napi_value string;
+    OK(napi_create_string_utf8(
+      env,
+      uv_err_name(task->error),
+      NAPI_AUTO_LENGTH,
+      &code
+    ));
+    OK(napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &string));
+    OK(napi_create_error(env, code, string, &argv[0]));
+    argc = 1;
+  }
+  // Do not assert the return status of napi_call_function():
+  // If the callback throws then the return status will not be napi_ok.
+  napi_call_function(env, scope, callback, argc, argv, NULL);
   OK(napi_delete_reference(env, task->ref_context));
-  OK(napi_delete_reference(env, task->ref_buffer));
-  OK(napi_delete_reference(env, task->ref_parity));
   OK(napi_delete_reference(env, task->ref_callback));
   OK(napi_delete_async_work(env, task->async_work));
   free(task);
   task = NULL;
 }
 
-static napi_value create(napi_env env, napi_callback_info info) {
-  size_t argc = 2;
-  napi_value argv[2];
+static napi_value file_queue(
+  napi_env env,
+  napi_value context_value,
+  napi_value callback_value,
+  struct file_task* task
+) {
+  // Takes ownership of task, which must have been allocated with calloc():
+  const char* error = reed_solomon_check_context(
+    task->context,
+    task->contextSize
+  );
+  if (!error) {
+    const int k = task->context[1];
+    const int m = task->context[2];
+    error = reed_solomon_check_flags(
+      task->context,
+      task->contextSize,
+      task->sources,
+      task->targets
+    );
+    if (!error && task->shardSize == 0) error = "shardSize == 0";
+    if (!error && task->shardSize % 8 != 0) error = "shardSize % 8 != 0";
+    if (
+      !error &&
+      task->shardSize % (8 * reed_solomon_substripes(task->context,
+        task->contextSize)) != 0
+    ) {
+      error = "shardSize % 16 != 0";
+    }
+    for (int j = 0; !error && j < m; j++) {
+      if (
+        task->parityFds[j] < 0 &&
+        ((task->sources | task->targets) & (1 << (k + j)))
+      ) {
+        error = "parityFds[j] < 0";
+      }
+    }
+    if (!error && task->fd < 0) error = "fd < 0";
+  }
+  if (error) {
+    free(task);
+    THROW(env, error);
+  }
+  OK(napi_create_reference(env, context_value, 1, &task->ref_context));
+  OK(napi_create_reference(env, callback_value, 1, &task->ref_callback));
+  napi_value name;
+  OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
+  OK(napi_create_async_work(
+    env,
+    NULL,
+    name,
+    file_execute,
+    file_complete,
+    task,
+    &task->async_work
+  ));
+  OK(napi_queue_async_work(env, task->async_work));
+  return NULL;
+}
+
+static napi_value encodeFile(napi_env env, napi_callback_info info) {
+  size_t argc = 8;
+  napi_value argv[8];
   OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
-  uint32_t ku = 0;
-  uint32_t mu = 0;
-  if (argc != 2 || !arg_int(env, argv[0], &ku) || !arg_int(env, argv[1], &mu)) {
-    THROW(env, "bad arguments, expected: (int k, int m)");
+  struct file_task* task = calloc(1, sizeof(struct file_task));
+  if (!task) THROW(env, "insufficient memory");
+  uint32_t fd = 0;
+  napi_valuetype callback_type;
+  if (
+    argc != 8 ||
+    !arg_buf(env, argv[0], &task->context, &task->contextSize) ||
+    !arg_int(env, argv[1], &task->shardSize) ||
+    !arg_int(env, argv[2], &fd) ||
+    fd > INT_MAX ||
+    !arg_offset(env, argv[3], &task->fdOffset) ||
+    !arg_offset(env, argv[4], &task->fdSize) ||
+    task->contextSize < 3 ||
+    task->context[2] < 1 ||
+    task->context[2] > MAX_M ||
+    !arg_fds(env, argv[5], task->parityFds, task->context[2]) ||
+    !arg_offset(env, argv[6], &task->parityOffset) ||
+    napi_typeof(env, argv[7], &callback_type) != napi_ok ||
+    callback_type != napi_function
+  ) {
+    free(task);
+    THROW(
+      env,
+      "bad arguments, expected: (Buffer context, int shardSize, "
+      "int fd, int fdOffset, int fdSize, "
+      "Array parityFds, int parityOffset, function end)"
+    );
   }
-  if (ku < 1) THROW(env, "k < 1");
-  if (ku > MAX_K) THROW(env, "k > MAX_K");
-  if (mu < 1) THROW(env, "m < 1");
-  if (mu > MAX_M) THROW(env, "m > MAX_M");
-  assert(MAX_K <= INT_MAX);
-  assert(MAX_M <= INT_MAX);
-  int k = (int) ku;
-  int m = (int) mu;
-  assert(sizeof(PARAMETERS) == MAX_K * MAX_M * 7 * sizeof(int));
-  assert(PARAMETERS[k - 1][m - 1][0] == k);
-  assert(PARAMETERS[k - 1][m - 1][1] == m);
-  int w = PARAMETERS[k - 1][m - 1][2];
-  assert(w <= MAX_W);
-  assert(w == 2 || w == 4 || w == 8);
-  assert(k + m <= (1 << w));
-  int p = PARAMETERS[k - 1][m - 1][3];
-  int x = PARAMETERS[k - 1][m - 1][4];
-  int y = PARAMETERS[k - 1][m - 1][5];
-  if (m <= 2) {
-    assert(x == -1);
-    assert(y == -1);
-  } else {
-    assert(y != x);
-  }
-  int b = PARAMETERS[k - 1][m - 1][6];
-  assert(b >= 1);
-  assert(b <= k * w * m * w);
-  int log[1 << MAX_W];
-  int exp[1 << MAX_W];
-  int bit[1 << MAX_W];
-  int min[1 << MAX_W];
-  create_tables(w, p, log, exp, bit, min);
-  uint8_t matrix[MAX_K * MAX_M];
-  assert(create_matrix(log, exp, bit, min, w, k, m, x, y, matrix) == b);
-  size_t contextSize = 3 + k * w * m * w;
-  uint8_t* context = NULL;
-  napi_value buffer = NULL;
-  OK(napi_create_buffer(env, contextSize, (void**) &context, &buffer));
-  assert(context != NULL);
-  assert(buffer != NULL);
-  context[0] = w;
-  context[1] = k;
-  context[2] = m;
-  uint8_t* bitmatrix = context + 3;
-  assert(create_bitmatrix_encoding(log, exp, w, k, m, matrix, bitmatrix) == b);
-  assert(bitmatrix_m0_optimized(w, k, bitmatrix) == 1);
-  return buffer;
+  task->fd = (int) fd;
+  // Encode all parity shards from all data shards:
+  const int k = task->context[1];
+  const int m = task->context[2];
+  if (k >= 1 && k <= MAX_K) {
+    task->sources = ((uint32_t) 1 << k) - 1;
+    task->targets = (((uint32_t) 1 << m) - 1) << k;
+  }
+  return file_queue(env, argv[0], argv[7], task);
 }
 
-static napi_value encode(napi_env env, napi_callback_info info) {
+static napi_value repairFile(napi_env env, napi_callback_info info) {
   size_t argc = 10;
   napi_value argv[10];
   OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
-  uint8_t* context = NULL;
-  uint32_t contextLength = 0;
-  uint32_t sources = 0;
-  uint32_t targets = 0;
-  uint8_t* buffer = NULL;
-  uint32_t bufferLength = 0;
-  uint32_t bufferOffset = 0;
-  uint32_t bufferSize = 0;
-  uint8_t* parity = NULL;
-  uint32_t parityLength = 0;
-  uint32_t parityOffset = 0;
-  uint32_t paritySize = 0;
+  struct file_task* task = calloc(1, sizeof(struct file_task));
+  if (!task) THROW(env, "insufficient memory");
+  uint32_t fd = 0;
   napi_valuetype callback_type;
-  OK(napi_typeof(env, argv[9], &callback_type));
   if (
     argc != 10 ||
-    !arg_buf(env, argv[0], &context, &contextLength) ||
-    !arg_int(env, argv[1], &sources) ||
-    !arg_int(env, argv[2], &targets) ||
-    !arg_buf(env, argv[3], &buffer, &bufferLength) ||
-    !arg_int(env, argv[4], &bufferOffset) ||
-    !arg_int(env, argv[5], &bufferSize) ||
-    !arg_buf(env, argv[6], &parity, &parityLength) ||
-    !arg_int(env, argv[7], &parityOffset) ||
-    !arg_int(env, argv[8], &paritySize) ||
+    !arg_buf(env, argv[0], &task->context, &task->contextSize) ||
+    !arg_int(env, argv[1], &task->sources) ||
+    !arg_int(env, argv[2], &task->targets) ||
+    !arg_int(env, argv[3], &task->shardSize) ||
+    !arg_int(env, argv[4], &fd) ||
+    fd > INT_MAX ||
+    !arg_offset(env, argv[5], &task->fdOffset) ||
+    !arg_offset(env, argv[6], &task->fdSize) ||
+    task->contextSize < 3 ||
+    task->context[2] < 1 ||
+    task->context[2] > MAX_M ||
+    !arg_fds(env, argv[7], task->parityFds, task->context[2]) ||
+    !arg_offset(env, argv[8], &task->parityOffset) ||
+    napi_typeof(env, argv[9], &callback_type) != napi_ok ||
     callback_type != napi_function
   ) {
+    free(task);
     THROW(
       env,
       "bad arguments, expected: (Buffer context, int sources, int targets, "
-      "Buffer buffer, int bufferOffset, int bufferSize, "
-      "Buffer parity, int parityOffset, int paritySize, function end)"
+      "int shardSize, int fd, int fdOffset, int fdSize, "
+      "Array parityFds, int parityOffset, function end)"
     );
   }
-  assert(context != NULL);
-  assert(buffer != NULL);
-  assert(parity != NULL);
-  if (contextLength < 3) THROW(env, "context.length < 3");
-  int w = (int) context[0];
-  int k = (int) context[1];
-  int m = (int) context[2];
-  if (w != 2 && w != 4 && w != 8) THROW(env, "w != 2, 4, 8");
-  if (k < 1) THROW(env, "k < 1");
-  if (k > MAX_K) THROW(env, "k > MAX_K");
-  if (m < 1) THROW(env, "m < 1");
-  if (m > MAX_M) THROW(env, "m > MAX_M");
-  if (k + m > (1 << w)) THROW(env, "k + m > (1 << w)");
-  if (contextLength != (uint32_t) (3 + k * w * m * w)) {
-    THROW(env, "context.length is bad");
-  }
-  if (bitmatrix_m0_optimized(w, k, context + 3) != 1) {
-    THROW(env, "bitmatrix not optimized");
-  }
-  assert(k + m < 31);
-  if (sources >= (uint32_t) 1 << (k + m)) THROW(env, "sources > k + m");
-  const int sourcesCount = flags_count(sources);
-  if (sourcesCount == 0) THROW(env, "sources == 0");
-  if (sourcesCount < k) THROW(env, "sources < k");
-  assert(k + m < 31);
-  if (targets >= (uint32_t) 1 << (k + m)) THROW(env, "targets > k + m");
-  const int targetsCount = flags_count(targets);
-  if (targetsCount == 0) THROW(env, "targets == 0");
-  if (targetsCount > m) THROW(env, "targets > m");
-  if ((sources & targets) != 0) THROW(env, "(sources & targets) != 0");
-  if (bufferSize == 0) THROW(env, "bufferSize == 0");
-  if ((uint64_t) bufferOffset + bufferSize > bufferLength) {
-    THROW(env, "bufferOffset + bufferSize > buffer.length");
+  task->fd = (int) fd;
+  return file_queue(env, argv[0], argv[9], task);
+}
+
+static napi_value search(napi_env env, napi_callback_info info) {
+  size_t argc = 0;
+  OK(napi_get_cb_info(env, info, &argc, NULL, NULL, NULL));
+  if (argc != 0) THROW(env, "expected no arguments");
+  reed_solomon_search();
+  return NULL;
+}
+
+// The codec takes a uint32_t size (less than 4 GB), so regions are passed to
+// reed_solomon_xor() and reed_solomon_gf_combine() in pieces of at most 1 GB:
+#define REGION_PIECE_SIZE 1073741824
+
+static napi_value XOR(napi_env env, napi_callback_info info) {
+  size_t argc = 5;
+  napi_value argv[5];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint8_t* source = NULL;
+  uint64_t sourceLength = 0;
+  uint64_t sourceOffset = 0;
+  uint8_t* target = NULL;
+  uint64_t targetLength = 0;
+  uint64_t targetOffset = 0;
+  uint64_t size = 0;
+  if (
+    argc != 5 ||
+    !arg_bytes(env, argv[0], &source, &sourceLength) ||
+    !arg_offset(env, argv[1], &sourceOffset) ||
+    !arg_bytes(env, argv[2], &target, &targetLength) ||
+    !arg_offset(env, argv[3], &targetOffset) ||
+    !arg_offset(env, argv[4], &size)
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: ("
+      "Buffer source, int sourceOffset, "
+      "Buffer target, int targetOffset, int size)"
+    );
   }
-  if (bufferSize % k != 0) THROW(env, "bufferSize % k != 0");
-  const uint32_t shardSize = bufferSize / k;
-  assert(shardSize != 0);
-  if (shardSize % w != 0) THROW(env, "shardSize % w != 0");
-  if (shardSize % 8 != 0) THROW(env, "shardSize % 8 != 0");
-  if (paritySize == 0) THROW(env, "paritySize == 0");
-  if (paritySize % m != 0) THROW(env, "paritySize % m != 0");
-  if (paritySize / m != shardSize) {
-    THROW(env, "paritySize / m != bufferSize / k");
+  assert(source != NULL);
+  assert(target != NULL);
+  if (sourceOffset + size > sourceLength) {
+    THROW(env, "sourceOffset + size > source.length");
   }
-  if ((uint64_t) parityOffset + paritySize > parityLength) {
-    THROW(env, "parityOffset + paritySize > parity.length");
+  if (targetOffset + size > targetLength) {
+    THROW(env, "targetOffset + size > target.length");
   }
-  struct task_data* task = calloc(1, sizeof(struct task_data));
-  if (!task) THROW(env, "insufficient memory");
-  task->context = context;
-  task->contextSize = contextLength;
-  task->sources = sources;
-  task->targets = targets;
-  task->buffer = buffer + bufferOffset;
-  task->bufferSize = bufferSize;
-  task->parity = parity + parityOffset;
-  task->paritySize = paritySize;
-  task->shardSize = shardSize;
-  OK(napi_create_reference(env, argv[0], 1, &task->ref_context));
-  OK(napi_create_reference(env, argv[3], 1, &task->ref_buffer));
-  OK(napi_create_reference(env, argv[6], 1, &task->ref_parity));
-  OK(napi_create_reference(env, argv[9], 1, &task->ref_callback));
+  for (uint64_t offset = 0; offset < size; offset += REGION_PIECE_SIZE) {
+    const uint64_t length = size - offset < REGION_PIECE_SIZE ?
+      size - offset : REGION_PIECE_SIZE;
+    reed_solomon_xor(
+      source + sourceOffset + offset,
+      target + targetOffset + offset,
+      (uint32_t) length
+    );
+  }
+  return NULL;
+}
+
+// Region operations over GF(2^w) for application-level codes, run on the
+// JavaScript thread if there is no end callback, and otherwise in the libuv
+// threadpool (where sources and target must not change until end is called):
+struct gf_task {
+  int w;
+  int polynomial;
+  int accumulate;
+  int count;
+  uint8_t* coefficients;
+  uint8_t** sources; // count sources, followed by count pointers of a piece.
+  uint8_t* target;
+  uint64_t size;
+  napi_ref ref_sources;
+  napi_ref ref_target;
+  napi_ref ref_callback;
+  napi_async_work async_work;
+};
+
+static void gf_execute(napi_env env, void* data) {
+  struct gf_task* task = data;
+  uint8_t** pieces = task->sources + task->count;
+  for (uint64_t offset = 0; offset < task->size; offset += REGION_PIECE_SIZE) {
+    const uint64_t length = task->size - offset < REGION_PIECE_SIZE ?
+      task->size - offset : REGION_PIECE_SIZE;
+    if (task->count == 1) {
+      reed_solomon_gf_multiply(
+        task->w,
+        task->polynomial,
+        task->coefficients[0],
+        task->sources[0] + offset,
+        task->target + offset,
+        (uint32_t) length,
+        task->accumulate
+      );
+      continue;
+    }
+    for (int index = 0; index < task->count; index++) {
+      pieces[index] = task->sources[index] + offset;
+    }
+    reed_solomon_gf_combine(
+      task->w,
+      task->polynomial,
+      task->count,
+      task->coefficients,
+      pieces,
+      task->target + offset,
+      (uint32_t) length
+    );
+  }
+}
+
+static void gf_free(struct gf_task* task) {
+  free(task->coefficients);
+  free(task->sources);
+  free(task);
+}
+
+static void gf_complete(napi_env env, napi_status status, void* data) {
+  struct gf_task* task = data;
+  assert(status == napi_ok);
+  napi_value scope;
+  OK(napi_get_global(env, &scope));
+  napi_value callback;
+  OK(napi_get_reference_value(env, task->ref_callback, &callback));
+  napi_value argv[1];
+  OK(napi_get_undefined(env, &argv[0]));
+  // Do not assert the return status of napi_call_function():
+  // If the callback throws then the return status will not be napi_ok.
+  napi_call_function(env, scope, callback, 1, argv, NULL);
+  OK(napi_delete_reference(env, task->ref_sources));
+  OK(napi_delete_reference(env, task->ref_target));
+  OK(napi_delete_reference(env, task->ref_callback));
+  OK(napi_delete_async_work(env, task->async_work));
+  gf_free(task);
+}
+
+static napi_value gf_run(
+  napi_env env,
+  struct gf_task* task,
+  napi_value sources,
+  napi_value target,
+  napi_value end
+) {
+  // Runs a task now if end is NULL, else queues it (and owns the task):
+  if (end == NULL) {
+    gf_execute(env, task);
+    gf_free(task);
+    return NULL;
+  }
+  OK(napi_create_reference(env, sources, 1, &task->ref_sources));
+  OK(napi_create_reference(env, target, 1, &task->ref_target));
+  OK(napi_create_reference(env, end, 1, &task->ref_callback));
   napi_value name;
   OK(napi_create_string_utf8(env, RESOURCE_NAME, NAPI_AUTO_LENGTH, &name));
   OK(napi_create_async_work(
     env,
     NULL,
     name,
-    task_execute,
-    task_complete,
+    gf_execute,
+    gf_complete,
     task,
     &task->async_work
   ));
@@ -1149,160 +3394,440 @@ static napi_value encode(napi_env env, napi_callback_info info) {
   return NULL;
 }
 
-static napi_value search(napi_env env, napi_callback_info info) {
-  size_t argc = 0;
-  OK(napi_get_cb_info(env, info, &argc, NULL, NULL, NULL));
-  if (argc != 0) THROW(env, "expected no arguments");
-  const int kl = 24;
-  const int ks[] = {
-     1,  2,  3,  4,  5,  6,  7,  8,  9, 10,
-    11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
-    21, 22, 23, 24
-  };
-  const int ml = 6;
-  const int ms[] = { 1, 2, 3, 4, 5, 6 };
-  const int wl = 3;
-  const int ws[] = { 2, 4, 8 };
-  const int pl2 = 1;
-  const int ps2[] = { 7 };
-  const int pl4 = 1;
-  const int ps4[] = { 19 };
-  const int pl8 = 16;
-  const int ps8[] = {
-     29,  43,  45,  77,  95,  99, 101, 105,
-    113, 135, 141, 169, 195, 207, 231, 245
-  };
-  const int pl[] = { pl2, pl4, pl8 };
-  const int* ps[] = { ps2, ps4, ps8 };
-  int log[256];
-  int exp[256];
-  int bit[256];
-  int min[256];
-  uint8_t matrix[65536];
-  printf("static const int PARAMETERS[%i][%i][7] = {\n", kl, ml);
-  for (int ki = 0; ki < kl; ki++) {
-    int k = ks[ki];
-    assert(k >= 1);
-    assert(k <= 24);
-    printf("  {\n");
-    for (int mi = 0; mi < ml; mi++) {
-      int m = ms[mi];
-      assert(m >= 1);
-      assert(m <= 6);
-      int minB = -1;
-      int minW = -1;
-      int minP = -1;
-      int minX = -1;
-      int minY = -1;
-      for (int wi = 0; wi < wl; wi++) {
-        int w = ws[wi];
-        assert(w <= MAX_W);
-        assert(w == 2 || w == 4 || w == 8);
-        if (k + m > (1 << w)) continue;
-        for (int pi = 0; pi < pl[wi]; pi++) {
-          int p = ps[wi][pi];
-          assert(p >= 1);
-          create_tables(w, p, log, exp, bit, min);
-          if (m <= 2) {
-            int x = -1;
-            int y = -1;
-            int b = create_matrix(log, exp, bit, min, w, k, m, x, y, matrix);
-            if (b < minB || minB == -1) {
-              minB = b;
-              minW = w;
-              minP = p;
-              minX = -1;
-              minY = -1;
-            }
-            continue;
-          }
-          int z = (1 << w);
-          for (int x = 0; x + k <= z; x++) {
-            for (int y = 0; y + m <= z; y++) {
-              if (x == y) continue;
-              if (x < y && (x + k) > y) continue;
-              if (y < x && (y + m) > x) continue;
-              int b = create_matrix(log, exp, bit, min, w, k, m, x, y, matrix);
-              if (b < minB || minB == -1) {
-                minB = b;
-                minW = w;
-                minP = p;
-                minX = x;
-                minY = y;
-              }
-            }
-          }
-        }
-      }
-      printf(
-        "    { %2i, %1i, %1i, %3i, %3i, %3i, %4i }",
-        k, m, minW, minP, minX, minY, minB
-      );
-      printf(mi < ml - 1 ? ",\n" : "\n");
-    }
-    printf(ki < kl - 1 ? "  },\n" : "  }\n");
+static int arg_end(napi_env env, napi_value* argv, size_t argc, size_t index) {
+  // An optional end callback after index arguments:
+  if (argc == index) return 1;
+  napi_valuetype type;
+  return argc == index + 1 &&
+    napi_typeof(env, argv[index], &type) == napi_ok &&
+    type == napi_function;
+}
+
+static const char* check_field(const uint32_t w, const uint32_t polynomial) {
+  if (w > MAX_W) return "w != 2, 4, 8";
+  if (polynomial >= (1U << (MAX_W + 1))) return "polynomial >= (1 << (w + 1))";
+  return reed_solomon_gf_check((int) w, (int) polynomial);
+}
+
+static struct gf_task* gf_task_create(const int count) {
+  struct gf_task* task = calloc(1, sizeof(struct gf_task));
+  if (!task) return NULL;
+  task->count = count;
+  task->coefficients = calloc(count, 1);
+  task->sources = calloc(count * 2, sizeof(uint8_t*));
+  if (!task->coefficients || !task->sources) {
+    gf_free(task);
+    return NULL;
   }
-  printf("};\n");
-  return NULL;
+  return task;
 }
 
-static napi_value XOR(napi_env env, napi_callback_info info) {
-  size_t argc = 5;
-  napi_value argv[5];
+static napi_value gf_multiply(
+  napi_env env,
+  napi_callback_info info,
+  const int accumulate
+) {
+  size_t argc = 9;
+  napi_value argv[9];
   OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t w = 0;
+  uint32_t polynomial = 0;
+  uint32_t c = 0;
   uint8_t* source = NULL;
-  uint32_t sourceLength = 0;
-  uint32_t sourceOffset = 0;
+  uint64_t sourceLength = 0;
+  uint64_t sourceOffset = 0;
   uint8_t* target = NULL;
-  uint32_t targetLength = 0;
-  uint32_t targetOffset = 0;
-  uint32_t size = 0;
+  uint64_t targetLength = 0;
+  uint64_t targetOffset = 0;
+  uint64_t size = 0;
   if (
-    argc != 5 ||
-    !arg_buf(env, argv[0], &source, &sourceLength) ||
-    !arg_int(env, argv[1], &sourceOffset) ||
-    !arg_buf(env, argv[2], &target, &targetLength) ||
-    !arg_int(env, argv[3], &targetOffset) ||
-    !arg_int(env, argv[4], &size)
+    argc < 8 ||
+    !arg_int(env, argv[0], &w) ||
+    !arg_int(env, argv[1], &polynomial) ||
+    !arg_int(env, argv[2], &c) ||
+    !arg_bytes(env, argv[3], &source, &sourceLength) ||
+    !arg_offset(env, argv[4], &sourceOffset) ||
+    !arg_bytes(env, argv[5], &target, &targetLength) ||
+    !arg_offset(env, argv[6], &targetOffset) ||
+    !arg_offset(env, argv[7], &size) ||
+    !arg_end(env, argv, argc, 8)
   ) {
     THROW(
       env,
-      "bad arguments, expected: ("
+      "bad arguments, expected: (int w, int polynomial, int c, "
       "Buffer source, int sourceOffset, "
-      "Buffer target, int targetOffset, int size)"
+      "Buffer target, int targetOffset, int size, [function end])"
     );
   }
-  assert(source != NULL);
-  assert(target != NULL);
-  if ((uint64_t) sourceOffset + size > sourceLength) {
+  const char* error = check_field(w, polynomial);
+  if (error) THROW(env, error);
+  if (c >= (1U << w)) THROW(env, "c >= (1 << w)");
+  if (sourceOffset + size > sourceLength) {
     THROW(env, "sourceOffset + size > source.length");
   }
-  if ((uint64_t) targetOffset + size > targetLength) {
+  if (targetOffset + size > targetLength) {
     THROW(env, "targetOffset + size > target.length");
   }
-  if (size > 0) dot_xor(source + sourceOffset, target + targetOffset, size);
-  return NULL;
+  source += sourceOffset;
+  target += targetOffset;
+  if (
+    source != target &&
+    source < target + size &&
+    target < source + size
+  ) {
+    THROW(env, "source overlaps target");
+  }
+  struct gf_task* task = gf_task_create(1);
+  if (!task) THROW(env, "insufficient memory");
+  task->w = (int) w;
+  task->polynomial = (int) polynomial;
+  task->accumulate = accumulate;
+  task->coefficients[0] = (uint8_t) c;
+  task->sources[0] = source;
+  task->target = target;
+  task->size = size;
+  return gf_run(env, task, argv[3], argv[5], argc == 9 ? argv[8] : NULL);
 }
 
-static napi_value Init(napi_env env, napi_value exports) {
-  // We require assert() for safety (our asserts are not side-effect free):
-  #ifdef NDEBUG
-    fprintf(stderr, "NDEBUG compile flag not supported\n");
-    abort();
+static napi_value gfMultiply(napi_env env, napi_callback_info info) {
+  return gf_multiply(env, info, 0);
+}
+
+static napi_value gfMultiplyXOR(napi_env env, napi_callback_info info) {
+  return gf_multiply(env, info, 1);
+}
+
+static napi_value gfCombine(napi_env env, napi_callback_info info) {
+  size_t argc = 8;
+  napi_value argv[8];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t w = 0;
+  uint32_t polynomial = 0;
+  bool is_array = 0;
+  uint32_t count = 0;
+  uint32_t sourcesLength = 0;
+  uint8_t* target = NULL;
+  uint64_t targetLength = 0;
+  uint64_t targetOffset = 0;
+  uint64_t size = 0;
+  if (
+    argc < 7 ||
+    !arg_int(env, argv[0], &w) ||
+    !arg_int(env, argv[1], &polynomial) ||
+    napi_is_array(env, argv[2], &is_array) != napi_ok || !is_array ||
+    napi_get_array_length(env, argv[2], &count) != napi_ok ||
+    napi_is_array(env, argv[3], &is_array) != napi_ok || !is_array ||
+    napi_get_array_length(env, argv[3], &sourcesLength) != napi_ok ||
+    !arg_bytes(env, argv[4], &target, &targetLength) ||
+    !arg_offset(env, argv[5], &targetOffset) ||
+    !arg_offset(env, argv[6], &size) ||
+    !arg_end(env, argv, argc, 7)
+  ) {
+    THROW(
+      env,
+      "bad arguments, expected: (int w, int polynomial, "
+      "Array coefficients, Array sources, "
+      "Buffer target, int targetOffset, int size, [function end])"
+    );
+  }
+  const char* error = check_field(w, polynomial);
+  if (error) THROW(env, error);
+  if (count == 0) THROW(env, "coefficients.length == 0");
+  if (count > 65536) THROW(env, "coefficients.length > 65536");
+  if (sourcesLength != count) {
+    THROW(env, "sources.length != coefficients.length");
+  }
+  if (targetOffset + size > targetLength) {
+    THROW(env, "targetOffset + size > target.length");
+  }
+  target += targetOffset;
+  struct gf_task* task = gf_task_create((int) count);
+  if (!task) THROW(env, "insufficient memory");
+  task->w = (int) w;
+  task->polynomial = (int) polynomial;
+  task->target = target;
+  task->size = size;
+  // Sources are each read from their start, and are copied to an array of our
+  // own, which the caller cannot change before end:
+  napi_value sources;
+  OK(napi_create_array_with_length(env, count, &sources));
+  for (uint32_t index = 0; index < count; index++) {
+    napi_value element;
+    OK(napi_get_element(env, argv[2], index, &element));
+    uint32_t coefficient = 0;
+    if (!arg_int(env, element, &coefficient) || coefficient >= (1U << w)) {
+      gf_free(task);
+      THROW(env, "coefficient >= (1 << w)");
+    }
+    task->coefficients[index] = (uint8_t) coefficient;
+    OK(napi_get_element(env, argv[3], index, &element));
+    uint8_t* source = NULL;
+    uint64_t sourceLength = 0;
+    if (!arg_bytes(env, element, &source, &sourceLength)) {
+      gf_free(task);
+      THROW(env, "source must be a Buffer");
+    }
+    if (size > sourceLength) {
+      gf_free(task);
+      THROW(env, "size > source.length");
+    }
+    if (source < target + size && target < source + size) {
+      gf_free(task);
+      THROW(env, "source overlaps target");
+    }
+    task->sources[index] = source;
+    OK(napi_set_element(env, sources, index, element));
+  }
+  return gf_run(env, task, sources, argv[4], argc == 8 ? argv[7] : NULL);
+}
+
+// A reusable arena of stripes, each a single external Buffer holding k data
+// shards followed by m parity shards. Stripes are rounded up to a power of 2
+// (at least 4096 bytes) and are reused through a free list per size class when
+// their Buffer is garbage collected. Size classes of at least 2 MB are mapped
+// with MAP_HUGETLB where huge pages have been reserved, and otherwise advised
+// as transparent huge pages (as are the 2 MB chunks for smaller classes).
+#define ARENA_CHUNK 2097152
+#define ARENA_CLASS_MIN 12
+#define ARENA_CLASS_MAX 35
+
+// The parity region is skewed from a 4096-byte boundary by this many bytes, so
+// that loads from data shards and stores to parity shards at the same offset
+// are not 4K aliased (data shards are contiguous and cannot be padded):
+#define ARENA_SKEW 256
+
+static struct {
+  uv_mutex_t mutex;
+  void* free[ARENA_CLASS_MAX + 1];
+  uint64_t reserved; // Bytes mapped.
+  uint64_t reservedHuge; // Bytes mapped with MAP_HUGETLB.
+  uint64_t allocated; // Bytes in stripes not yet garbage collected.
+  uint64_t allocations;
+  uint64_t reuses;
+} arena;
+
+static uv_once_t arena_once = UV_ONCE_INIT;
+
+static void arena_init(void) {
+  OK_UV(uv_mutex_init(&arena.mutex));
+}
+
+#ifndef _WIN32
+
+static void* arena_map(const size_t size) {
+  // Returns a mapping of size bytes, or NULL (the caller holds arena.mutex):
+  void* block = MAP_FAILED;
+  #ifdef MAP_HUGETLB
+    if (size >= ARENA_CHUNK) {
+      block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (block != MAP_FAILED) arena.reservedHuge += size;
+    }
+  #endif
+  if (block == MAP_FAILED) {
+    block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED) return NULL;
+    #ifdef MADV_HUGEPAGE
+      if (size >= ARENA_CHUNK) madvise(block, size, MADV_HUGEPAGE);
+    #endif
+  }
+  arena.reserved += size;
+  return block;
+}
+
+static void* arena_alloc(const int sizeClass) {
+  const size_t size = (size_t) 1 << sizeClass;
+  uv_mutex_lock(&arena.mutex);
+  void* block = arena.free[sizeClass];
+  if (block != NULL) {
+    arena.free[sizeClass] = *((void**) block);
+    arena.reuses++;
+  } else if (size >= ARENA_CHUNK) {
+    block = arena_map(size);
+  } else {
+    // Carve a chunk into blocks, keeping the first and freeing the rest:
+    uint8_t* chunk = arena_map(ARENA_CHUNK);
+    if (chunk != NULL) {
+      for (size_t offset = ARENA_CHUNK - size; offset > 0; offset -= size) {
+        *((void**) (chunk + offset)) = arena.free[sizeClass];
+        arena.free[sizeClass] = chunk + offset;
+      }
+      block = chunk;
+    }
+  }
+  if (block != NULL) {
+    arena.allocated += size;
+    arena.allocations++;
+  }
+  uv_mutex_unlock(&arena.mutex);
+  return block;
+}
+
+static void arena_free(void* block, const int sizeClass) {
+  const size_t size = (size_t) 1 << sizeClass;
+  uv_mutex_lock(&arena.mutex);
+  assert(arena.allocated >= size);
+  arena.allocated -= size;
+  *((void**) block) = arena.free[sizeClass];
+  arena.free[sizeClass] = block;
+  uv_mutex_unlock(&arena.mutex);
+}
+
+static void arena_finalize(napi_env env, void* data, void* hint) {
+  const int sizeClass = (int) (intptr_t) hint;
+  const size_t size = (size_t) 1 << sizeClass;
+  arena_free(data, sizeClass);
+  int64_t external = 0;
+  OK(napi_adjust_external_memory(env, -((int64_t) size), &external));
+}
+
+#endif
+
+static napi_value allocStripe(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  OK(napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  uint32_t k = 0;
+  uint32_t m = 0;
+  uint32_t shardSize = 0;
+  if (
+    argc != 3 ||
+    !arg_int(env, argv[0], &k) ||
+    !arg_int(env, argv[1], &m) ||
+    !arg_int(env, argv[2], &shardSize)
+  ) {
+    THROW(env, "bad arguments, expected: (int k, int m, int shardSize)");
+  }
+  if (k < 1) THROW(env, "k < 1");
+  if (k > MAX_K) THROW(env, "k > MAX_K");
+  if (m < 1) THROW(env, "m < 1");
+  if (m > MAX_M) THROW(env, "m > MAX_M");
+  if (shardSize == 0) THROW(env, "shardSize == 0");
+  const uint64_t bufferSize = (uint64_t) k * shardSize;
+  if (bufferSize > 4294967295) THROW(env, "k * shardSize > 4294967295");
+  const uint64_t paddedSize = ((uint64_t) shardSize + 7) & ~((uint64_t) 7);
+  const uint64_t paritySize = m * paddedSize;
+  // The parity region is aligned to 64 bytes (as is the data region):
+  uint64_t parityOffset = (bufferSize + 63) & ~((uint64_t) 63);
+  if (parityOffset % 4096 < ARENA_SKEW) {
+    parityOffset += ARENA_SKEW - parityOffset % 4096;
+  }
+  const uint64_t size = parityOffset + paritySize;
+  if (parityOffset > 4294967295 || paritySize > 4294967295) {
+    THROW(env, "stripe is too large");
+  }
+  int sizeClass = ARENA_CLASS_MIN;
+  while (((uint64_t) 1 << sizeClass) < size) sizeClass++;
+  assert(sizeClass <= ARENA_CLASS_MAX);
+  #ifdef _WIN32
+    THROW(env, "allocStripe() is not supported on Windows");
+  #else
+    uv_once(&arena_once, arena_init);
+    uint8_t* block = arena_alloc(sizeClass);
+    if (block == NULL) THROW(env, "insufficient memory");
+    napi_value buffer;
+    const napi_status status = napi_create_external_buffer(
+      env,
+      (size_t) size,
+      block,
+      arena_finalize,
+      (void*) (intptr_t) sizeClass,
+      &buffer
+    );
+    if (status != napi_ok) {
+      // External memory has not yet been adjusted for the block:
+      arena_free(block, sizeClass);
+      THROW(env, "external buffers are not supported");
+    }
+    int64_t external = 0;
+    OK(napi_adjust_external_memory(
+      env,
+      (int64_t) 1 << sizeClass,
+      &external
+    ));
+    // Return the arguments to pass to encode():
+    napi_value stripe;
+    OK(napi_create_object(env, &stripe));
+    OK(napi_set_named_property(env, stripe, "buffer", buffer));
+    set_int(env, stripe, "bufferOffset", 0);
+    set_int(env, stripe, "bufferSize", (int64_t) bufferSize);
+    OK(napi_set_named_property(env, stripe, "parity", buffer));
+    set_int(env, stripe, "parityOffset", (int64_t) parityOffset);
+    set_int(env, stripe, "paritySize", (int64_t) paritySize);
+    return stripe;
   #endif
+}
+
+static napi_value stripeStats(napi_env env, napi_callback_info info) {
+  size_t argc = 0;
+  OK(napi_get_cb_info(env, info, &argc, NULL, NULL, NULL));
+  if (argc != 0) THROW(env, "expected no arguments");
+  uv_once(&arena_once, arena_init);
+  uv_mutex_lock(&arena.mutex);
+  const uint64_t reserved = arena.reserved;
+  const uint64_t reservedHuge = arena.reservedHuge;
+  const uint64_t allocated = arena.allocated;
+  const uint64_t allocations = arena.allocations;
+  const uint64_t reuses = arena.reuses;
+  uv_mutex_unlock(&arena.mutex);
+  napi_value stats;
+  OK(napi_create_object(env, &stats));
+  set_int(env, stats, "reserved", (int64_t) reserved);
+  set_int(env, stats, "reservedHuge", (int64_t) reservedHuge);
+  set_int(env, stats, "allocated", (int64_t) allocated);
+  set_int(env, stats, "free", (int64_t) (reserved - allocated));
+  set_int(env, stats, "allocations", (int64_t) allocations);
+  set_int(env, stats, "reuses", (int64_t) reuses);
+  return stats;
+}
+
+static void instance_finalize(napi_env env, void* data, void* hint) {
+  struct instance* instance = data;
+  free(instance->ids);
+  free(instance);
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
   // We require ints to be at least 31 bits to prevent overflow issues:
   assert(INT_MAX >= 2147483647);
   // Keep `sources` and `targets` flags from exceeding 31 bits:
   // This side-steps issues with JavaScript signed/unsigned bitwise operations.
   assert(MAX_K + MAX_M < 31);
-  assert(sizeof(uint64_t) == 8); // Assumed by unaligned64().
-  assert(sizeof(PARAMETERS) == MAX_K * MAX_M * 7 * sizeof(int));
+  uv_once(&pool_once, pool_init);
+  uv_once(&dispatch_once, dispatch_init);
+  struct instance* instance = calloc(1, sizeof(struct instance));
+  if (!instance) THROW(env, "insufficient memory");
+  OK(napi_set_instance_data(env, instance, instance_finalize, NULL));
   set_int(env, exports, "MAX_K", MAX_K);
   set_int(env, exports, "MAX_M", MAX_M);
+  set_method(env, exports, "allocStripe", allocStripe);
+  set_method(env, exports, "stripeStats", stripeStats);
   set_method(env, exports, "create", create); // Create an encoding context.
+  set_method(env, exports, "createLRC", createLRC); // Create an LRC context.
+  set_method(env, exports, "createPiggyback", createPiggyback);
   set_method(env, exports, "encode", encode); // Encode buffer or parity shards.
+  set_method(env, exports, "encodeLayout", encodeLayout); // Interleaved data.
+  set_method(env, exports, "createEncoder", createEncoder);
+  set_method(env, exports, "createVolume", createVolume); // Dirty stripes.
+  set_method(env, exports, "reads", reads); // Sources read by encode().
+  set_method(env, exports, "locate", locate); // Locate corrupt shards.
+  set_method(env, exports, "encodeFile", encodeFile); // Encode parity files.
+  set_method(env, exports, "repairFile", repairFile); // Repair shard files.
   set_method(env, exports, "search", search); // Search for optimal parameters.
   set_method(env, exports, "XOR", XOR);
+  set_method(env, exports, "gfMultiply", gfMultiply); // target = c * source.
+  set_method(env, exports, "gfMultiplyXOR", gfMultiplyXOR); // target ^= ...
+  set_method(env, exports, "gfCombine", gfCombine); // Linear combinations.
+  set_method(env, exports, "threads", threads);
+  set_method(env, exports, "schedule", schedule);
+  set_method(env, exports, "cancel", cancel);
+  set_method(env, exports, "completions", completions);
+  set_method(env, exports, "jit", jit_enable);
+  set_method(env, exports, "calibrate", calibrate);
+  set_method(env, exports, "dispatch", dispatch);
+  set_method(env, exports, "saveDispatch", saveDispatch);
+  set_method(env, exports, "loadDispatch", loadDispatch);
   return exports;
 }
 
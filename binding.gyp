@@ -1,18 +1,45 @@
 {
   "targets": [
+    {
+      "target_name": "reed_solomon",
+      "type": "static_library",
+      "sources": [ "reed_solomon.c" ],
+      "cflags": ["-std=c99"],
+      "defines": [ "NDEBUG" ]
+    },
     {
       "target_name": "binding",
+      "dependencies": [ "reed_solomon" ],
       "sources": [ "binding.c" ],
-      "cflags": ["-std=c99"]
+      "cflags": ["-std=c99"],
+      "defines": [ "NDEBUG" ]
+    },
+    {
+      "target_name": "binding_checked",
+      "sources": [ "binding.c", "reed_solomon.c" ],
+      "cflags": ["-std=c99"],
+      "defines": [ "REED_SOLOMON_CHECKED" ]
+    },
+    {
+      "target_name": "reed-solomon",
+      "type": "executable",
+      "dependencies": [ "reed_solomon" ],
+      "sources": [ "cli.c" ],
+      "cflags": ["-std=c99"],
+      "defines": [ "NDEBUG" ]
     },
     {
       "target_name": "copy",
       "type": "none",
-      "dependencies": [ "binding" ],
+      "dependencies": [ "binding", "binding_checked", "reed-solomon" ],
       "copies": [
         {
           'destination': '<(module_root_dir)',
-          'files': ['<(module_root_dir)/build/Release/binding.node']
+          'files': [
+            '<(module_root_dir)/build/Release/binding.node',
+            '<(module_root_dir)/build/Release/binding_checked.node',
+            '<(module_root_dir)/build/Release/reed-solomon<(EXECUTABLE_SUFFIX)'
+          ]
         }
       ]
     }
@@ -0,0 +1,216 @@
+// A command-line tool to encode or repair the parity files of a file, linked
+// against the reed_solomon library alone (with the same usage as cli.js):
+//
+//   reed-solomon encode <k> <m> <shardSize> <file>
+//   reed-solomon repair <k> <m> <shardSize> <file> <shard> [<shard>...]
+
+// Expose pread() and pwrite() despite -std=c99:
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reed_solomon.h"
+
+#ifdef _WIN32
+
+int main(void) {
+  fprintf(stderr, "reed-solomon is not supported on Windows\n");
+  return 1;
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* USAGE =
+  "usage: reed-solomon encode <k> <m> <shardSize> <file>\n"
+  "       reed-solomon repair <k> <m> <shardSize> <file> <shard> [<shard>...]\n"
+  "\n"
+  "Parity shards are written to <file>.parity<n> for n in [0, m).\n"
+  "Data shards are indices in [0, k) and parity shards in [k, k + m).";
+
+static void fail(const char* message) {
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+static void fail_errno(const char* syscall, const char* path) {
+  fprintf(stderr, "%s, %s '%s'\n", strerror(errno), syscall, path);
+  exit(1);
+}
+
+static uint64_t arg_int(
+  const char* string,
+  const uint64_t minimum,
+  const uint64_t maximum
+) {
+  if (*string == 0 || strlen(string) > 10) fail(USAGE);
+  uint64_t integer = 0;
+  for (const char* c = string; *c; c++) {
+    if (*c < '0' || *c > '9') fail(USAGE);
+    integer = integer * 10 + (uint64_t) (*c - '0');
+  }
+  if (integer < minimum || integer > maximum) fail(USAGE);
+  return integer;
+}
+
+static int open_file(const char* path, const int create) {
+  const int fd = open(path, O_RDWR | (create ? O_CREAT : 0), 0644);
+  if (fd < 0) fail_errno("open", path);
+  return fd;
+}
+
+static uint32_t read_shard(
+  const int fd,
+  const char* path,
+  uint8_t* buffer,
+  uint32_t size,
+  uint64_t offset
+) {
+  // Returns the number of bytes read, which is short only at the end of file:
+  uint32_t length = 0;
+  while (length < size) {
+    ssize_t bytes = pread(fd, buffer + length, size - length,
+      (off_t) (offset + length));
+    if (bytes < 0 && errno == EINTR) continue;
+    if (bytes < 0) fail_errno("pread", path);
+    if (bytes == 0) break;
+    length += (uint32_t) bytes;
+  }
+  return length;
+}
+
+static void write_shard(
+  const int fd,
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t size,
+  uint64_t offset
+) {
+  while (size > 0) {
+    ssize_t bytes = pwrite(fd, buffer, size, (off_t) offset);
+    if (bytes < 0 && errno == EINTR) continue;
+    if (bytes < 0) fail_errno("pwrite", path);
+    buffer += bytes;
+    size -= (uint32_t) bytes;
+    offset += (uint64_t) bytes;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 6) fail(USAGE);
+  const char* command = argv[1];
+  const int k = (int) arg_int(argv[2], 1, REED_SOLOMON_MAX_K);
+  const int m = (int) arg_int(argv[3], 1, REED_SOLOMON_MAX_M);
+  const uint32_t shardSize = (uint32_t) arg_int(argv[4], 8, 4294967288);
+  if (shardSize % 8 != 0) fail("shardSize must be a multiple of 8 bytes");
+  const char* path = argv[5];
+  uint8_t context[REED_SOLOMON_CONTEXT_SIZE];
+  const uint32_t contextSize = reed_solomon_create(k, m, context);
+  if (contextSize == 0) fail(USAGE);
+  uint32_t sources = 0;
+  uint32_t targets = 0;
+  if (strcmp(command, "encode") == 0) {
+    if (argc != 6) fail(USAGE);
+    for (int i = 0; i < k; i++) sources |= (1 << i);
+    for (int i = k; i < k + m; i++) targets |= (1 << i);
+  } else if (strcmp(command, "repair") == 0) {
+    if (argc < 7) fail(USAGE);
+    for (int index = 6; index < argc; index++) {
+      targets |= (1 << arg_int(argv[index], 0, (uint64_t) (k + m - 1)));
+    }
+    for (int i = 0; i < k + m; i++) {
+      if (!(targets & (1 << i))) sources |= (1 << i);
+    }
+  } else {
+    fail(USAGE);
+  }
+  const char* error = reed_solomon_check_flags(context, contextSize, sources,
+    targets);
+  if (error) fail(error);
+  const int fd = open_file(path, 0);
+  struct stat st;
+  if (fstat(fd, &st) != 0) fail_errno("fstat", path);
+  const uint64_t fdSize = (uint64_t) st.st_size;
+  char parityPaths[REED_SOLOMON_MAX_M][4096];
+  int parityFds[REED_SOLOMON_MAX_M];
+  for (int j = 0; j < m; j++) {
+    if (
+      snprintf(parityPaths[j], sizeof(parityPaths[j]), "%s.parity%d", path, j)
+      >= (int) sizeof(parityPaths[j])
+    ) {
+      fail("path is too long");
+    }
+    parityFds[j] = open_file(parityPaths[j], (targets & (1 << (k + j))) != 0);
+  }
+  // Encode a stripe at a time, where the last stripe may be short and is padded
+  // virtually with zeroes:
+  uint8_t* shards[REED_SOLOMON_MAX_K + REED_SOLOMON_MAX_M];
+  uint32_t shardLengths[REED_SOLOMON_MAX_K + REED_SOLOMON_MAX_M];
+  for (int i = 0; i < k + m; i++) {
+    shards[i] = malloc(shardSize);
+    if (!shards[i]) fail("insufficient memory");
+  }
+  const uint64_t stripeSize = (uint64_t) k * shardSize;
+  const uint64_t stripes = (fdSize + stripeSize - 1) / stripeSize;
+  for (uint64_t stripe = 0; stripe < stripes; stripe++) {
+    for (int i = 0; i < k; i++) {
+      const uint64_t offset = stripe * stripeSize + (uint64_t) i * shardSize;
+      shardLengths[i] = 0;
+      if (offset < fdSize) {
+        shardLengths[i] = fdSize - offset < shardSize ?
+          (uint32_t) (fdSize - offset) : shardSize;
+      }
+      if (!(sources & (1 << i))) continue;
+      if (
+        read_shard(fd, path, shards[i], shardLengths[i], offset) !=
+        shardLengths[i]
+      ) {
+        fail("file is shorter than expected");
+      }
+    }
+    for (int j = 0; j < m; j++) {
+      shardLengths[k + j] = shardSize;
+      if (!(sources & (1 << (k + j)))) continue;
+      if (
+        read_shard(parityFds[j], parityPaths[j], shards[k + j], shardSize,
+          stripe * shardSize) != shardSize
+      ) {
+        fail("parity file is shorter than expected");
+      }
+    }
+    reed_solomon_encode(
+      context,
+      contextSize,
+      sources,
+      targets,
+      shards,
+      shardLengths,
+      shardSize
+    );
+    for (int i = 0; i < k + m; i++) {
+      if (!(targets & (1 << i)) || shardLengths[i] == 0) continue;
+      if (i < k) {
+        write_shard(fd, path, shards[i], shardLengths[i],
+          stripe * stripeSize + (uint64_t) i * shardSize);
+      } else {
+        write_shard(parityFds[i - k], parityPaths[i - k], shards[i],
+          shardSize, stripe * shardSize);
+      }
+    }
+  }
+  for (int i = 0; i < k + m; i++) free(shards[i]);
+  if (close(fd) != 0) fail_errno("close", path);
+  for (int j = 0; j < m; j++) {
+    if (close(parityFds[j]) != 0) fail_errno("close", parityPaths[j]);
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#!/usr/bin/env node
+
+var Node = { fs: require('fs'), process: process };
+var ReedSolomon = require('./binding.node');
+
+var USAGE = [
+  'usage: reed-solomon encode <k> <m> <shardSize> <file>',
+  '       reed-solomon repair <k> <m> <shardSize> <file> <shard> [<shard>...]',
+  '',
+  'Parity shards are written to <file>.parity<n> for n in [0, m).',
+  'Data shards are indices in [0, k) and parity shards in [k, k + m).'
+].join('\n');
+
+function Fail(message) {
+  console.error(message);
+  Node.process.exit(1);
+}
+
+function Int(string, minimum, maximum) {
+  var integer = Number(string);
+  if (
+    !/^\d+$/.test(string) ||
+    integer < minimum ||
+    integer > maximum
+  ) {
+    Fail(USAGE);
+  }
+  return integer;
+}
+
+function Open(path, create) {
+  if (create && !Node.fs.existsSync(path)) return Node.fs.openSync(path, 'w+');
+  return Node.fs.openSync(path, 'r+');
+}
+
+var argv = Node.process.argv.slice(2);
+if (argv.length < 5) Fail(USAGE);
+var command = argv[0];
+var k = Int(argv[1], 1, ReedSolomon.MAX_K);
+var m = Int(argv[2], 1, ReedSolomon.MAX_M);
+var shardSize = Int(argv[3], 8, 4294967288);
+if (shardSize % 8 !== 0) Fail('shardSize must be a multiple of 8 bytes');
+var path = argv[4];
+var context = ReedSolomon.create(k, m);
+var sources = 0;
+var targets = 0;
+if (command === 'encode') {
+  if (argv.length !== 5) Fail(USAGE);
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+} else if (command === 'repair') {
+  if (argv.length < 6) Fail(USAGE);
+  argv.slice(5).forEach(
+    function(shard) {
+      targets |= (1 << Int(shard, 0, k + m - 1));
+    }
+  );
+  for (var i = 0; i < k + m; i++) {
+    if (!(targets & (1 << i))) sources |= (1 << i);
+  }
+} else {
+  Fail(USAGE);
+}
+var fd = Open(path, false);
+var fdSize = Node.fs.fstatSync(fd).size;
+var parityFds = [];
+for (var j = 0; j < m; j++) {
+  parityFds.push(Open(path + '.parity' + j, (targets & (1 << (k + j))) !== 0));
+}
+function End(error) {
+  Node.fs.closeSync(fd);
+  parityFds.forEach(function(fd) { Node.fs.closeSync(fd); });
+  if (error) Fail(error.message);
+}
+if (command === 'encode') {
+  ReedSolomon.encodeFile(
+    context,
+    shardSize,
+    fd,
+    0,
+    fdSize,
+    parityFds,
+    0,
+    End
+  );
+} else {
+  ReedSolomon.repairFile(
+    context,
+    sources,
+    targets,
+    shardSize,
+    fd,
+    0,
+    fdSize,
+    parityFds,
+    0,
+    End
+  );
+}
@@ -0,0 +1,4551 @@
+// Expose mmap() and MAP_ANONYMOUS (for the JIT) despite -std=c99:
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "reed_solomon.h"
+
+// Kernels are called for every chunk and are asserted only in the checked
+// build (binding_checked.node, used by test.js). Their arguments are validated
+// once, by reed_solomon_check_context() and reed_solomon_check_flags():
+#ifdef REED_SOLOMON_CHECKED
+  #define KERNEL_ASSERT(expression) assert(expression)
+#else
+  // The expression is not evaluated but its variables are still used:
+  #define KERNEL_ASSERT(expression) ((void) sizeof(expression))
+#endif
+
+#define MAX_K REED_SOLOMON_MAX_K
+#define MAX_M REED_SOLOMON_MAX_M
+#define MAX_W REED_SOLOMON_MAX_W
+
+// Parameters for (k,m) found by `search()` are in PARAMETERS[k-1][m-1]:
+// PARAMETERS[k-1][m-1] = k, m, w, p, x, y, b:
+//
+// k = The number of data shards.
+// m = The number of parity shards.
+// w = The Galois Field exponent. The smaller the exponent, the less bits.
+// p = The primitive polynomial used to generate the Galois Field.
+//
+//     We do not use x or y when m <= 2:
+// x = The column offset used to generate the matrix, -1 when m <= 2.
+// y = The row offset used to generate the matrix, -1 when m <= 2.
+//
+// b = The number of bits in the resulting bit matrix.
+static const int PARAMETERS[24][6][7] = {
+  {
+    {  1, 1, 2,   7,  -1,  -1,    2 },
+    {  1, 2, 2,   7,  -1,  -1,    4 },
+    {  1, 3, 2,   7,   0,   1,    6 },
+    {  1, 4, 4,  19,   0,   1,   16 },
+    {  1, 5, 4,  19,   0,   1,   20 },
+    {  1, 6, 4,  19,   0,   1,   24 }
+  },
+  {
+    {  2, 1, 2,   7,  -1,  -1,    4 },
+    {  2, 2, 2,   7,  -1,  -1,    9 },
+    {  2, 3, 4,  19,   0,   4,   28 },
+    {  2, 4, 4,  19,   0,   5,   40 },
+    {  2, 5, 4,  19,   2,   9,   51 },
+    {  2, 6, 4,  19,   4,  10,   62 }
+  },
+  {
+    {  3, 1, 2,   7,  -1,  -1,    6 },
+    {  3, 2, 4,  19,  -1,  -1,   26 },
+    {  3, 3, 4,  19,   0,   9,   44 },
+    {  3, 4, 4,  19,   1,   8,   63 },
+    {  3, 5, 4,  19,   1,   9,   82 },
+    {  3, 6, 4,  19,   0,   9,  101 }
+  },
+  {
+    {  4, 1, 4,  19,  -1,  -1,   16 },
+    {  4, 2, 4,  19,  -1,  -1,   36 },
+    {  4, 3, 4,  19,   0,   9,   63 },
+    {  4, 4, 4,  19,   3,  11,   89 },
+    {  4, 5, 4,  19,   3,  11,  116 },
+    {  4, 6, 4,  19,  11,   4,  145 }
+  },
+  {
+    {  5, 1, 4,  19,  -1,  -1,   20 },
+    {  5, 2, 4,  19,  -1,  -1,   47 },
+    {  5, 3, 4,  19,   4,  13,   82 },
+    {  5, 4, 4,  19,   3,  12,  118 },
+    {  5, 5, 4,  19,   0,   9,  152 },
+    {  5, 6, 4,  19,   0,   9,  185 }
+  },
+  {
+    {  6, 1, 4,  19,  -1,  -1,   24 },
+    {  6, 2, 4,  19,  -1,  -1,   58 },
+    {  6, 3, 4,  19,   2,  12,  102 },
+    {  6, 4, 4,  19,   2,  12,  144 },
+    {  6, 5, 4,  19,   0,   9,  186 },
+    {  6, 6, 4,  19,   0,   9,  231 }
+  },
+  {
+    {  7, 1, 4,  19,  -1,  -1,   28 },
+    {  7, 2, 4,  19,  -1,  -1,   71 },
+    {  7, 3, 4,  19,   1,  13,  123 },
+    {  7, 4, 4,  19,   2,  12,  174 },
+    {  7, 5, 4,  19,   0,   9,  226 },
+    {  7, 6, 4,  19,   7,   0,  277 }
+  },
+  {
+    {  8, 1, 4,  19,  -1,  -1,   32 },
+    {  8, 2, 4,  19,  -1,  -1,   84 },
+    {  8, 3, 4,  19,   2,  13,  142 },
+    {  8, 4, 4,  19,   2,  12,  205 },
+    {  8, 5, 4,  19,   0,   9,  265 },
+    {  8, 6, 4,  19,   0,   8,  328 }
+  },
+  {
+    {  9, 1, 4,  19,  -1,  -1,   36 },
+    {  9, 2, 4,  19,  -1,  -1,   97 },
+    {  9, 3, 4,  19,   1,  13,  162 },
+    {  9, 4, 4,  19,   2,  12,  237 },
+    {  9, 5, 4,  19,   0,   9,  308 },
+    {  9, 6, 4,  19,   1,  10,  376 }
+  },
+  {
+    { 10, 1, 4,  19,  -1,  -1,   40 },
+    { 10, 2, 4,  19,  -1,  -1,  111 },
+    { 10, 3, 4,  19,   1,  13,  186 },
+    { 10, 4, 4,  19,   0,  12,  268 },
+    { 10, 5, 4,  19,   0,  11,  347 },
+    { 10, 6, 4,  19,   0,  10,  426 }
+  },
+  {
+    { 11, 1, 4,  19,  -1,  -1,   44 },
+    { 11, 2, 4,  19,  -1,  -1,  125 },
+    { 11, 3, 4,  19,   0,  13,  211 },
+    { 11, 4, 4,  19,   0,  12,  300 },
+    { 11, 5, 4,  19,   0,  11,  390 },
+    { 11, 6, 8, 135,  58, 188, 1401 }
+  },
+  {
+    { 12, 1, 4,  19,  -1,  -1,   48 },
+    { 12, 2, 4,  19,  -1,  -1,  139 },
+    { 12, 3, 4,  19,   3,   0,  234 },
+    { 12, 4, 4,  19,   0,  12,  334 },
+    { 12, 5, 8, 113,  24, 208, 1269 },
+    { 12, 6, 8, 135,  57, 188, 1577 }
+  },
+  {
+    { 13, 1, 4,  19,  -1,  -1,   52 },
+    { 13, 2, 4,  19,  -1,  -1,  155 },
+    { 13, 3, 4,  19,   0,  13,  261 },
+    { 13, 4, 8, 135,  59, 189, 1037 },
+    { 13, 5, 8, 113,  27, 236, 1393 },
+    { 13, 6, 8, 113,  27, 236, 1733 }
+  },
+  {
+    { 14, 1, 4,  19,  -1,  -1,   56 },
+    { 14, 2, 4,  19,  -1,  -1,  171 },
+    { 14, 3, 8, 169,   4, 252,  777 },
+    { 14, 4, 8, 135,  58, 189, 1121 },
+    { 14, 5, 8, 135,  58, 189, 1508 },
+    { 14, 6, 8, 135,  58, 188, 1880 }
+  },
+  {
+    { 15, 1, 4,  19,  -1,  -1,   60 },
+    { 15, 2, 8, 135,  -1,  -1,  353 },
+    { 15, 3, 8, 113,  24, 209,  836 },
+    { 15, 4, 8, 135,  58, 189, 1225 },
+    { 15, 5, 8, 101,  28, 232, 1644 },
+    { 15, 6, 8, 113, 120, 241, 2037 }
+  },
+  {
+    { 16, 1, 8,  29,  -1,  -1,  128 },
+    { 16, 2, 8, 135,  -1,  -1,  380 },
+    { 16, 3, 8, 113,  22, 213,  901 },
+    { 16, 4, 8, 113,  22, 212, 1324 },
+    { 16, 5, 8, 101,  28, 232, 1765 },
+    { 16, 6, 8, 101,  28, 232, 2195 }
+  },
+  {
+    { 17, 1, 8,  29,  -1,  -1,  136 },
+    { 17, 2, 8, 135,  -1,  -1,  407 },
+    { 17, 3, 8, 113,  22, 213,  960 },
+    { 17, 4, 8, 135,  58, 189, 1423 },
+    { 17, 5, 8, 101,  27, 232, 1880 },
+    { 17, 6, 8, 101,  27, 232, 2343 }
+  },
+  {
+    { 18, 1, 8,  29,  -1,  -1,  144 },
+    { 18, 2, 8, 135,  -1,  -1,  434 },
+    { 18, 3, 8, 113,  24, 213, 1027 },
+    { 18, 4, 8, 113,  22, 212, 1513 },
+    { 18, 5, 8, 195,   8,  32, 2019 },
+    { 18, 6, 8, 113, 205, 126, 2500 }
+  },
+  {
+    { 19, 1, 8,  29,  -1,  -1,  152 },
+    { 19, 2, 8, 135,  -1,  -1,  462 },
+    { 19, 3, 8, 113,  22, 213, 1086 },
+    { 19, 4, 8, 113,  23, 212, 1604 },
+    { 19, 5, 8, 195,   7,  32, 2131 },
+    { 19, 6, 8, 195,   3,  60, 2654 }
+  },
+  {
+    { 20, 1, 8,  29,  -1,  -1,  160 },
+    { 20, 2, 8, 135,  -1,  -1,  490 },
+    { 20, 3, 8, 113,  22, 213, 1147 },
+    { 20, 4, 8, 113,  22, 212, 1695 },
+    { 20, 5, 8, 195,   4, 238, 2270 },
+    { 20, 6, 8, 113,  21, 233, 2816 }
+  },
+  {
+    { 21, 1, 8,  29,  -1,  -1,  168 },
+    { 21, 2, 8, 135,  -1,  -1,  518 },
+    { 21, 3, 8, 113,  21, 213, 1225 },
+    { 21, 4, 8, 113,  21, 212, 1801 },
+    { 21, 5, 8, 195,   3,  60, 2395 },
+    { 21, 6, 8, 195,   3,  60, 2980 }
+  },
+  {
+    { 22, 1, 8,  29,  -1,  -1,  176 },
+    { 22, 2, 8, 135,  -1,  -1,  546 },
+    { 22, 3, 8, 113,  20, 213, 1292 },
+    { 22, 4, 8, 113,  21, 212, 1906 },
+    { 22, 5, 8, 195,  35,  28, 2512 },
+    { 22, 6, 8, 195,   3,  60, 3135 }
+  },
+  {
+    { 23, 1, 8,  29,  -1,  -1,  184 },
+    { 23, 2, 8, 135,  -1,  -1,  574 },
+    { 23, 3, 8, 113,  19, 213, 1366 },
+    { 23, 4, 8, 113,  19, 212, 2008 },
+    { 23, 5, 8, 195,   3, 238, 2652 },
+    { 23, 6, 8, 113, 205, 126, 3291 }
+  },
+  {
+    { 24, 1, 8,  29,  -1,  -1,  192 },
+    { 24, 2, 8, 135,  -1,  -1,  603 },
+    { 24, 3, 8, 113,  18, 213, 1437 },
+    { 24, 4, 8, 195, 125,  91, 2110 },
+    { 24, 5, 8, 195,   3, 238, 2787 },
+    { 24, 6, 8, 195,  42, 225, 3466 }
+  }
+};
+
+// The Cauchy matrix of each (k, m) in PARAMETERS is in MATRICES[k-1][m-1] (k
+// columns by m rows), as printed by `search()`. Finding a matrix sorts every
+// element of the field and tries every column of each row, so contexts are
+// created from these instead, and the search is repeated only to assert them:
+static const uint8_t MATRICES[24][6][MAX_K * MAX_M] = {
+  {
+    {
+        1
+    },
+    {
+        1,   1
+    },
+    {
+        1,   1,   1
+    },
+    {
+        1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1
+    }
+  },
+  {
+    {
+        1,   1
+    },
+    {
+        1,   1,   1,   2
+    },
+    {
+        1,   1,   8,   1,   1,   2
+    },
+    {
+        1,   1,   1,   3,   1,   9,   4,   1
+    },
+    {
+        1,   1,   1,  12,   4,   1,   1,   2,   1,   8
+    },
+    {
+        1,   1,   9,   2,   1,   6,   8,   1,   1,   8,   1,   9
+    }
+  },
+  {
+    {
+        1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   2,   9
+    },
+    {
+        1,   1,   1,   1,  12,   9,   9,   2,   1
+    },
+    {
+        1,   1,   1,   1,  12,   4,   1,   9,   2,   1,   6,   9
+    },
+    {
+        1,   1,   1,   1,   5,   9,   2,   1,  13,   5,   9,   1,
+        1,  13,   2
+    },
+    {
+        1,   1,   1,   1,  12,   9,   9,   2,   1,   8,   1,  12,
+       12,   4,   1,   1,   8,  13
+    }
+  },
+  {
+    {
+        1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   2,   9,   4
+    },
+    {
+        1,   1,   1,   1,   1,  12,   9,   6,   1,   4,   2,   9
+    },
+    {
+        1,   1,   1,   1,   1,   8,  12,  13,   1,  12,   2,   9,
+        2,   9,   1,  12
+    },
+    {
+        1,   1,   1,   1,   1,   8,  12,  13,   1,  12,   2,   9,
+        2,   9,   1,  12,  13,  12,   8,   1
+    },
+    {
+        1,   1,   1,   1,   9,   4,  10,   1,  11,   4,   1,   9,
+        1,   6,   9,   3,   3,  15,   4,   1,   1,   9,   2,   8
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   2,   9,   4,   8
+    },
+    {
+        1,   1,   1,   1,   1,   2,  11,   1,  12,   9,   1,   4,
+        2,   9,  12
+    },
+    {
+        1,   1,   1,   1,   1,   8,  12,  13,   3,   1,  11,   4,
+        1,   9,   2,   2,  12,   1,   6,   9
+    },
+    {
+        1,   1,   1,   1,   1,   2,  11,   1,  12,  13,   9,   2,
+        1,  13,   5,  13,   7,   2,   4,   1,   3,   1,  13,   2,
+        4
+    },
+    {
+        1,   1,   1,   1,   1,   2,  11,   1,  12,  13,   9,   2,
+        1,  13,   5,  13,   7,   2,   4,   1,   3,   1,  13,   2,
+        4,   1,   8,  13,   5,   2
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   2,   9,   4,   8,  13
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   4,   6,  15,   8,   9,
+       13,  11,   4,   1,   9,   2
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   4,   6,  15,   8,   9,
+       13,  11,   4,   1,   9,   2,   5,   2,  12,   1,   6,   9
+    },
+    {
+        1,   1,   1,   1,   1,   1,   2,  11,   1,  12,  13,   6,
+        9,   2,   1,  13,   5,   4,   1,  15,   8,   3,   4,   9,
+        3,   1,  13,   2,   4,  12
+    },
+    {
+        1,   1,   1,   1,   1,   1,   2,  11,   1,  12,  13,   6,
+        9,   2,   1,  13,   5,   4,   1,  15,   8,   3,   4,   9,
+        3,   1,  13,   2,   4,  12,   1,   8,  13,   5,   2,  14
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   2,   9,   4,   8,
+       13,   3
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   8,   1,  11,   9,   6,
+       13,   3,   8,  11,  13,   1,   4,   2,   9
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   8,   6,   5,   1,  12,
+        4,  13,  13,  11,   4,   1,   9,   2,   6,   5,   2,  12,
+        1,   6,   9,   4
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   2,  11,   1,  12,  13,
+        6,   4,   9,   2,   1,  13,   5,   4,  12,   8,   1,  12,
+       11,   6,   4,  13,   3,   1,  13,   2,   4,  12,   5
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   9,  12,  15,   5,
+        8,   4,  10,   2,   9,  13,   1,   4,   5,   8,  12,   1,
+        6,   9,   3,  15,   5,   9,   8,   1,  15,   6,   2,   1,
+       14,   9,   8,   4,  13,   2
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   9,   4,
+        8,  13,   3,   6
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   2,   5,   1,  12,
+        9,   6,  13,   4,  11,  13,   1,   4,   2,   9,  12,   6
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   2,   8,  12,  13,
+        3,   1,  14,   5,  13,  11,   4,   1,   9,   2,   6,  12,
+        5,   2,  12,   1,   6,   9,   4,  13
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,  12,   9,   6,
+       15,   3,   2,   5,   1,   4,   2,   9,  10,   8,  11,  13,
+        8,   1,  12,  11,   6,   4,  13,   9,   3,   1,  13,   2,
+        4,  12,   5,   6
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   6,  15,   8,   9,
+       10,   5,   1,   4,   4,   1,   9,   2,   8,  10,  13,  11,
+       12,   1,   6,   9,   3,  15,   5,   2,   1,   3,   2,  13,
+       12,   4,   6,   5,   1,   8,  11,  12,   4,   6,   9,  13
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   9,
+        4,   8,  13,   3,   6,  12
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   3,   2,   5,
+        1,  12,   9,   6,  13,   4,   8,  11,  13,   1,   4,   2,
+        9,  12,   6
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   8,   6,   5,
+        1,  12,   4,  13,   7,   9,   9,   5,   8,   2,   1,   4,
+       12,  11,  15,   5,   2,  12,   1,   6,   9,   4,  13,  11
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  12,   9,
+        6,  15,   3,   2,   5,  10,   9,   2,   1,  13,   5,   4,
+       12,  15,   8,   8,   1,  12,  11,   6,   4,  13,   9,   5,
+        4,  13,  14,   9,   1,   3,  12,   8,   5
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  12,  13,
+        2,   8,   7,  10,   9,   6,   1,  13,   5,   9,   3,   8,
+       15,   6,   4,   1,   6,   4,  14,   5,  13,   8,  11,   2,
+        9,   2,   6,  12,  10,  11,   8,   1,  13,  12,   1,   8,
+        9,  13,   4,   6,   2,  10
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,
+        9,   4,   8,  13,   3,   6,  12,   5
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   3,   2,
+        5,   1,  12,   9,   6,  13,   4,   8,   8,  11,  13,   1,
+        4,   2,   9,  12,   6,   7
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   9,
+       12,   5,  14,   8,  10,   6,   2,  13,   8,  10,  13,  11,
+        4,   1,   9,   2,   6,  12,   3,  15,   5,   2,  12,   1,
+        6,   9,   4,  13
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  13,   5,
+        1,   8,  12,  10,   2,  14,   9,   6,   1,  10,   5,  13,
+        3,   9,  15,   8,   4,   6,  12,  11,   8,   1,  13,   9,
+        6,   4,  10,   2,  13,   2,   3,   1,   5,   6,   4,  12,
+       15,   9
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   8,   9,
+        6,  15,   1,   4,  10,   5,  13,   3,  10,   1,  13,   5,
+        9,   3,   8,  15,   6,   4,   5,  13,   8,   1,  10,  12,
+       14,   2,   6,   9,   2,  13,   1,   3,   6,   5,  12,   4,
+        9,  15,  11,  12,   1,   8,   9,  13,   4,   6,   2,  10
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        2,   9,   4,   8,  13,   3,   6,  12,   5,  11
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  15,
+        3,   2,   5,   1,  12,   9,   6,  13,   4,   8,   5,   4,
+       12,  15,   9,   2,   1,  13,   6,   3,  10
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        9,  12,   5,  14,   8,  10,   6,   2,  13,   4,   8,  10,
+       13,  11,   4,   1,   9,   2,   6,  12,  14,   3,  15,   5,
+        2,  12,   1,   6,   9,   4,  13,  11
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   6,
+        1,  11,   7,  13,   2,   5,   8,  12,  15,   9,   8,  15,
+       14,   2,  11,   4,   1,  12,   6,   5,   9,  12,  11,   8,
+        1,  13,   9,   6,   4,  10,   2,   5,   9,   4,   6,   2,
+       10,  12,   8,  11,  13,   1,  14
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 147,
+      170,  72,   1,  48, 192, 195, 144, 185,  92, 168,  73, 192,
+       14,   4, 180,   1, 195, 185,   8,  95, 183,  69,  37,  48,
+        1, 235,  45,  52,  12, 180, 147,  25, 168, 233, 103, 237,
+       73,  79,  90,  48,   4, 161,   1,  48, 193,   5,  10,  79,
+      163, 195,   1,   4,  13,  99
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   2,   9,   4,   8,  13,   3,   6,  12,   5,  11,  15
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+       13,   3,   2,   6,   1,   9,  12,  15,   5,   8,   4,  10,
+        1,   5,  10,   9,  13,   6,   8,   4,   3,  12,  15,   2
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   9,  12,   5,  14,   8,  10,   6,   2,  13,   4,  15,
+        8,  10,  13,  11,   4,   1,   9,   2,   6,  12,  14,   7,
+        3,  15,   5,   2,  12,   1,   6,   9,   4,  13,  11,   8
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      196,  32, 174,  24,  44, 224,  30,  18,   7,  68, 173,   1,
+       29,  44,   2, 185,  57,   1,  17,  58, 184,  34, 116, 164,
+       80, 185, 202,  59,  23,  58,  22,   9,   7,   1, 175,  57,
+      178, 187,  98,  88, 129,  20,  69, 146,   1,  35, 120, 185
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      148, 147, 170,  72,   1,  48, 192, 195, 144, 185,  92, 168,
+       89,  73, 192,  14,   4, 180,   1, 195, 185,   8,  95, 183,
+      208,  69,  37,  48,   1, 235,  45,  52,  12, 180, 147,  25,
+      138, 168, 233, 103, 237,  73,  79,  90,  48,   4, 161,   1,
+      221,  48, 193,   5,  10,  79, 163, 195,   1,   4,  13,  99
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   2,   9,   4,   8,  13,   3,   6,  12,   5,  11,
+       15,  10
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,  14,   8,   1,  11,   9,   6,  13,   3,  15,   2,   4,
+       12,   5,  11,   2,   6,  14,  13,   1,   9,  15,   3,   8,
+        5,  10,   4
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1, 237,  92, 241, 225, 100, 158,   6, 186, 138, 146, 231,
+        4,   1, 176,   1, 192, 162,  45, 140,  81, 118,   2, 224,
+       76,  34,  74,  48,  10,   5, 163,  79,   1, 195,  13,   4,
+      151,  99, 186,   2
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,  80,   7,  68, 173,   1,  44, 224,  30,  18, 196,  32,
+      174,  24,  59, 184,  34, 116, 164,  57,   1,  17,  58,  29,
+       44,   2, 185,   1,  56,   8, 188, 185, 184, 161, 176,  72,
+       98,  12,   7, 169,   5,  78,  58,  17, 241, 146, 112, 151,
+        1, 246, 202,  29, 129
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,  80,   7,  68, 173,   1,  44, 224,  30,  18, 196,  32,
+      174,  24,  59, 184,  34, 116, 164,  57,   1,  17,  58,  29,
+       44,   2, 185,   1,  56,   8, 188, 185, 184, 161, 176,  72,
+       98,  12,   7, 169,   5,  78,  58,  17, 241, 146, 112, 151,
+        1, 246, 202,  29, 129,  29, 147,  56,  46,  10, 108, 172,
+       12, 103, 177,   1,  60, 176
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   2,   9,   4,   8,  13,   3,   6,  12,   5,
+       11,  15,  10,  14
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   7, 190,  36, 206, 212, 208, 115,  98,  60,  88,
+        1, 104,   2,  52, 139, 208,   3, 106,  13,  17,   4, 247,
+      239,  52, 228,   1,  24,  19
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1, 136, 237,  92, 241, 225, 100, 158,   6, 186, 138,
+      146, 231,   4,   1,  48, 176,   1, 192, 162,  45, 140,  81,
+      118,   2, 224,  76,  34,  74, 193,  48,  10,   5, 163,  79,
+        1, 195,  13,   4, 151,  99, 186,   2
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1, 136, 237,  92, 241, 225, 100, 158,   6, 186, 138,
+      146, 231,   4,   1,  48, 176,   1, 192, 162,  45, 140,  81,
+      118,   2, 224,  76,  34,  74, 193,  48,  10,   5, 163,  79,
+        1, 195,  13,   4, 151,  99, 186,   2, 233, 168, 237, 103,
+       79,  73,  48,  90, 161,   4, 187,   1, 142, 185
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1, 147, 170,  72,   1,  48, 192, 195, 144, 185,  92,
+      168, 238, 248,  41, 176,  48, 192,   1,  45, 162,  81, 140,
+        2, 118,  76, 224,  74,  34, 237, 136, 241,  92, 100, 225,
+        6, 158, 138, 186, 231, 146,   1,   4, 168, 233, 103, 237,
+       73,  79,  90,  48,   4, 161,   1, 187, 185, 142,  48, 193,
+        5,  10,  79, 163, 195,   1,   4,  13,  99, 151,   2, 186
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   2, 195,   4, 162,  81,   8,   3, 194,
+        6,  97,   5,  10,  12,  20
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1, 185,  80,  59, 202,  58,  23,   9,  22,   1,
+        7,  57, 175,  78, 188,  46,  44,  29, 185,   2,   1,  57,
+       58,  17,  34, 184, 164, 116, 202,  60,  59
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1, 136, 237,  92, 241, 225, 100, 158,   6, 186,
+      138, 146, 231,   4,   1, 151,  48, 176,   1, 192, 162,  45,
+      140,  81, 118,   2, 224,  76,  34,  74, 128, 193,  48,  10,
+        5, 163,  79,   1, 195,  13,   4, 151,  99, 186,   2, 176
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,  93,  22,   1, 239, 158,  38,  79,  76,   3,
+      134,  21, 223, 227,  23,   5,  78,  89,   5,  76,   8,   4,
+      197, 239, 142,   9, 143,  81,  19,  73,   1,   1,  22,  20,
+       93,  92,  80, 183, 157,  81, 214,   9, 215,  17,  75,  38,
+      194,   2, 199,   1, 187, 212,   9, 248, 158, 139,  74,  76,
+      206,   5, 250
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   9,  69, 120, 150,   1,  87, 184, 147, 215,
+       17,  70, 160,  90,  68, 169, 220, 184, 129,  72,  24,   7,
+      187,  12,   8,  96, 188, 202,   1, 157,  36,   4,  57, 127,
+        5,   1,  82,  13,  69, 178,   6,  28,  23, 179, 146,   3,
+       56,  86,  11, 215, 173,  14,  91,   1, 236, 117, 165,  72,
+       93,  40,  10,  56,   5, 189,  27,   1,  37,   7, 150, 177,
+       12, 230, 188,   6,  74,  94
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   2, 195,   4, 162,  81,   8,   3,
+      194,   6,  97,   5,  10,  12,  20,  40
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   5,  36,  58,  23,   9,  22, 185,  80,
+       59, 202,  78, 188,  46, 221,   1,   7,  41,  84,   1,  57,
+       58,  17,  44,  29, 185,   2, 202,  60,  59, 246,  34, 184
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1, 172,  45, 115,   7, 221, 175,  40,   1,
+       96, 228, 232, 236,  16, 186, 138,  44,  84,  41,  57,   1,
+       17,  58,  29,  44,   2, 185,  60, 202, 246,  59, 184,  34,
+       36,   5,  23,  58,  22,   9,  80, 185, 202,  59, 188,  78,
+      221,  46,   7,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,  93,  22,   1, 239, 158,  38,  79,  76,
+        3, 134,  21, 223, 227,  23,   5, 161,  78,  89,   5,  76,
+        8,   4, 197, 239, 142,   9, 143,  81,  19,  73,   1, 126,
+        1,  22,  20,  93,  92,  80, 183, 157,  81, 214,   9, 215,
+       17,  75,  38,  89, 194,   2, 199,   1, 187, 212,   9, 248,
+      158, 139,  74,  76, 206,   5, 250,  48
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,  93,  22,   1, 239, 158,  38,  79,  76,
+        3, 134,  21, 223, 227,  23,   5, 161,  78,  89,   5,  76,
+        8,   4, 197, 239, 142,   9, 143,  81,  19,  73,   1, 126,
+        1,  22,  20,  93,  92,  80, 183, 157,  81, 214,   9, 215,
+       17,  75,  38,  89, 194,   2, 199,   1, 187, 212,   9, 248,
+      158, 139,  74,  76, 206,   5, 250,  48,  94,  55, 139,  45,
+       26, 178,  64, 250, 241,   9, 199,   8,   1, 204,  88,   5
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   2, 195,   4, 162,  81,   8,
+        3, 194,   6,  97,   5,  10,  12,  20,  40,  80
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   5,  36,  58,  23,   9,  22, 185,
+       80,  59, 202,  78, 188,  46, 221,   1,   7,  57,  41,  84,
+        1,  57,  58,  17,  44,  29, 185,   2, 202,  60,  59, 246,
+       34, 184, 164
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1, 136, 237,  92, 241, 225, 100, 158,
+        6, 186, 138, 146, 231,   4,   1, 151, 173, 121,  48, 176,
+        1, 192, 162,  45, 140,  81, 118,   2, 224,  76,  34,  74,
+      128,  36, 248, 163,  24,   5, 193, 146, 228, 195, 162, 197,
+        2, 136, 242,  93,   1,  88,  96,   9
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1, 184,  93,  22,   1, 239, 158,  38,
+       79,  76,   3, 134,  21, 223, 227,  23,   5, 161,   8, 151,
+      213, 184,   4, 134,  67, 158,  89, 177, 125,  74,  83,   1,
+      188, 251,  44,  37,   1,  22,  20,  93,  92,  80, 183, 157,
+       81, 214,   9, 215,  17,  75,  38,  89, 208, 194,   2, 199,
+        1, 187, 212,   9, 248, 158, 139,  74,  76, 206,   5, 250,
+       48
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1, 184,  93,  22,   1, 239, 158,  38,
+       79,  76,   3, 134,  21, 223, 227,  23,   5, 161,   8, 151,
+      213, 184,   4, 134,  67, 158,  89, 177, 125,  74,  83,   1,
+      188, 251,  44,  37,   1,  22,  20,  93,  92,  80, 183, 157,
+       81, 214,   9, 215,  17,  75,  38,  89, 208, 194,   2, 199,
+        1, 187, 212,   9, 248, 158, 139,  74,  76, 206,   5, 250,
+       48, 124,  94,  55, 139,  45,  26, 178,  64, 250, 241,   9,
+      199,   8,   1, 204,  88,   5
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   2, 195,   4, 162,  81,
+        8,   3, 194,   6,  97,   5,  10,  12,  20,  40,  80, 163
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1, 161, 184,  72, 176,  12,  98,
+      169,   7, 146,  36,   1, 191,   8,  56, 185, 188, 130,  22,
+        2, 114, 116,  34,  88,  58,   3,   4, 229, 120, 118, 157,
+       68,   1,  57, 232,   5, 148
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1, 172,  45, 115,   7, 221, 175,
+       40,   1,  96, 228, 232, 236,  16, 186, 138,  44, 196, 179,
+       84,  41,  57,   1,  17,  58,  29,  44,   2, 185,  60, 202,
+      246,  59, 184,  34, 116, 164,  36,   5,  23,  58,  22,   9,
+       80, 185, 202,  59, 188,  78, 221,  46,   7,   1, 175,  57
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1, 225, 147, 123,  10,  21,   8,
+       64,  74,   6, 141, 143,  17,   3, 217, 188,  72, 168,   1,
+      226, 162, 211, 228, 243,   2, 184,  31, 171,  89,   3, 253,
+      169,  82,  51, 100,   1, 227, 187,  72, 179, 232,   6, 112,
+       11,  57,   3, 233, 173, 114, 185,   1, 150, 166,  60, 154,
+       62, 131,  67, 237,  48,  90, 119, 145, 170,  85,  10, 211,
+        1,   2,  17,  72, 175, 133
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   9, 179, 224, 170, 157,  34,
+       11, 194, 129, 123,  74, 184,  14, 138,  32,   7,   1,  48,
+       93, 229,  52,  18,  46,  16,  36,  92,   1,  34, 198, 144,
+      241, 180,   5,  79,  67,  60, 195, 114, 236, 177, 153, 189,
+       74,  84, 237,   1, 185, 244, 101, 131,  93,  40,  32, 187,
+      202, 123, 132, 242,   5,  33,   9,   1, 185,  85, 236, 229,
+       59, 221,  76,  21,   3, 152,  18,   1, 183, 123,  20, 118,
+       88,  13, 175, 176,  39,  40,  92,   8, 177, 197, 184,  22
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   2, 195,   4, 162,
+       81,   8,   3, 194,   6,  97,   5,  10,  12,  20,  40,  80,
+      163,  16
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   5,  36,  58,  23,   9,
+       22, 185,  80,  59, 202,  78, 188,  46, 221,   1,   7,  57,
+      175,  76,  41,  84,   1,  57,  58,  17,  44,  29, 185,   2,
+      202,  60,  59, 246,  34, 184, 164, 116, 186
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,  45, 115,   7, 221, 175,
+       40,   1,  96, 228, 232, 236,  16, 186, 138,  44, 196, 179,
+      139,  73,  82, 114,   2,  34, 116,  58,  88,   4,   3, 120,
+      229, 157, 118,   1,  68, 232,  57, 148,   5,  40, 184, 161,
+      176,  72,  98,  12,   7, 169,  36, 146, 191,   1,  56,   8,
+      188, 185,  22, 130
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,  85, 225, 147, 123,  10,
+       21,   8,  64,  74,   6, 141, 143,  17,   3, 217, 188,  72,
+      168,   1,  98, 226, 162, 211, 228, 243,   2, 184,  31, 171,
+       89,   3, 253, 169,  82,  51, 100,   1, 227,  14, 187,  72,
+      179, 232,   6, 112,  11,  57,   3, 233, 173, 114, 185,   1,
+      150, 166,  60, 154,   5,  62, 131,  67, 237,  48,  90, 119,
+      145, 170,  85,  10, 211,   1,   2,  17,  72, 175, 133
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1, 108, 168,   1, 199, 212,
+        3, 217, 188,  72,   6, 141, 143,  17,  21,   8,  64,  74,
+      225, 147,  32,   1, 227,  62, 115, 169,  82,  51, 100, 171,
+       89,   3, 253, 243,   2, 184,  31, 226, 162,   4,  60, 154,
+       85, 231, 185,   1, 150, 166,   3, 233, 173, 114,   6, 112,
+       11,  57, 187,  72, 253, 211, 118, 224, 227, 129,  15,   1,
+       74, 236, 128, 158,  75,  12,  10,  23, 226, 185, 225, 243,
+        3, 102, 131, 169,  62,   7,  78,  27, 160,   1, 233, 103,
+       64,  20,  36, 173,  14, 147
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   2, 195,   4,
+      162,  81,   8,   3, 194,   6,  97,   5,  10,  12,  20,  40,
+       80, 163,  16,  24
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   5,  36,  58,  23,
+        9,  22, 185,  80,  59, 202,  78, 188,  46, 221,   1,   7,
+       57, 175,  76, 230,  82, 168,   2, 114, 116,  34,  88,  58,
+        3,   4, 229, 120, 118, 157,  68,   1,  57, 232,   5, 148
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1, 172,  45, 115,   7,
+      221, 175,  40,   1,  96, 228, 232, 236,  16, 186, 138,  44,
+      196, 179, 139,  73, 168,  82, 114,   2,  34, 116,  58,  88,
+        4,   3, 120, 229, 157, 118,   1,  68, 232,  57, 148,   5,
+       36,   5,  23,  58,  22,   9,  80, 185, 202,  59, 188,  78,
+      221,  46,   7,   1, 175,  57, 230,  76
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1, 193,   1, 189,  32,
+       26,  29,  16, 185,  62,  41, 244,  91,  84,  72,   8, 177,
+       23,  22, 241, 221,   1,  13,   3, 233, 229,  28,   2, 219,
+       36, 152, 160,  75,   6,  39,  93,  25,  35, 145, 173, 231,
+      246,  26, 239, 137,  76,   3,  74,  33,  57, 115, 200,   6,
+       72, 196,   1, 172, 152, 173, 144,  66,  64,  15, 194,  72,
+        1, 224, 133, 147,  46,  32, 179,  14, 255,  21, 198, 112,
+      229,   7, 183,   2
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,  22, 204,  43,   8,
+       56, 185, 188, 146,  36,   1, 191,  12,  98, 169,   7, 161,
+      184,  72, 176,  46, 148, 231,  95,  68,   1,  57, 232, 229,
+      120, 118, 157,  88,  58,   3,   4,   2, 114, 116,  34,  97,
+       37,  33,  96, 104,   1, 159, 229,  80, 145,  11,  97, 147,
+       51, 101,  32, 118,  57, 186,  44,  94,  10, 141, 241,  35,
+        1, 185, 120, 145,  54,  36, 140, 187, 178,  88,  98,  20,
+      129, 146,  69, 171, 119,   6,  92, 118, 221, 178,   1, 169,
+      249,  11,   4,  35,   8, 105,  16, 165,  23,  59, 184,  40
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2, 195,
+        4, 162,  81,   8,   3, 194,   6,  97,   5,  10,  12,  20,
+       40,  80, 163,  16,  24, 146
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,  35,   5,  36,
+       58,  23,   9,  22, 185,  80,  59, 202,  78, 188,  46, 221,
+        1,   7,  57, 175,  76, 230,  27,  41,  84,   1,  57,  58,
+       17,  44,  29, 185,   2, 202,  60,  59, 246,  34, 184, 164,
+      116, 186,  74
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1, 233, 172,  45,
+      115,   7, 221, 175,  40,   1,  96, 228, 232, 236,  16, 186,
+      138,  44, 196, 179, 139,  73, 136,  84,  41,  57,   1,  17,
+       58,  29,  44,   2, 185,  60, 202, 246,  59, 184,  34, 116,
+      164,  74, 186,  46,  81,  40, 184, 161, 176,  72,  98,  12,
+        7, 169,  36, 146, 191,   1,  56,   8, 188, 185,  22, 130
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1, 108, 168,   1,
+      199, 212,   3, 217, 188,  72,   6, 141, 143,  17,  21,   8,
+       64,  74, 225, 147, 123,  10,  16, 225, 144,  31, 216, 181,
+       41, 248,  50, 180, 205, 224, 159, 152,   1,  92, 238, 113,
+       81, 136, 114,   4,  60, 154,  85, 231, 185,   1, 150, 166,
+        3, 233, 173, 114,   6, 112,  11,  57, 187,  72, 179, 232,
+       57, 101, 236,   3,   5, 193,  30,   2, 148,  27, 195, 255,
+      150,  24,  20,  46,   7, 177,   1,   9,  21
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1, 108, 168,   1,
+      199, 212,   3, 217, 188,  72,   6, 141, 143,  17,  21,   8,
+       64,  74, 225, 147, 123,  10,  16, 225, 144,  31, 216, 181,
+       41, 248,  50, 180, 205, 224, 159, 152,   1,  92, 238, 113,
+       81, 136, 114,   4,  60, 154,  85, 231, 185,   1, 150, 166,
+        3, 233, 173, 114,   6, 112,  11,  57, 187,  72, 179, 232,
+       57, 101, 236,   3,   5, 193,  30,   2, 148,  27, 195, 255,
+      150,  24,  20,  46,   7, 177,   1,   9,  21, 243,   3, 102,
+      131, 169,  62,   7,  78,  27, 160,   1, 233, 103,  64,  20,
+       36, 173,  14, 147, 242, 215
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,
+      195,   4, 162,  81,   8,   3, 194,   6,  97,   5,  10,  12,
+       20,  40,  80, 163,  16,  24, 146, 193
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 225,  35,
+        5,  36,  58,  23,   9,  22, 185,  80,  59, 202,  78, 188,
+       46, 221,   1,   7,  57, 175,  76, 230, 136,  27,  41,  84,
+        1,  57,  58,  17,  44,  29, 185,   2, 202,  60,  59, 246,
+       34, 184, 164, 116, 186,  74
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 233, 172,
+       45, 115,   7, 221, 175,  40,   1,  96, 228, 232, 236,  16,
+      186, 138,  44, 196, 179, 139,  73, 244, 136,  84,  41,  57,
+        1,  17,  58,  29,  44,   2, 185,  60, 202, 246,  59, 184,
+       34, 116, 164,  74, 186, 151,  46,  81,  40, 184, 161, 176,
+       72,  98,  12,   7, 169,  36, 146, 191,   1,  56,   8, 188,
+      185,  22, 130,  43
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 108, 168,
+        1, 199, 212,   3, 217, 188,  72,   6, 141, 143,  17,  21,
+        8,  64,  74, 225, 147, 123,  10, 232,  32,   1, 227,  62,
+      115, 169,  82,  51, 100, 171,  89,   3, 253, 243,   2, 184,
+       31, 226, 162, 211, 228,  14,   4,  60, 154,  85, 231, 185,
+        1, 150, 166,   3, 233, 173, 114,   6, 112,  11,  57, 187,
+       72, 179, 232,  88,  21,  14,  13,  11,  72, 231, 135,   7,
+      154,   4, 216, 196,   5, 114, 188,  66, 236,   2, 152, 173,
+      247, 226
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 108, 168,
+        1, 199, 212,   3, 217, 188,  72,   6, 141, 143,  17,  21,
+        8,  64,  74, 225, 147, 123,  10, 232,  32,   1, 227,  62,
+      115, 169,  82,  51, 100, 171,  89,   3, 253, 243,   2, 184,
+       31, 226, 162, 211, 228,  14,   4,  60, 154,  85, 231, 185,
+        1, 150, 166,   3, 233, 173, 114,   6, 112,  11,  57, 187,
+       72, 179, 232,  88,  57, 101, 236,   3,   5, 193,  30,   2,
+      148,  27, 195, 255, 150,  24,  20,  46,   7, 177,   1,   9,
+       21,  69, 243,   3, 102, 131, 169,  62,   7,  78,  27, 160,
+        1, 233, 103,  64,  20,  36, 173,  14, 147, 242, 215, 170
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        2, 195,   4, 162,  81,   8,   3, 194,   6,  97,   5,  10,
+       12,  20,  40,  80, 163,  16,  24, 146, 193, 235
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1, 130,
+      225,  35,   5,  36,  58,  23,   9,  22, 185,  80,  59, 202,
+       78, 188,  46, 221,   1,   7,  57, 175,  76, 230, 236, 136,
+       27,  41,  84,   1,  57,  58,  17,  44,  29, 185,   2, 202,
+       60,  59, 246,  34, 184, 164, 116, 186,  74
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  50,
+      164,  36,  33, 110, 158,  49, 169,  60,  73,  11,  51,  91,
+       47,   3, 176, 171,  10, 101,  74, 248,   1, 113, 156,  27,
+      136,  84,  41,  57,   1,  17,  58,  29,  44,   2, 185,  60,
+      202, 246,  59, 184,  34, 116, 164,  74, 186, 216,  35, 225,
+       36,   5,  23,  58,  22,   9,  80, 185, 202,  59, 188,  78,
+      221,  46,   7,   1, 175,  57, 230,  76
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   7,
+      193,   1, 189,  32,  26,  29,  16, 185,  62,  41, 244,  91,
+       84,  72,   8, 177,  23,  22, 241, 221,  10, 148, 188,   1,
+       13,   3, 233, 229,  28,   2, 219,  36, 152, 160,  75,   6,
+       39,  93,  25,  35, 145, 173, 231, 131, 193, 153, 131, 178,
+      130, 229, 180, 179,  17,  47, 254, 239,   8, 165, 114, 129,
+      208,  12, 171, 220, 228,  94,  36,   1,  29,  64,  15, 194,
+       72,   1, 224, 133, 147,  46,  32, 179,  14, 255,  21, 198,
+      112, 229,   7, 183,   2, 235, 139
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   9,
+      179, 224, 170, 157,  34,  11, 194, 129, 123,  74, 184,  14,
+      138,  32,   7,   1,  48,  35,  17,  22, 112,  23,  93, 229,
+       52,  18,  46,  16,  36,  92,   1,  34, 198, 144, 241, 180,
+        5,  79,  67,  60,  33,  59,  31,  22, 146, 195, 114, 236,
+      177, 153, 189,  74,  84, 237,   1, 185, 244, 101, 131,  93,
+       40,  32, 187, 173,  64, 120, 182,  78, 202, 123, 132, 242,
+        5,  33,   9,   1, 185,  85, 236, 229,  59, 221,  76,  21,
+        3, 152, 144, 246,  14, 192, 248,  18,   1, 183, 123,  20,
+      118,  88,  13, 175, 176,  39,  40,  92,   8, 177, 197, 184,
+       22, 207, 253, 192, 167,  74
+    }
+  },
+  {
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   2, 195,   4, 162,  81,   8,   3, 194,   6,  97,   5,
+       10,  12,  20,  40,  80, 163,  16,  24, 146, 193, 235,  48
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      216, 130, 225,  35,   5,  36,  58,  23,   9,  22, 185,  80,
+       59, 202,  78, 188,  46, 221,   1,   7,  57, 175,  76, 230,
+      156, 236, 136,  27,  41,  84,   1,  57,  58,  17,  44,  29,
+      185,   2, 202,  60,  59, 246,  34, 184, 164, 116, 186,  74
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      185,  12, 231, 230,  10,  50, 236,  64, 239, 112,   1,  24,
+       71, 238,  37, 241, 111, 137,  36,  44,  15,  91, 145,  30,
+       20, 129,  60,  80, 147,  39,  38,  17, 238, 246,   8, 144,
+      151, 187,   3,   5,  14, 169, 114,  10,  57,   1, 171,  18,
+      226, 171, 115, 189,  65, 194, 177,  42,  18, 229,  33,   1,
+       24, 180,   5, 188,  56, 103,  76,   3,  58, 251,  17,  34
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        7, 193,   1, 189,  32,  26,  29,  16, 185,  62,  41, 244,
+       91,  84,  72,   8, 177,  23,  22, 241, 221,  10, 148, 132,
+      188,   1,  13,   3, 233, 229,  28,   2, 219,  36, 152, 160,
+       75,   6,  39,  93,  25,  35, 145, 173, 231, 131, 193,  70,
+      153, 131, 178, 130, 229, 180, 179,  17,  47, 254, 239,   8,
+      165, 114, 129, 208,  12, 171, 220, 228,  94,  36,   1,  30,
+       29,  64,  15, 194,  72,   1, 224, 133, 147,  46,  32, 179,
+       14, 255,  21, 198, 112, 229,   7, 183,   2, 235, 139,  26
+    },
+    {
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+        8, 181, 227, 211, 112, 120,   7,  60,   5, 174,  12, 212,
+       61,  17, 167,   1, 204, 228, 145,  31,  64, 182,  46, 156,
+      180,  62,  18,   8, 189,   7, 121, 144, 240,  95,   6,  99,
+      181, 255,   2, 204,  28,  11, 157,  68, 253,  29,  37,   1,
+        3,  58, 116, 230,  34, 169, 180,   5,   1,  24, 103,  76,
+      188,  56, 194, 177, 189,  65, 229,  33,  42,  18, 164,  67,
+       19,  72, 150, 136, 124,   1, 173,  24, 201, 170, 162,   7,
+      241,  22, 110, 169, 218, 103, 146,   5,  37,  15,  56,   4,
+      209,  20, 191,  25,  40, 232, 171, 205,  32, 244, 158, 112,
+       62, 148, 249,  18,  10,  24,   1, 189,  65,  22, 169, 145
+    }
+  }
+};
+
+static int g_divide(
+  const int* log,
+  const int* exp,
+  const int w,
+  const int a,
+  const int b
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  const int y = (1 << w) - 1;
+  assert(a <= y);
+  assert(b <= y);
+  assert(b >= 1);
+  if (a == 0) return 0;
+  return exp[(log[a] + y - log[b]) % y];
+}
+
+static int g_multiply(
+  const int* log,
+  const int* exp,
+  const int w,
+  const int a,
+  const int b
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  const int y = (1 << w) - 1;
+  assert(a <= y);
+  assert(b <= y);
+  if (a == 0 || b == 0) return 0;
+  return exp[(log[a] + log[b]) % y];
+}
+
+static void create_tables_field(
+  const int w,
+  const int p,
+  int* log,
+  int* exp
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  const int y = (1 << w) - 1;
+  const int z = (1 << w);
+  // Generate log and exp tables:
+  for (int a = 0; a < z; a++) {
+    log[a] = y;
+    exp[a] = 0;
+  }
+  int b = 1;
+  for (int a = 0; a < y; a++) {
+    assert(b < z);
+    assert(log[b] == y);
+    assert(exp[a] == 0);
+    log[b] = a;
+    exp[a] = b;
+    b = b << 1;
+    if (b & z) b = (b ^ p) & y;
+  }
+  // The logarithm of zero must not be defined:
+  assert(log[0] == y);
+  // The last byte of the exponents table must not be defined:
+  assert(exp[y] == 0);
+}
+
+static int bitmatrix_m0_optimized(
+  const int w,
+  const int k,
+  const uint8_t* bitmatrix
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(k < (1 << w));
+  // We assume that bitmatrix is an encoding (not decoding) bitmatrix.
+  // If row 0 is all ones then an erasure of shard < k + 1 can be optimized.
+  for (int c = 0; c < k; c++) {
+    for (int a = 0; a < w; a++) {
+      if (a == 0) {
+        if (bitmatrix[c * w + a] != 1) return 0;
+      } else {
+        if (bitmatrix[c * w + a] != 0) return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+// Rows of bits over the k * w columns of a bitmatrix, rounded up to 256 bits
+// so that row operations vectorize:
+#define BITS_WORDS ((MAX_K * MAX_W + 255) / 256 * 4)
+
+static int bits_get(const uint64_t* bits, const int index) {
+  return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+static void bits_set(uint64_t* bits, const int index) {
+  bits[index / 64] |= (uint64_t) 1 << (index % 64);
+}
+
+static void bits_xor(uint64_t* target, const uint64_t* source) {
+  for (int word = 0; word < BITS_WORDS; word++) target[word] ^= source[word];
+}
+
+static int bits_invert(
+  const int n,
+  uint64_t (*rows)[BITS_WORDS],
+  uint64_t (*inverse)[BITS_WORDS]
+) {
+  // Gauss-Jordan elimination over GF(2), returning 0 if rows are singular:
+  for (int row = 0; row < n; row++) {
+    memset(inverse[row], 0, BITS_WORDS * sizeof(uint64_t));
+    bits_set(inverse[row], row);
+  }
+  for (int column = 0; column < n; column++) {
+    int pivot = column;
+    while (pivot < n && !bits_get(rows[pivot], column)) pivot++;
+    if (pivot == n) return 0;
+    if (pivot != column) {
+      uint64_t swap[BITS_WORDS];
+      memcpy(swap, rows[pivot], sizeof(swap));
+      memcpy(rows[pivot], rows[column], sizeof(swap));
+      memcpy(rows[column], swap, sizeof(swap));
+      memcpy(swap, inverse[pivot], sizeof(swap));
+      memcpy(inverse[pivot], inverse[column], sizeof(swap));
+      memcpy(inverse[column], swap, sizeof(swap));
+    }
+    // Gather the rows to eliminate without branching on the bits (which would
+    // be mispredicted half the time), and then eliminate them:
+    const int word = column / 64;
+    const int shift = column % 64;
+    int eliminate[MAX_K * MAX_W];
+    int count = 0;
+    for (int row = 0; row < n; row++) {
+      eliminate[count] = row;
+      count += (int) ((rows[row][word] >> shift) & 1) & (row != column);
+    }
+    for (int index = 0; index < count; index++) {
+      const int row = eliminate[index];
+      // Words before this column are zero in the pivot row:
+      for (int bits = word; bits < BITS_WORDS; bits++) {
+        rows[row][bits] ^= rows[column][bits];
+      }
+      bits_xor(inverse[row], inverse[column]);
+    }
+  }
+  return 1;
+}
+
+static void create_bitmatrix_decoding_invert(
+  uint8_t* source,
+  uint8_t* target,
+  const int rows
+) {
+  // Invert with rows packed into 64-bit words, rather than a byte per bit.
+  // The inverse is unique, so the result is the same as by any other method:
+  assert(rows <= MAX_K * MAX_W);
+  uint64_t packed[MAX_K * MAX_W][BITS_WORDS];
+  uint64_t inverse[MAX_K * MAX_W][BITS_WORDS];
+  for (int r = 0; r < rows; r++) {
+    memset(packed[r], 0, sizeof(packed[r]));
+    for (int c = 0; c < rows; c++) {
+      if (source[r * rows + c]) bits_set(packed[r], c);
+    }
+  }
+  const int invertible = bits_invert(rows, packed, inverse);
+  // Assert that matrix is invertible:
+  assert(invertible);
+  (void) invertible;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < rows; c++) {
+      target[r * rows + c] = bits_get(inverse[r], c);
+    }
+  }
+}
+
+static int create_bitmatrix_decoding_field(
+  const int w,
+  const int k,
+  const int m,
+  const int* sourceIndex,
+  const uint8_t* source,
+  uint8_t* target
+) {
+  // Invert the k x k matrix over GF(2^w) and expand the inverse to bits, which
+  // is much cheaper than inverting the (k * w) x (k * w) bitmatrix. Expansion
+  // to bits preserves products and sums, so the result is the same. Returns 0
+  // if the bitmatrix is not the expansion of a matrix over the field of the
+  // PARAMETERS for (k, m), in which case the caller must invert the bitmatrix:
+  if (PARAMETERS[k - 1][m - 1][2] != w) return 0;
+  const int p = PARAMETERS[k - 1][m - 1][3];
+  const int kw = k * w;
+  const int kww = k * w * w;
+  int log[1 << MAX_W];
+  int exp[1 << MAX_W];
+  create_tables_field(w, p, log, exp);
+  int matrix[MAX_K][MAX_K];
+  int inverse[MAX_K][MAX_K];
+  for (int r = 0; r < k; r++) {
+    for (int c = 0; c < k; c++) {
+      inverse[r][c] = r == c ? 1 : 0;
+      if (sourceIndex[r] < k) {
+        matrix[r][c] = sourceIndex[r] == c ? 1 : 0;
+        continue;
+      }
+      // Column 0 of the block of an element x holds the bits of x:
+      const uint8_t* block = source + kww * (sourceIndex[r] - k) + w * c;
+      int x = 0;
+      for (int b = 0; b < w; b++) x |= block[kw * b] << b;
+      matrix[r][c] = x;
+      // Column a holds the bits of x * 2^a:
+      for (int a = 0; a < w; a++) {
+        for (int b = 0; b < w; b++) {
+          if (block[a + kw * b] != ((x >> b) & 1)) return 0;
+        }
+        x = g_multiply(log, exp, w, x, 2);
+      }
+    }
+  }
+  for (int c = 0; c < k; c++) {
+    int pivot = c;
+    while (pivot < k && matrix[pivot][c] == 0) pivot++;
+    // Assert that matrix is invertible:
+    assert(pivot != k);
+    if (pivot == k) return 0;
+    for (int a = 0; a < k; a++) {
+      int swap = matrix[c][a];
+      matrix[c][a] = matrix[pivot][a];
+      matrix[pivot][a] = swap;
+      swap = inverse[c][a];
+      inverse[c][a] = inverse[pivot][a];
+      inverse[pivot][a] = swap;
+    }
+    const int divisor = matrix[c][c];
+    if (divisor != 1) {
+      for (int a = 0; a < k; a++) {
+        matrix[c][a] = g_divide(log, exp, w, matrix[c][a], divisor);
+        inverse[c][a] = g_divide(log, exp, w, inverse[c][a], divisor);
+      }
+    }
+    for (int r = 0; r < k; r++) {
+      const int factor = matrix[r][c];
+      if (r == c || factor == 0) continue;
+      for (int a = 0; a < k; a++) {
+        matrix[r][a] ^= g_multiply(log, exp, w, factor, matrix[c][a]);
+        inverse[r][a] ^= g_multiply(log, exp, w, factor, inverse[c][a]);
+      }
+    }
+  }
+  for (int r = 0; r < k; r++) {
+    for (int c = 0; c < k; c++) {
+      int x = inverse[r][c];
+      for (int a = 0; a < w; a++) {
+        for (int b = 0; b < w; b++) {
+          target[(r * w + b) * kw + w * c + a] = (x >> b) & 1;
+        }
+        x = g_multiply(log, exp, w, x, 2);
+      }
+    }
+  }
+  return 1;
+}
+
+static void create_bitmatrix_decoding(
+  const int w,
+  const int k,
+  const int m,
+  const int* sourceIndex,
+  const uint8_t* source,
+  uint8_t* target
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(m >= 1);
+  assert(m <= MAX_M);
+  assert(k + m <= (1 << w));
+  if (create_bitmatrix_decoding_field(w, k, m, sourceIndex, source, target)) {
+    return;
+  }
+  const int kww = k * w * w;
+  uint8_t matrix[MAX_K * MAX_K * MAX_W * MAX_W];
+  for (int a = 0; a < k; a++) {
+    if (sourceIndex[a] < k) {
+      for (int b = 0; b < kww; b++) matrix[kww * a + b] = 0;
+      int index = kww * a + sourceIndex[a] * w;
+      for (int b = 0; b < w; b++) {
+        matrix[index] = 1;
+        index += (k * w + 1);
+      }
+    } else {
+      for (int b = 0; b < kww; b++) {
+        matrix[kww * a + b] = source[kww * (sourceIndex[a] - k) + b];
+      }
+    }
+  }
+  create_bitmatrix_decoding_invert(matrix, target, k * w);
+}
+
+static int create_bitmatrix_encoding(
+  const int* log,
+  const int* exp,
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* matrix,
+  uint8_t* bitmatrix
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(m >= 1);
+  assert(m <= MAX_M);
+  assert(k + m <= (1 << w));
+  int count = 0;
+  for (int r = 0; r < m; r++) {
+    for (int c = 0; c < k; c++) {
+      int x = matrix[(k * r) + c];
+      for (int a = 0; a < w; a++) {
+        for (int b = 0; b < w; b++) {
+          int y = (x & (1 << b)) ? 1 : 0;
+          bitmatrix[(r * w * k * w) + (w * c) + a + (k * w * b)] = y;
+          count += y;
+        }
+        x = g_multiply(log, exp, w, x, 2);
+      }
+    }
+  }
+  assert(count > 0);
+  return count;
+}
+
+static int create_matrix(
+  const int* log,
+  const int* exp,
+  const int* bit,
+  const int* min,
+  const int w,
+  const int k,
+  const int m,
+  const int x,
+  const int y,
+  uint8_t* matrix
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(m >= 1);
+  assert(m <= MAX_M);
+  assert(k + m <= (1 << w));
+  const int z = 1 << w;
+  (void) z; // Used only by asserts.
+  int count = bit[1] * k;
+  if (m == 1) {
+    // Use XOR for row 0.
+    assert(x == -1);
+    assert(y == -1);
+    for (int c = 0; c < k; c++) matrix[c] = 1;
+  } else if (m == 2) {
+    // Use XOR for row 0.
+    // Use integers with least number of bits for row 1.
+    assert(x == -1);
+    assert(y == -1);
+    for (int c = 0; c < k; c++) matrix[c] = 1;
+    for (int c = 0; c < k; c++) {
+      matrix[k + c] = min[c + 1];
+      if (c == 0) assert(matrix[k + c] == 1);
+      assert(matrix[k + c] > 0);
+      count += bit[matrix[k + c]];
+    }
+  } else {
+    // Use XOR for row 0.
+    // Use generic matrix thereafter.
+    assert(x + k <= z);
+    assert(y + m <= z);
+    assert(x != y);
+    if (x < y) {
+      assert(x + k <= y);
+    } else {
+      assert(y + m <= x);
+    }
+    for (int r = 0; r < m; r++) {
+      for (int c = 0; c < k; c++) {
+        assert(y + r < z);
+        assert(x + c < z);
+        matrix[r * k + c] = g_divide(log, exp, w, 1, (y + r) ^ (x + c));
+      }
+    }
+    // Divide rows by row 0:
+    for (int r = 1; r < m; r++) {
+      for (int c = 0; c < k; c++) {
+        matrix[r * k + c] = g_divide(log, exp, w, matrix[r * k + c], matrix[c]);
+      }
+    }
+    // Divide row 0 by itself to set row 0 to 1:
+    for (int c = 0; c < k; c++) {
+      matrix[c] = g_divide(log, exp, w, matrix[c], matrix[c]);
+      assert(matrix[c] == 1);
+    }
+    // Divide columns by the column which minimizes the resulting ones (if any):
+    for (int r = 1; r < m; r++) {
+      const int rk = r * k;
+      int result = 0;
+      int column = -1;
+      for (int c = 0; c < k; c++) result += bit[matrix[rk + c]];
+      for (int c = 0; c < k; c++) {
+        int bits = 0;
+        for (int d = 0; d < k; d++) {
+          bits += bit[g_divide(log, exp, w, matrix[rk + d], matrix[rk + c])];
+        }
+        if (bits < result) {
+          result = bits;
+          column = matrix[rk + c];
+        }
+      }
+      if (column >= 0) {
+        for (int c = 0; c < k; c++) {
+          matrix[rk + c] = g_divide(log, exp, w, matrix[rk + c], column);
+        }
+      }
+      count += result;
+    }
+  }
+  for (int c = 0; c < k; c++) assert(matrix[c] == 1);
+  assert(count > 0);
+  return count;
+}
+
+static int create_tables_bits(
+  const int* log,
+  const int* exp,
+  const int w,
+  int n
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  int count = 0;
+  for (int r = 0; r < w; r++) {
+    for (int c = 0; c < w; c++) {
+      count += (n & (1 << c)) ? 1 : 0;
+    }
+    n = g_multiply(log, exp, w, n, 2);
+  }
+  return count;
+}
+
+static void create_tables(
+  const int w,
+  const int p,
+  int* log,
+  int* exp,
+  int* bit,
+  int* min
+) {
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  const int y = (1 << w) - 1;
+  (void) y; // Used only by asserts.
+  const int z = (1 << w);
+  create_tables_field(w, p, log, exp);
+  // Generate bit table (number of bits per matrix number):
+  for (int n = 0; n < z; n++) {
+    bit[n] = create_tables_bits(log, exp, w, n);
+    if (n == 0) {
+      assert(bit[n] == 0);
+    } else {
+      assert(bit[n] > 0);
+    }
+  }
+  // Generate min table (matrix numbers sorted by least number of bits):
+  assert(bit[0] == 0);
+  min[0] = 0;
+  for (int a = 1; a < z; a++) {
+    assert(a > 0);
+    int c = min[a - 1];
+    int d = -1;
+    for (int b = 1; b < z; b++) {
+      assert(b > 0);
+      assert(bit[b] > 0);
+      if (bit[b] < bit[c]) continue;
+      if (bit[b] == bit[c] && b <= c) continue;
+      if (d == -1 || bit[b] < bit[d]) d = b;
+    }
+    assert(d > 0);
+    assert(d < z);
+    min[a] = d;
+  }
+  assert(min[y] > 0);
+}
+
+static uintptr_t unaligned64(const uint8_t* pointer) {
+  return ((uintptr_t) pointer) & ((uintptr_t) 7);
+}
+
+static uint32_t dot_chunk_size(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+) {
+  // Every dot loop pair (b * k, c * w) uses ((1 + k * w) * chunkSize) of cache.
+  // Avoiding cache misses yields a 40-100% improvement when shardSize is large.
+  // We therefore reduce the chunkSize if necessary to stay within the cache.
+  // The shardSize should ideally be a power of 2 to do this optimally.
+  // N.B. The chunkSize changes the encoded parity result.
+  KERNEL_ASSERT(w <= MAX_W);
+  KERNEL_ASSERT(w == 2 || w == 4 || w == 8);
+  KERNEL_ASSERT(k >= 1);
+  KERNEL_ASSERT(k <= MAX_K);
+  KERNEL_ASSERT(k < (1 << w));
+  KERNEL_ASSERT(shardSize % w == 0);
+  uint32_t chunkSize = shardSize / w;
+  while (
+    chunkSize > 64 &&
+    chunkSize % 2 == 0 &&
+    (uint64_t) (1 + k * w) * chunkSize > 1048576
+  ) {
+    chunkSize /= 2;
+  }
+  KERNEL_ASSERT(chunkSize > 0);
+  KERNEL_ASSERT(shardSize % (w * chunkSize) == 0);
+  return chunkSize;
+}
+
+static void dot_cpy(uint8_t* source, uint8_t* target, uint32_t length) {
+  KERNEL_ASSERT(length > 0);
+  KERNEL_ASSERT(source != target);
+  memcpy(target, source, length);
+}
+
+static void dot_xor(uint8_t* source, uint8_t* target, uint32_t length) {
+  KERNEL_ASSERT(source != target);
+  KERNEL_ASSERT(length > 0);
+  uint8_t* sourceEnd = source + length;
+  uint8_t* targetEnd = target + length;
+  // XOR 8-bit words if source and target alignment cannot be corrected:
+  if (unaligned64(source) != unaligned64(target)) {
+    while (length > 0) {
+      *target++ ^= *source++;
+      length--;
+    }
+    KERNEL_ASSERT(source == sourceEnd);
+    KERNEL_ASSERT(target == targetEnd);
+    KERNEL_ASSERT(length == 0);
+    return;
+  }
+  // XOR 8-bit words to correct source and target alignment:
+  while (unaligned64(source) && length > 0) {
+    *target++ ^= *source++;
+    length--;
+  }
+  if (length == 0) {
+    KERNEL_ASSERT(source == sourceEnd);
+    KERNEL_ASSERT(target == targetEnd);
+    return;
+  }
+  KERNEL_ASSERT(unaligned64(source) == 0);
+  KERNEL_ASSERT(unaligned64(target) == 0);
+  // XOR as many 64-bit words as possible:
+  uint32_t words = length / 8;
+  if (words > 0) {
+    uint32_t width = words * 8;
+    KERNEL_ASSERT(width <= length);
+    uint64_t* source64 = (uint64_t*) source;
+    uint64_t* target64 = (uint64_t*) target;
+    while (words > 0) {
+      *target64++ ^= *source64++;
+      words--;
+    }
+    KERNEL_ASSERT(words == 0);
+    source += width;
+    target += width;
+    length -= width;
+  }
+  // XOR 8-bit words remainder:
+  KERNEL_ASSERT(length < 8);
+  while (length > 0) {
+    *target++ ^= *source++;
+    length--;
+  }
+  KERNEL_ASSERT(source == sourceEnd);
+  KERNEL_ASSERT(target == targetEnd);
+  KERNEL_ASSERT(length == 0);
+}
+
+// dot_combine() accumulates four vectors of each source in registers at a
+// time (of 16 bytes, or 32 bytes where the CPU supports AVX2), and falls back
+// to 64-bit words where the compiler has no vector extensions. Vectors may be
+// loaded from any alignment and may alias the bytes of shards:
+#if defined(__GNUC__)
+  #define DOT_VECTORS 1
+  typedef uint64_t dot_vector16
+    __attribute__((vector_size(16), aligned(1), may_alias));
+  typedef uint64_t dot_vector32
+    __attribute__((vector_size(32), aligned(1), may_alias));
+#else
+  #define DOT_VECTORS 0
+#endif
+
+#if DOT_VECTORS && defined(__x86_64__)
+  #define DOT_AVX2 1
+#else
+  #define DOT_AVX2 0
+#endif
+
+// Writes the XOR of count sources to target for as many whole blocks (of four
+// vectors) as fit in length, returning the number of bytes written. Each block
+// of every source is loaded into accumulators and each block of target is
+// stored once, instead of a copy followed by count - 1 passes over target:
+#define DOT_COMBINE_BLOCKS(TYPE)                                               \
+  uint32_t offset = 0;                                                         \
+  for (; offset + 4 * sizeof(TYPE) <= length; offset += 4 * sizeof(TYPE)) {    \
+    const TYPE* source = (const TYPE*) (sources[0] + offset);                  \
+    TYPE a0 = source[0];                                                       \
+    TYPE a1 = source[1];                                                       \
+    TYPE a2 = source[2];                                                       \
+    TYPE a3 = source[3];                                                       \
+    for (int index = 1; index < count; index++) {                              \
+      source = (const TYPE*) (sources[index] + offset);                        \
+      a0 ^= source[0];                                                         \
+      a1 ^= source[1];                                                         \
+      a2 ^= source[2];                                                         \
+      a3 ^= source[3];                                                         \
+    }                                                                          \
+    TYPE* block = (TYPE*) (target + offset);                                   \
+    block[0] = a0;                                                             \
+    block[1] = a1;                                                             \
+    block[2] = a2;                                                             \
+    block[3] = a3;                                                             \
+  }                                                                            \
+  return offset;
+
+#if DOT_AVX2
+__attribute__((target("avx2")))
+static uint32_t dot_combine_avx2(
+  uint8_t* const* sources,
+  const int count,
+  uint8_t* target,
+  const uint32_t length
+) {
+  DOT_COMBINE_BLOCKS(dot_vector32)
+}
+#endif
+
+static uint32_t dot_combine_blocks(
+  uint8_t* const* sources,
+  const int count,
+  uint8_t* target,
+  const uint32_t length
+) {
+  #if DOT_VECTORS
+    DOT_COMBINE_BLOCKS(dot_vector16)
+  #else
+    // Words are XORed one at a time, through memcpy() for any alignment:
+    uint32_t offset = 0;
+    for (; offset + 8 <= length; offset += 8) {
+      uint64_t accumulator;
+      memcpy(&accumulator, sources[0] + offset, 8);
+      for (int index = 1; index < count; index++) {
+        uint64_t word;
+        memcpy(&word, sources[index] + offset, 8);
+        accumulator ^= word;
+      }
+      memcpy(target + offset, &accumulator, 8);
+    }
+    return offset;
+  #endif
+}
+
+static void dot_combine(
+  uint8_t* const* sources,
+  const int count,
+  uint8_t* target,
+  const uint32_t length
+) {
+  // Writes the XOR of count sources to target in a single pass:
+  KERNEL_ASSERT(count >= 2);
+  KERNEL_ASSERT(count <= MAX_K * MAX_W);
+  KERNEL_ASSERT(length > 0);
+  uint32_t offset = 0;
+  #if DOT_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+      offset = dot_combine_avx2(sources, count, target, length);
+    } else {
+      offset = dot_combine_blocks(sources, count, target, length);
+    }
+  #else
+    offset = dot_combine_blocks(sources, count, target, length);
+  #endif
+  for (; offset < length; offset++) {
+    uint8_t byte = sources[0][offset];
+    for (int index = 1; index < count; index++) byte ^= sources[index][offset];
+    target[offset] = byte;
+  }
+}
+
+static uint32_t dot_clip(
+  const uint32_t length,
+  const uint32_t offset,
+  const uint32_t size
+) {
+  // Returns the number of bytes of [offset, offset + size) within a shard.
+  // Bytes beyond the length of a shard are virtual zero padding.
+  if (offset >= length) return 0;
+  if (length - offset < size) return length - offset;
+  return size;
+}
+
+static void dot_cpy_padded(
+  uint8_t* source,
+  const uint32_t sourceLength,
+  uint8_t* target,
+  const uint32_t targetLength
+) {
+  // Copy source to target, zero-filling where source has virtual padding:
+  const uint32_t length = sourceLength < targetLength ?
+    sourceLength : targetLength;
+  if (length > 0) dot_cpy(source, target, length);
+  if (length < targetLength) memset(target + length, 0, targetLength - length);
+}
+
+static void dot_xor_padded(
+  uint8_t* source,
+  const uint32_t sourceLength,
+  uint8_t* target,
+  const uint32_t targetLength
+) {
+  // XOR source into target, skipping virtual padding (XOR with 0 is a no-op):
+  const uint32_t length = sourceLength < targetLength ?
+    sourceLength : targetLength;
+  if (length > 0) dot_xor(source, target, length);
+}
+
+static void dot_combine_padded(
+  uint8_t* const* sources,
+  const uint32_t* sourceLengths,
+  const int count,
+  uint8_t* target,
+  const uint32_t targetLength
+) {
+  // Writes the XOR of count sources to target, where sources may be short and
+  // are padded virtually with zeroes, in as many passes as distinct lengths:
+  KERNEL_ASSERT(count >= 1);
+  uint8_t* pieces[MAX_K * MAX_W];
+  uint32_t offset = 0;
+  while (offset < targetLength) {
+    uint32_t end = targetLength;
+    int pieceCount = 0;
+    for (int index = 0; index < count; index++) {
+      if (sourceLengths[index] <= offset) continue;
+      if (sourceLengths[index] < end) end = sourceLengths[index];
+      pieces[pieceCount++] = sources[index] + offset;
+    }
+    if (pieceCount == 0) {
+      memset(target + offset, 0, targetLength - offset);
+      return;
+    }
+    if (pieceCount == 1) {
+      dot_cpy(pieces[0], target + offset, end - offset);
+    } else {
+      dot_combine(pieces, pieceCount, target + offset, end - offset);
+    }
+    offset = end;
+  }
+}
+
+#if defined(_MSC_VER)
+  #define ALWAYS_INLINE static __forceinline
+#elif defined(__GNUC__)
+  #define ALWAYS_INLINE static inline __attribute__((always_inline))
+#else
+  #define ALWAYS_INLINE static inline
+#endif
+
+ALWAYS_INLINE void dot_body(
+  const int w,
+  const int k,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t chunkSize,
+  const uint32_t shardSize,
+  const uint8_t* row,
+  const int* sourceIndex,
+  const int targetIndex
+) {
+  KERNEL_ASSERT(w <= MAX_W);
+  KERNEL_ASSERT(w == 2 || w == 4 || w == 8);
+  KERNEL_ASSERT(k >= 1);
+  KERNEL_ASSERT(k <= MAX_K);
+  KERNEL_ASSERT(k < (1 << w));
+  KERNEL_ASSERT(chunkSize > 0);
+  KERNEL_ASSERT(shardSize % (w * chunkSize) == 0);
+  uint32_t shardOffset = 0;
+  while (shardOffset < shardSize) {
+    int column = 0;
+    for (int a = 0; a < w; a++) {
+      uint32_t targetOffset = shardOffset + a * chunkSize;
+      uint32_t targetLength = dot_clip(
+        shardLengths[targetIndex],
+        targetOffset,
+        chunkSize
+      );
+      if (targetLength == 0) {
+        // The target chunk is entirely virtual padding:
+        column += k * w;
+        continue;
+      }
+      uint8_t* target = shards[targetIndex] + targetOffset;
+      // The source chunks of every one in the row, combined in one pass:
+      uint8_t* chunks[MAX_K * MAX_W];
+      uint32_t chunkLengths[MAX_K * MAX_W];
+      int count = 0;
+      for (int b = 0; b < k; b++) {
+        uint8_t* source = shards[sourceIndex[b]];
+        uint32_t sourceLength = shardLengths[sourceIndex[b]];
+        for (int c = 0; c < w; c++) {
+          if (row[column]) {
+            uint32_t sourceOffset = shardOffset + c * chunkSize;
+            chunks[count] = source + sourceOffset;
+            chunkLengths[count] = dot_clip(sourceLength, sourceOffset,
+              chunkSize);
+            count++;
+          }
+          column++;
+        }
+      }
+      if (count > 0) {
+        dot_combine_padded(chunks, chunkLengths, count, target, targetLength);
+      }
+    }
+    shardOffset += w * chunkSize;
+  }
+  KERNEL_ASSERT(shardOffset == shardSize);
+}
+
+typedef void (*dot_kernel)(
+  const int w,
+  const int k,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t chunkSize,
+  const uint32_t shardSize,
+  const uint8_t* row,
+  const int* sourceIndex,
+  const int targetIndex
+);
+
+static void dot(
+  const int w,
+  const int k,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t chunkSize,
+  const uint32_t shardSize,
+  const uint8_t* row,
+  const int* sourceIndex,
+  const int targetIndex
+) {
+  dot_body(
+    w,
+    k,
+    shards,
+    shardLengths,
+    chunkSize,
+    shardSize,
+    row,
+    sourceIndex,
+    targetIndex
+  );
+}
+
+// Geometries (w, k) for which dot() is specialized, so that the compiler can
+// unroll loops over w and k and keep source pointers in registers. These are
+// the geometries which create() chooses for 6+3, 10+4 and 12+4. Define
+// DOT_GEOMETRIES when compiling to specialize for other geometries, e.g.
+// -D'DOT_GEOMETRIES(X)=X(4, 6) X(8, 20)':
+#ifndef DOT_GEOMETRIES
+  #define DOT_GEOMETRIES(X)                                                    \
+    X(4, 6)                                                                    \
+    X(4, 10)                                                                   \
+    X(4, 12)
+#endif
+
+#define DOT_SPECIALIZE(W, K)                                                   \
+  static void dot_w##W##_k##K(                                                 \
+    const int w,                                                               \
+    const int k,                                                               \
+    uint8_t** shards,                                                          \
+    const uint32_t* shardLengths,                                              \
+    const uint32_t chunkSize,                                                  \
+    const uint32_t shardSize,                                                  \
+    const uint8_t* row,                                                        \
+    const int* sourceIndex,                                                    \
+    const int targetIndex                                                      \
+  ) {                                                                          \
+    KERNEL_ASSERT(w == W);                                                     \
+    KERNEL_ASSERT(k == K);                                                     \
+    dot_body(                                                                  \
+      W,                                                                       \
+      K,                                                                       \
+      shards,                                                                  \
+      shardLengths,                                                            \
+      chunkSize,                                                               \
+      shardSize,                                                               \
+      row,                                                                     \
+      sourceIndex,                                                             \
+      targetIndex                                                              \
+    );                                                                         \
+  }
+
+DOT_GEOMETRIES(DOT_SPECIALIZE)
+
+#define DOT_SELECT(W, K)                                                       \
+  if (w == W && k == K) return dot_w##W##_k##K;
+
+static dot_kernel dot_select(const int w, const int k) {
+  // Called once per encode, since the kernel depends only on w and k:
+  DOT_GEOMETRIES(DOT_SELECT)
+  return dot;
+}
+
+// An optional JIT (x86-64 Linux only) which compiles a row of a bitmatrix
+// into straight-line AVX2 (or SSE2) code, which loads each source chunk once
+// per block into a register and XORs it into as many as w accumulators. Rows
+// are fixed per context (and per erasure pattern when decoding), so compiled
+// rows are cached, keyed by their contents, and are never freed. Regions of a
+// stripe which include virtual padding use the portable kernel.
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)
+  #define JIT_SUPPORTED 1
+#else
+  #define JIT_SUPPORTED 0
+#endif
+
+#if JIT_SUPPORTED
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+typedef void (*jit_function)(
+  uint8_t* const* sources,
+  uint8_t* const* targets,
+  uint64_t size
+);
+
+// The number of rows which may be compiled (beyond which rows are interpreted):
+#define JIT_SLOTS 4096
+#define JIT_LIMIT 3072
+
+struct jit_entry {
+  int w;
+  int k;
+  uint8_t* row;
+  jit_function function;
+};
+
+static struct {
+  int enabled;
+  int avx2;
+  uint32_t count;
+  struct jit_entry entries[JIT_SLOTS];
+} jit;
+
+#if JIT_SUPPORTED
+
+// Serializes compiling (jit.entries are read without it):
+static pthread_mutex_t jit_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t jit_once = PTHREAD_ONCE_INIT;
+
+static void jit_init(void) {
+  jit.avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+struct jit_code {
+  uint8_t* bytes;
+  size_t size;
+  size_t capacity;
+};
+
+static void jit_emit(struct jit_code* code, const uint8_t* bytes, size_t size) {
+  assert(code->size + size <= code->capacity);
+  memcpy(code->bytes + code->size, bytes, size);
+  code->size += size;
+}
+
+#define JIT_EMIT(code, ...)                                                    \
+  jit_emit(                                                                    \
+    (code),                                                                    \
+    (const uint8_t[]) { __VA_ARGS__ },                                         \
+    sizeof((const uint8_t[]) { __VA_ARGS__ })                                  \
+  )
+
+static void jit_emit_pointer(
+  struct jit_code* code,
+  const int targets,
+  const int index
+) {
+  // mov r8, [rdi + 8 * index] (sources) or mov r8, [rsi + 8 * index] (targets):
+  const uint32_t offset = 8 * index;
+  JIT_EMIT(
+    code,
+    0x4C,
+    0x8B,
+    targets ? 0x86 : 0x87,
+    offset & 0xFF,
+    (offset >> 8) & 0xFF,
+    (offset >> 16) & 0xFF,
+    (offset >> 24) & 0xFF
+  );
+}
+
+static void jit_emit_load(struct jit_code* code) {
+  // vmovdqu ymm15, [r8 + rax] or movdqu xmm15, [r8 + rax]:
+  if (jit.avx2) {
+    JIT_EMIT(code, 0xC4, 0x41, 0x7E, 0x6F, 0x3C, 0x00);
+  } else {
+    JIT_EMIT(code, 0xF3, 0x45, 0x0F, 0x6F, 0x3C, 0x00);
+  }
+}
+
+static void jit_emit_move(struct jit_code* code, const int a) {
+  // vmovdqa ymm(a), ymm15 or movdqa xmm(a), xmm15:
+  if (jit.avx2) {
+    JIT_EMIT(code, 0xC4, 0xC1, 0x7D, 0x6F, 0xC7 | (a << 3));
+  } else {
+    JIT_EMIT(code, 0x66, 0x41, 0x0F, 0x6F, 0xC7 | (a << 3));
+  }
+}
+
+static void jit_emit_xor(struct jit_code* code, const int a) {
+  // vpxor ymm(a), ymm(a), ymm15 or pxor xmm(a), xmm15:
+  if (jit.avx2) {
+    JIT_EMIT(code, 0xC4, 0xC1, ((~a & 15) << 3) | 0x05, 0xEF, 0xC7 | (a << 3));
+  } else {
+    JIT_EMIT(code, 0x66, 0x41, 0x0F, 0xEF, 0xC7 | (a << 3));
+  }
+}
+
+static void jit_emit_store(struct jit_code* code, const int a) {
+  // vmovdqu [r8 + rax], ymm(a) or movdqu [r8 + rax], xmm(a):
+  if (jit.avx2) {
+    JIT_EMIT(code, 0xC4, 0xC1, 0x7E, 0x7F, 0x04 | (a << 3), 0x00);
+  } else {
+    JIT_EMIT(code, 0xF3, 0x41, 0x0F, 0x7F, 0x04 | (a << 3), 0x00);
+  }
+}
+
+static jit_function jit_compile(const int w, const int k, const uint8_t* row) {
+  const int kw = k * w;
+  const size_t bound = (size_t) kw * (13 + 5 * w) + 13 * w + 64;
+  const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  struct jit_code code;
+  code.size = 0;
+  code.capacity = (bound + page - 1) / page * page;
+  code.bytes = mmap(
+    NULL,
+    code.capacity,
+    PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS,
+    -1,
+    0
+  );
+  if (code.bytes == MAP_FAILED) return NULL;
+  JIT_EMIT(&code, 0x31, 0xC0); // xor eax, eax
+  const size_t loop = code.size;
+  int copied[MAX_W] = { 0 };
+  for (int j = 0; j < kw; j++) {
+    int used = 0;
+    for (int a = 0; a < w; a++) used |= row[a * kw + j];
+    if (!used) continue;
+    jit_emit_pointer(&code, 0, j);
+    jit_emit_load(&code);
+    for (int a = 0; a < w; a++) {
+      if (!row[a * kw + j]) continue;
+      if (!copied[a]) {
+        jit_emit_move(&code, a);
+        copied[a] = 1;
+      } else {
+        jit_emit_xor(&code, a);
+      }
+    }
+  }
+  // Targets with no sources are left untouched, as by dot():
+  for (int a = 0; a < w; a++) {
+    if (!copied[a]) continue;
+    jit_emit_pointer(&code, 1, a);
+    jit_emit_store(&code, a);
+  }
+  JIT_EMIT(&code, 0x48, 0x83, 0xC0, jit.avx2 ? 32 : 16); // add rax, block
+  JIT_EMIT(&code, 0x48, 0x39, 0xD0); // cmp rax, rdx
+  const int32_t jump = (int32_t) loop - (int32_t) (code.size + 6);
+  JIT_EMIT(
+    &code,
+    0x0F,
+    0x82, // jb loop
+    jump & 0xFF,
+    (jump >> 8) & 0xFF,
+    (jump >> 16) & 0xFF,
+    (jump >> 24) & 0xFF
+  );
+  if (jit.avx2) JIT_EMIT(&code, 0xC5, 0xF8, 0x77); // vzeroupper
+  JIT_EMIT(&code, 0xC3); // ret
+  if (mprotect(code.bytes, code.capacity, PROT_READ | PROT_EXEC) != 0) {
+    munmap(code.bytes, code.capacity);
+    return NULL;
+  }
+  return (jit_function) (uintptr_t) code.bytes;
+}
+
+#endif
+
+static jit_function jit_find(const int w, const int k, const uint8_t* row) {
+  // Returns the compiled row (compiling it if need be), or NULL:
+  #if JIT_SUPPORTED
+    pthread_once(&jit_once, jit_init);
+    const int size = k * w * w;
+    uint32_t hash = 2166136261u ^ (uint32_t) (w << 8 | k);
+    for (int index = 0; index < size; index++) {
+      hash = (hash ^ row[index]) * 16777619u;
+    }
+    // Entries are published (their row last) and never removed, so that a row
+    // which has been compiled is found without taking the lock:
+    uint32_t slot = hash % JIT_SLOTS;
+    for (;;) {
+      struct jit_entry* entry = &jit.entries[slot];
+      const uint8_t* copy = __atomic_load_n(&entry->row, __ATOMIC_ACQUIRE);
+      if (copy == NULL) break;
+      if (entry->w == w && entry->k == k && memcmp(copy, row, size) == 0) {
+        return entry->function;
+      }
+      slot = (slot + 1) % JIT_SLOTS;
+    }
+    // Rows beyond the limit are interpreted, without taking the lock:
+    if (__atomic_load_n(&jit.count, __ATOMIC_RELAXED) >= JIT_LIMIT) return NULL;
+    // Continue probing under the lock, in case another thread has compiled the
+    // row in the meantime:
+    jit_function function = NULL;
+    pthread_mutex_lock(&jit_mutex);
+    while (jit.entries[slot].row != NULL) {
+      struct jit_entry* entry = &jit.entries[slot];
+      if (
+        entry->w == w &&
+        entry->k == k &&
+        memcmp(entry->row, row, size) == 0
+      ) {
+        function = entry->function;
+        pthread_mutex_unlock(&jit_mutex);
+        return function;
+      }
+      slot = (slot + 1) % JIT_SLOTS;
+    }
+    if (jit.count < JIT_LIMIT) {
+      uint8_t* copy = malloc(size);
+      if (copy) {
+        memcpy(copy, row, size);
+        function = jit_compile(w, k, row);
+        // Cache failures too, to avoid compiling the row again:
+        jit.entries[slot].w = w;
+        jit.entries[slot].k = k;
+        jit.entries[slot].function = function;
+        __atomic_store_n(&jit.entries[slot].row, copy, __ATOMIC_RELEASE);
+        __atomic_store_n(&jit.count, jit.count + 1, __ATOMIC_RELAXED);
+      }
+    }
+    pthread_mutex_unlock(&jit_mutex);
+    return function;
+  #else
+    (void) w;
+    (void) k;
+    (void) row;
+    return NULL;
+  #endif
+}
+
+static jit_function jit_lookup(const int w, const int k, const uint8_t* row) {
+  #if JIT_SUPPORTED
+    if (!__atomic_load_n(&jit.enabled, __ATOMIC_RELAXED)) return NULL;
+  #endif
+  return jit_find(w, k, row);
+}
+
+// The kernel chosen by reed_solomon_calibrate() for each (w, k) and class of
+// shard size (the floor of log2 of the size of the whole shard). Entries are
+// single bytes, read and written without locks, and are 0 (the default kernel)
+// until calibrated:
+#define DISPATCH_CLASSES 32
+
+static volatile uint8_t dispatch_table[3][MAX_K][DISPATCH_CLASSES];
+
+static const char* DISPATCH_NAMES[] = {
+  "default",
+  "generic",
+  "specialized",
+  "jit"
+};
+
+static volatile uint8_t* dispatch_entry(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+) {
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(shardSize > 0);
+  int size = 0;
+  while ((shardSize >> size) > 1) size++;
+  assert(size < DISPATCH_CLASSES);
+  return &dispatch_table[w == 2 ? 0 : w == 4 ? 1 : 2][k - 1][size];
+}
+
+static dot_kernel dispatch_kernel(
+  const int dispatch,
+  const int w,
+  const int k
+) {
+  if (dispatch == REED_SOLOMON_KERNEL_GENERIC) return dot;
+  return dot_select(w, k);
+}
+
+static void dot_tail(
+  const int w,
+  const int k,
+  const uint8_t* row,
+  uint8_t* const* sources,
+  uint8_t* const* targets,
+  const uint32_t offset,
+  const uint32_t chunkSize
+) {
+  // Encode the bytes of each chunk beyond the last whole block of the JIT:
+  const int kw = k * w;
+  const uint32_t length = chunkSize - offset;
+  for (int a = 0; a < w; a++) {
+    uint8_t* chunks[MAX_K * MAX_W];
+    int count = 0;
+    for (int j = 0; j < kw; j++) {
+      if (row[a * kw + j]) chunks[count++] = sources[j] + offset;
+    }
+    if (count == 1) {
+      dot_cpy(chunks[0], targets[a] + offset, length);
+    } else if (count > 1) {
+      dot_combine(chunks, count, targets[a] + offset, length);
+    }
+  }
+}
+
+static void dot_run(
+  const dot_kernel kernel,
+  const int dispatch,
+  const int w,
+  const int k,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t chunkSize,
+  const uint32_t shardSize,
+  const uint8_t* row,
+  const int* sourceIndex,
+  const int targetIndex
+) {
+  jit_function function = NULL;
+  if (dispatch == REED_SOLOMON_KERNEL_JIT) {
+    function = jit_find(w, k, row);
+  } else if (dispatch == REED_SOLOMON_KERNEL_DEFAULT) {
+    function = jit_lookup(w, k, row);
+  }
+  // Read jit.avx2 only once jit_find() has initialized it (through jit_once):
+  const uint32_t block = function != NULL && jit.avx2 ? 32 : 16;
+  const uint32_t bulk = chunkSize - chunkSize % block;
+  if (function == NULL || bulk == 0) {
+    kernel(
+      w,
+      k,
+      shards,
+      shardLengths,
+      chunkSize,
+      shardSize,
+      row,
+      sourceIndex,
+      targetIndex
+    );
+    return;
+  }
+  uint8_t* sources[MAX_K * MAX_W];
+  uint8_t* targets[MAX_W];
+  uint32_t offset = 0;
+  while (offset < shardSize) {
+    const uint32_t end = offset + w * chunkSize;
+    int whole = shardLengths[targetIndex] >= end;
+    for (int b = 0; b < k; b++) {
+      if (shardLengths[sourceIndex[b]] < end) whole = 0;
+    }
+    if (whole) {
+      for (int b = 0; b < k; b++) {
+        for (int c = 0; c < w; c++) {
+          sources[b * w + c] = shards[sourceIndex[b]] + offset + c * chunkSize;
+        }
+      }
+      for (int a = 0; a < w; a++) {
+        targets[a] = shards[targetIndex] + offset + a * chunkSize;
+      }
+      function(sources, targets, bulk);
+      if (bulk < chunkSize) {
+        dot_tail(w, k, row, sources, targets, bulk, chunkSize);
+      }
+    } else {
+      // The region includes virtual padding:
+      uint8_t* regionShards[MAX_K + MAX_M];
+      uint32_t regionLengths[MAX_K + MAX_M];
+      for (int b = 0; b < k; b++) {
+        const int i = sourceIndex[b];
+        regionShards[i] = shards[i] + offset;
+        regionLengths[i] = dot_clip(shardLengths[i], offset, w * chunkSize);
+      }
+      regionShards[targetIndex] = shards[targetIndex] + offset;
+      regionLengths[targetIndex] = dot_clip(
+        shardLengths[targetIndex],
+        offset,
+        w * chunkSize
+      );
+      kernel(
+        w,
+        k,
+        regionShards,
+        regionLengths,
+        chunkSize,
+        w * chunkSize,
+        row,
+        sourceIndex,
+        targetIndex
+      );
+    }
+    offset = end;
+  }
+}
+
+static int flags_count(uint32_t flags) {
+  int count = 0;
+  while (flags > 0) {
+    if (flags & 1) count++; // Check lower bit.
+    flags >>= 1; // Shift lower bit.
+  }
+  return count;
+}
+
+static int flags_first(const uint32_t flags) {
+  int i = 0;
+  while ((flags & (1 << i)) == 0) i++;
+  assert((flags & (1 << i)) != 0);
+  return i;
+}
+
+uint32_t reed_solomon_region_size(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+) {
+  // Shards may be encoded independently in ranges which are multiples of this:
+  return w * dot_chunk_size(w, k, shardSize);
+}
+
+// The parity shards chosen by decode_sources() for each pattern of sources,
+// keyed by a hash of the bitmatrix. Entries are single words, read and written
+// without locks, of [valid:1, tag:27, parities:6, sources:30]. An entry which
+// is stale (or written by another thread) at worst fails to match, or chooses
+// other parities which decode the same data at a higher cost:
+#define DECODE_CACHE_SIZE 1024
+#define DECODE_CACHE_VALID ((uint64_t) 1 << 63)
+
+static volatile uint64_t decode_cache[DECODE_CACHE_SIZE];
+
+static uint64_t decode_hash(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix
+) {
+  // FNV-1a over the geometry and then the bitmatrix, 8 bytes at a time:
+  const uint64_t prime = 1099511628211ULL;
+  uint64_t hash = 14695981039346656037ULL;
+  hash = (hash ^ (uint64_t) ((w << 16) | (k << 8) | m)) * prime;
+  const int size = k * w * m * w;
+  int index = 0;
+  for (; index + 8 <= size; index += 8) {
+    uint64_t word;
+    memcpy(&word, bitmatrix + index, 8);
+    hash = (hash ^ word) * prime;
+  }
+  for (; index < size; index++) hash = (hash ^ bitmatrix[index]) * prime;
+  return hash;
+}
+
+static int decode_cost(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const int max,
+  const int* s
+) {
+  // The ones in the decoding rows of the data shards (before max) to decode,
+  // which is the number of XORs per word of each chunk:
+  uint8_t decoding[MAX_K * MAX_K * MAX_W * MAX_W];
+  create_bitmatrix_decoding(w, k, m, s, bitmatrix, decoding);
+  const int kww = k * w * w;
+  int cost = 0;
+  for (int i = 0; i < max; i++) {
+    if (sources & (1 << i)) continue;
+    for (int b = 0; b < kww; b++) cost += decoding[kww * i + b];
+  }
+  return cost;
+}
+
+static void decode_sources_fill(
+  const int k,
+  const uint32_t sources,
+  const uint32_t parities,
+  int* s
+) {
+  // The surviving data shards and the chosen parity shards, in order:
+  const uint32_t chosen = (sources & ((1 << k) - 1)) | (parities << k);
+  int j = 0;
+  for (int i = 0; j < k; i++) {
+    if (chosen & (1 << i)) s[j++] = i;
+  }
+}
+
+static void decode_sources(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const int max,
+  int* s
+) {
+  // Chooses k of the sources from which to decode. Every surviving data shard
+  // is chosen (its rows of the matrix are the identity) and, where more parity
+  // shards survive than are needed, the parity shards whose decoding rows have
+  // the fewest ones. Ties go to the first parity shards:
+  const uint32_t available = sources >> k;
+  const int needed = k - flags_count(sources & ((1 << k) - 1));
+  assert(needed >= 1);
+  assert(needed <= flags_count(available));
+  if (flags_count(available) == needed) {
+    decode_sources_fill(k, sources, available, s);
+    return;
+  }
+  const uint64_t hash = decode_hash(w, k, m, bitmatrix);
+  const uint64_t tag = hash >> 37;
+  const uint32_t index = (uint32_t) (
+    ((hash ^ sources) * 11400714819323198485ULL) >> 54
+  ) % DECODE_CACHE_SIZE;
+  const uint64_t entry = decode_cache[index];
+  if (
+    (entry & DECODE_CACHE_VALID) &&
+    ((entry >> 36) & ((1 << 27) - 1)) == tag &&
+    (entry & ((1 << 30) - 1)) == sources
+  ) {
+    const uint32_t parities = (uint32_t) (entry >> 30) & 63;
+    if ((parities & ~available) == 0 && flags_count(parities) == needed) {
+      decode_sources_fill(k, sources, parities, s);
+      return;
+    }
+  }
+  // The first parity shards are the smallest flags with as many bits:
+  uint32_t best = 0;
+  int bestCost = INT_MAX;
+  for (uint32_t parities = 1; parities < (1u << m); parities++) {
+    if ((parities & ~available) || flags_count(parities) != needed) continue;
+    decode_sources_fill(k, sources, parities, s);
+    const int cost = decode_cost(w, k, m, bitmatrix, sources, max, s);
+    if (cost < bestCost) {
+      best = parities;
+      bestCost = cost;
+    }
+  }
+  assert(best != 0);
+  decode_cache[index] = DECODE_CACHE_VALID | (tag << 36) |
+    ((uint64_t) best << 30) | sources;
+  decode_sources_fill(k, sources, best, s);
+}
+
+static void shards_range(
+  const int count,
+  uint8_t** shardsWhole,
+  const uint32_t* shardLengthsWhole,
+  const uint32_t offset,
+  const uint32_t size,
+  uint8_t** shards,
+  uint32_t* shardLengths
+) {
+  // Shards (and their lengths) from offset, clipped to size:
+  for (int i = 0; i < count; i++) {
+    shards[i] = shardsWhole[i] + offset;
+    shardLengths[i] = dot_clip(shardLengthsWhole[i], offset, size);
+  }
+}
+
+static void cauchy_encode_range(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrixEncoding,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSizeWhole,
+  const uint32_t offset,
+  const uint32_t shardSize
+) {
+  // Shards start at offset (see shards_range()) into shards of shardSizeWhole:
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(m >= 1);
+  assert(m <= MAX_M);
+  assert(k + m <= (1 << w));
+  // The chunkSize depends on the size of the whole shard and not of the range:
+  const uint32_t chunkSize = dot_chunk_size(w, k, shardSizeWhole);
+  assert(offset % (w * chunkSize) == 0);
+  assert(shardSize % (w * chunkSize) == 0);
+  assert((uint64_t) offset + shardSize <= shardSizeWhole);
+  (void) offset; // Used only by asserts.
+  if (k == 1) {
+    // Optimization for pure replication, encoding only targets:
+    const int s = flags_first(sources);
+    for (int i = 0; i < k + m; i++) {
+      if (targets & (1 << i)) {
+        dot_cpy_padded(shards[s], shardLengths[s], shards[i], shardLengths[i]);
+      }
+    }
+    return;
+  }
+  if (
+    flags_count(targets) == 1 &&
+    flags_count(sources & ((1 << (k + 1)) - 1)) == k &&
+    flags_count(targets & ((1 << (k + 1)) - 1)) == 1
+  ) {
+    // Optimization for 1 erasure (i < k + 1), encoding only targets:
+    const int t = flags_first(targets);
+    uint8_t* xorShards[MAX_K];
+    uint32_t xorLengths[MAX_K];
+    int count = 0;
+    for (int i = 0; i < k + 1; i++) {
+      if (sources & (1 << i)) {
+        xorShards[count] = shards[i];
+        xorLengths[count++] = shardLengths[i];
+      }
+    }
+    assert(count == k);
+    dot_combine_padded(xorShards, xorLengths, count, shards[t],
+      shardLengths[t]);
+    return;
+  }
+  const int kww = k * w * w;
+  const int dispatch = *dispatch_entry(w, k, shardSizeWhole);
+  const dot_kernel kernel = dispatch_kernel(dispatch, w, k);
+  int max = k;
+  int kerasures = 0;
+  for (int i = 0; i < k; i++) {
+    if (!(sources & (1 << i))) {
+      max = i;
+      kerasures++;
+    }
+  }
+  if (!(sources & (1 << k))) max = k;
+  int merasures = 0;
+  for (int i = 0; i < m; i++) {
+    if (!(sources & (1 << (k + i)))) merasures++;
+  }
+  const int decode = kerasures > 1 ||
+    (kerasures == 1 && !(sources & (1 << k)));
+  int s[MAX_K];
+  uint8_t bitmatrixDecoding[MAX_K * MAX_K * MAX_W * MAX_W];
+  if (decode) {
+    decode_sources(w, k, m, bitmatrixEncoding, sources, max, s);
+    create_bitmatrix_decoding(
+      w,
+      k,
+      m,
+      s,
+      bitmatrixEncoding,
+      bitmatrixDecoding
+    );
+  }
+  int xorSources[MAX_K];
+  for (int si = 0; si < k; si++) xorSources[si] = (si < max) ? si : si + 1;
+  int dataSources[MAX_K];
+  for (int si = 0; si < k; si++) dataSources[si] = si;
+  // A repair of both data and parity shards runs region by region, so that
+  // parity is encoded from recovered data while it is still in cache, rather
+  // than after another pass over every shard. Regions are encoded exactly as
+  // they would be over the whole shard:
+  const uint32_t step = kerasures > 0 && merasures > 0 ?
+    w * chunkSize :
+    shardSize;
+  for (uint32_t region = 0; region < shardSize; region += step) {
+    uint8_t* regionShards[MAX_K + MAX_M];
+    uint32_t regionLengths[MAX_K + MAX_M];
+    shards_range(k + m, shards, shardLengths, region, step, regionShards,
+      regionLengths);
+    int remaining = kerasures;
+    for (int i = 0; decode && remaining > 0 && i < max; i++) {
+      if (!(sources & (1 << i))) {
+        dot_run(
+          kernel,
+          dispatch,
+          w,
+          k,
+          regionShards,
+          regionLengths,
+          chunkSize,
+          step,
+          bitmatrixDecoding + kww * i,
+          s,
+          i
+        );
+        remaining--;
+      }
+    }
+    if (remaining > 0) {
+      dot_run(
+        kernel,
+        dispatch,
+        w,
+        k,
+        regionShards,
+        regionLengths,
+        chunkSize,
+        step,
+        bitmatrixEncoding,
+        xorSources,
+        max
+      );
+    }
+    for (int i = 0; i < m; i++) {
+      if (!(sources & (1 << (k + i)))) {
+        dot_run(
+          kernel,
+          dispatch,
+          w,
+          k,
+          regionShards,
+          regionLengths,
+          chunkSize,
+          step,
+          bitmatrixEncoding + kww * i,
+          dataSources,
+          k + i
+        );
+      }
+    }
+  }
+}
+
+// A Local Reconstruction Code (LRC) context has l local parities followed by
+// r = m - l global parities. Each local parity is the XOR of a group of data
+// shards, so that a single failure within a group is repaired from the group
+// alone. The global parities are rows 1 to r of a Cauchy code for (k, r + 1),
+// whose row 0 (all ones) is the sum of the local parities. LRC contexts end
+// with a trailer of [CONTEXT_LRC, l] after the bitmatrix.
+#define CONTEXT_LRC 1
+
+static int context_lrc(const uint8_t* context, const uint32_t contextSize) {
+  // Returns l for an LRC context, or 0:
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  if (contextSize != (uint32_t) (3 + k * w * m * w + 2)) return 0;
+  if (context[contextSize - 2] != CONTEXT_LRC) return 0;
+  return context[contextSize - 1];
+}
+
+static int lrc_group(const int k, const int l, const int i) {
+  // Data shards are divided into l contiguous groups of (almost) equal size:
+  return i * l / k;
+}
+
+static void bits_row(
+  const int w,
+  const int k,
+  const uint8_t* bitmatrix,
+  const int shard,
+  const int a,
+  uint64_t* bits
+) {
+  // Bit row a of a shard, as a combination of the bits of the data shards:
+  const int kw = k * w;
+  memset(bits, 0, BITS_WORDS * sizeof(uint64_t));
+  if (shard < k) {
+    bits_set(bits, shard * w + a);
+    return;
+  }
+  const uint8_t* row = bitmatrix + (shard - k) * kw * w + a * kw;
+  for (int column = 0; column < kw; column++) {
+    if (row[column]) bits_set(bits, column);
+  }
+}
+
+struct lrc_plan {
+  uint32_t local; // Data shards to repair from their local group.
+  uint32_t global; // Data shards to repair from the selected shards.
+  int selected[MAX_K]; // Shards (k) whose bit rows are linearly independent.
+};
+
+static int lrc_plan(
+  const int w,
+  const int k,
+  const int m,
+  const int l,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets,
+  struct lrc_plan* plan,
+  uint8_t* decoding
+) {
+  // Returns 0 if the sources cannot repair the targets. Decoding rows for
+  // plan->global are written (if decoding is not NULL) at kw * w * i for i:
+  const int kw = k * w;
+  uint32_t needed = targets & ((1 << k) - 1);
+  for (int j = 0; j < m; j++) {
+    if (!(targets & (1 << (k + j)))) continue;
+    for (int i = 0; i < k; i++) {
+      if (j >= l || lrc_group(k, l, i) == j) needed |= (1 << i);
+    }
+  }
+  needed &= ~sources;
+  plan->local = 0;
+  plan->global = 0;
+  for (int g = 0; g < l; g++) {
+    int missing = (sources & (1 << (k + g))) ? 0 : 1;
+    int shard = -1;
+    for (int i = 0; i < k; i++) {
+      if (lrc_group(k, l, i) != g || (sources & (1 << i))) continue;
+      missing++;
+      shard = i;
+    }
+    if (missing == 1 && shard >= 0 && (needed & (1 << shard))) {
+      plan->local |= (1 << shard);
+    }
+  }
+  plan->global = needed & ~plan->local;
+  if (plan->global == 0) return 1;
+  // Select k shards, data shards first, whose bit rows span the data:
+  const uint32_t available = sources | plan->local;
+  uint64_t basis[MAX_K * MAX_W][BITS_WORDS];
+  uint8_t present[MAX_K * MAX_W] = { 0 };
+  int selected = 0;
+  for (int shard = 0; shard < k + m && selected < k; shard++) {
+    if (!(available & (1 << shard))) continue;
+    uint64_t rows[MAX_W][BITS_WORDS];
+    int inserted[MAX_W];
+    int independent = 1;
+    for (int a = 0; a < w && independent; a++) {
+      inserted[a] = -1;
+      bits_row(w, k, bitmatrix, shard, a, rows[a]);
+      uint64_t bits[BITS_WORDS];
+      memcpy(bits, rows[a], sizeof(bits));
+      independent = 0;
+      for (int column = 0; column < kw; column++) {
+        if (!bits_get(bits, column)) continue;
+        if (present[column]) {
+          bits_xor(bits, basis[column]);
+        } else {
+          memcpy(basis[column], bits, sizeof(bits));
+          present[column] = 1;
+          inserted[a] = column;
+          independent = 1;
+          break;
+        }
+      }
+    }
+    if (!independent) {
+      // Only whole shards may be selected:
+      for (int a = 0; a < w; a++) {
+        if (inserted[a] < 0) break;
+        present[inserted[a]] = 0;
+      }
+      continue;
+    }
+    plan->selected[selected++] = shard;
+  }
+  if (selected < k) return 0;
+  if (decoding == NULL) return 1;
+  uint64_t rows[MAX_K * MAX_W][BITS_WORDS];
+  uint64_t inverse[MAX_K * MAX_W][BITS_WORDS];
+  for (int b = 0; b < k; b++) {
+    for (int a = 0; a < w; a++) {
+      bits_row(w, k, bitmatrix, plan->selected[b], a, rows[b * w + a]);
+    }
+  }
+  if (!bits_invert(kw, rows, inverse)) return 0;
+  for (int i = 0; i < k; i++) {
+    if (!(plan->global & (1 << i))) continue;
+    uint8_t* row = decoding + kw * w * i;
+    for (int a = 0; a < w; a++) {
+      for (int column = 0; column < kw; column++) {
+        row[a * kw + column] = bits_get(inverse[i * w + a], column);
+      }
+    }
+  }
+  return 1;
+}
+
+static void lrc_xor_group(
+  const int k,
+  const int l,
+  const int g,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const int target
+) {
+  // XOR the other members of a group (and its local parity) into target:
+  uint8_t* groupShards[MAX_K];
+  uint32_t groupLengths[MAX_K];
+  int count = 0;
+  for (int i = 0; i < k + 1; i++) {
+    const int shard = i < k ? i : k + g;
+    if (shard == target || (i < k && lrc_group(k, l, i) != g)) continue;
+    groupShards[count] = shards[shard];
+    groupLengths[count++] = shardLengths[shard];
+  }
+  assert(count >= 1);
+  dot_combine_padded(groupShards, groupLengths, count, shards[target],
+    shardLengths[target]);
+}
+
+static void lrc_encode_range(
+  const int w,
+  const int k,
+  const int m,
+  const int l,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSizeWhole,
+  const uint32_t offset,
+  const uint32_t shardSize
+) {
+  // As for cauchy_encode_range(), shards start at offset:
+  const uint32_t chunkSize = dot_chunk_size(w, k, shardSizeWhole);
+  assert(offset % (w * chunkSize) == 0);
+  assert(shardSize % (w * chunkSize) == 0);
+  (void) offset; // Used only by asserts.
+  struct lrc_plan plan;
+  uint8_t decoding[MAX_K * MAX_K * MAX_W * MAX_W];
+  const int repairable = lrc_plan(w, k, m, l, bitmatrix, sources, targets,
+    &plan, decoding);
+  // Arguments are validated by reed_solomon_check_flags() before encoding:
+  assert(repairable);
+  (void) repairable;
+  const int dispatch = *dispatch_entry(w, k, shardSizeWhole);
+  const dot_kernel kernel = dispatch_kernel(dispatch, w, k);
+  int s[MAX_K];
+  for (int si = 0; si < k; si++) s[si] = si;
+  // As for cauchy_encode_range(), repair data and parity region by region:
+  const uint32_t step = (plan.local | plan.global) &&
+    (targets >> k) ? w * chunkSize : shardSize;
+  for (uint32_t region = 0; region < shardSize; region += step) {
+    uint8_t* regionShards[MAX_K + MAX_M];
+    uint32_t regionLengths[MAX_K + MAX_M];
+    shards_range(k + m, shards, shardLengths, region, step, regionShards,
+      regionLengths);
+    for (int i = 0; i < k; i++) {
+      if (plan.local & (1 << i)) {
+        lrc_xor_group(k, l, lrc_group(k, l, i), regionShards, regionLengths,
+          i);
+      }
+    }
+    for (int i = 0; i < k; i++) {
+      if (!(plan.global & (1 << i))) continue;
+      dot_run(
+        kernel,
+        dispatch,
+        w,
+        k,
+        regionShards,
+        regionLengths,
+        chunkSize,
+        step,
+        decoding + k * w * w * i,
+        plan.selected,
+        i
+      );
+    }
+    for (int j = 0; j < m; j++) {
+      if (!(targets & (1 << (k + j)))) continue;
+      if (j < l) {
+        lrc_xor_group(k, l, j, regionShards, regionLengths, k + j);
+      } else {
+        dot_run(
+          kernel,
+          dispatch,
+          w,
+          k,
+          regionShards,
+          regionLengths,
+          chunkSize,
+          step,
+          bitmatrix + k * w * w * j,
+          s,
+          k + j
+        );
+      }
+    }
+  }
+}
+
+// A piggyback context splits every shard into two substripes, a (the first
+// half) and b (the second half), each encoded with the Cauchy code of the
+// context. Parity j >= 1 of substripe b then has the XOR of substripe a of a
+// group of data shards added to it (a piggyback), where data shard i is in the
+// group of parity 1 + i * (m - 1) / k. A single failed data shard is repaired
+// from substripe b of k shards (recovering its b, which is all the data of b),
+// the piggybacked substripe b of its parity (which then yields the XOR of its
+// group's a) and substripe a of the rest of its group, so reading k + 1 + (the
+// size of its group - 1) half shards rather than 2k. Every other repair removes
+// the piggybacks from the parity shards it reads and decodes both substripes as
+// usual. Piggyback contexts end with a trailer of [CONTEXT_PIGGYBACK, 2] after
+// the bitmatrix, where 2 is the number of substripes.
+#define CONTEXT_PIGGYBACK 2
+#define PIGGYBACK_SUBSTRIPES 2
+
+static int context_piggyback(
+  const uint8_t* context,
+  const uint32_t contextSize
+) {
+  // Returns the number of substripes of a piggyback context, or 0:
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  if (contextSize != (uint32_t) (3 + k * w * m * w + 2)) return 0;
+  if (context[contextSize - 2] != CONTEXT_PIGGYBACK) return 0;
+  return context[contextSize - 1];
+}
+
+static int piggyback_parity(const int k, const int m, const int i) {
+  // Data shards are divided into m - 1 contiguous groups, as for LRC groups:
+  return 1 + i * (m - 1) / k;
+}
+
+static void piggyback_views(
+  const int count,
+  uint8_t** shardsWhole,
+  const uint32_t* shardLengthsWhole,
+  const uint32_t half,
+  uint8_t** a,
+  uint32_t* aLengths,
+  uint8_t** b,
+  uint32_t* bLengths
+) {
+  // The substripes of every shard, as shards of half the size:
+  shards_range(count, shardsWhole, shardLengthsWhole, 0, half, a, aLengths);
+  shards_range(count, shardsWhole, shardLengthsWhole, half, half, b,
+    bLengths);
+}
+
+static void piggyback_xor(
+  const int k,
+  const int m,
+  const int j,
+  const int skip,
+  uint8_t** a,
+  const uint32_t* aLengths,
+  uint8_t* target,
+  const uint32_t targetLength
+) {
+  // XOR substripe a of the group of parity j (except shard skip) into target:
+  for (int i = 0; i < k; i++) {
+    if (i == skip || piggyback_parity(k, m, i) != j) continue;
+    dot_xor_padded(a[i], aLengths[i], target, targetLength);
+  }
+}
+
+static int piggyback_single(
+  const int k,
+  const int m,
+  const uint32_t sources,
+  const uint32_t targets
+) {
+  // Returns the data shard to repair through its piggyback, or -1:
+  if (flags_count(targets) != 1) return -1;
+  const int i = flags_first(targets);
+  if (i >= k) return -1;
+  const uint32_t needed = (((uint32_t) 1 << k) - 1) & ~targets;
+  const uint32_t parities = (1 << k) | (1 << (k + piggyback_parity(k, m, i)));
+  if ((sources & (needed | parities)) != (needed | parities)) return -1;
+  return i;
+}
+
+static uint32_t cauchy_reads(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets
+);
+
+static void piggyback_encode_range(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shardsWhole,
+  const uint32_t* shardLengthsWhole,
+  const uint32_t shardSizeWhole,
+  const uint32_t offset,
+  const uint32_t shardSize
+) {
+  // The range [offset, offset + shardSize) is of each substripe:
+  assert(shardSizeWhole % (PIGGYBACK_SUBSTRIPES * 8) == 0);
+  const uint32_t half = shardSizeWhole / PIGGYBACK_SUBSTRIPES;
+  assert((uint64_t) offset + shardSize <= half);
+  uint8_t* a[MAX_K + MAX_M];
+  uint32_t aLengths[MAX_K + MAX_M];
+  uint8_t* b[MAX_K + MAX_M];
+  uint32_t bLengths[MAX_K + MAX_M];
+  piggyback_views(k + m, shardsWhole, shardLengthsWhole, half, a, aLengths, b,
+    bLengths);
+  // The piggybacks apply to the same range of both substripes:
+  uint8_t* aRange[MAX_K + MAX_M];
+  uint32_t aRangeLengths[MAX_K + MAX_M];
+  uint8_t* bRange[MAX_K + MAX_M];
+  uint32_t bRangeLengths[MAX_K + MAX_M];
+  shards_range(k + m, a, aLengths, offset, shardSize, aRange, aRangeLengths);
+  shards_range(k + m, b, bLengths, offset, shardSize, bRange, bRangeLengths);
+  const int single = piggyback_single(k, m, sources, targets);
+  if (single >= 0) {
+    const int i = single;
+    const int j = piggyback_parity(k, m, i);
+    // Recover substripe b of shard i from parity 0 (all ones), which encodes
+    // only the target since exactly k of the first k + 1 shards are sources:
+    const uint32_t data = ((uint32_t) 1 << k) - 1;
+    cauchy_encode_range(w, k, m, bitmatrix, (data & ~targets) | (1 << k),
+      targets, bRange, bRangeLengths, half, offset, shardSize);
+    // Encode parity j of substripe b into substripe a of shard i, and XOR the
+    // piggybacked parity into it, leaving the piggyback of the group:
+    const uint32_t chunkSize = dot_chunk_size(w, k, half);
+    const int dispatch = *dispatch_entry(w, k, half);
+    uint8_t* shards[MAX_K + MAX_M];
+    uint32_t shardLengths[MAX_K + MAX_M];
+    for (int index = 0; index < k + m; index++) {
+      shards[index] = bRange[index];
+      shardLengths[index] = bRangeLengths[index];
+    }
+    shards[k + j] = aRange[i];
+    shardLengths[k + j] = aRangeLengths[i];
+    int s[MAX_K];
+    for (int si = 0; si < k; si++) s[si] = si;
+    dot_run(
+      dispatch_kernel(dispatch, w, k),
+      dispatch,
+      w,
+      k,
+      shards,
+      shardLengths,
+      chunkSize,
+      shardSize,
+      bitmatrix + k * w * w * j,
+      s,
+      k + j
+    );
+    dot_xor_padded(bRange[k + j], bRangeLengths[k + j], aRange[i],
+      aRangeLengths[i]);
+    // The rest of the group leaves substripe a of shard i:
+    piggyback_xor(k, m, j, i, aRange, aRangeLengths, aRange[i],
+      aRangeLengths[i]);
+    return;
+  }
+  // Substripe a has no piggybacks:
+  cauchy_encode_range(w, k, m, bitmatrix, sources, targets, aRange,
+    aRangeLengths, half, offset, shardSize);
+  // Remove the piggybacks from the parity shards which decoding b will read,
+  // and restore them afterwards (every shard of substripe a is now known):
+  const uint32_t reads = cauchy_reads(w, k, m, bitmatrix, sources, targets);
+  uint32_t piggybacked = 0;
+  for (int j = 1; j < m; j++) {
+    if ((reads | targets) & (1 << (k + j))) piggybacked |= 1 << j;
+    if (!(reads & (1 << (k + j)))) continue;
+    piggyback_xor(k, m, j, -1, aRange, aRangeLengths, bRange[k + j],
+      bRangeLengths[k + j]);
+  }
+  cauchy_encode_range(w, k, m, bitmatrix, sources, targets, bRange,
+    bRangeLengths, half, offset, shardSize);
+  for (int j = 1; j < m; j++) {
+    if (!(piggybacked & (1 << j))) continue;
+    piggyback_xor(k, m, j, -1, aRange, aRangeLengths, bRange[k + j],
+      bRangeLengths[k + j]);
+  }
+}
+
+static uint32_t cauchy_reads(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets
+) {
+  // The sources read by cauchy_encode_range(), which this must mirror:
+  const uint32_t data = (1 << k) - 1;
+  if (k == 1) return 1 << flags_first(sources);
+  if (
+    flags_count(targets) == 1 &&
+    flags_count(sources & ((1 << (k + 1)) - 1)) == k &&
+    flags_count(targets & ((1 << (k + 1)) - 1)) == 1
+  ) {
+    return sources & ((1 << (k + 1)) - 1);
+  }
+  uint32_t reads = 0;
+  int max = k;
+  int kerasures = 0;
+  for (int i = 0; i < k; i++) {
+    if (!(sources & (1 << i))) {
+      max = i;
+      kerasures++;
+    }
+  }
+  if (!(sources & (1 << k))) max = k;
+  if (kerasures > 1 || (kerasures == 1 && !(sources & (1 << k)))) {
+    int s[MAX_K];
+    decode_sources(w, k, m, bitmatrix, sources, max, s);
+    for (int i = 0; i < k; i++) reads |= 1 << s[i];
+  }
+  if (max < k) reads |= (sources & data & ~(1 << max)) | (1 << k);
+  if (((sources >> k) & ((1 << m) - 1)) != (uint32_t) (1 << m) - 1) {
+    reads |= sources & data;
+  }
+  return reads;
+}
+
+static uint32_t lrc_reads(
+  const int w,
+  const int k,
+  const int m,
+  const int l,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets
+) {
+  // The sources read by lrc_encode_range(), which this must mirror:
+  struct lrc_plan plan;
+  const int repairable = lrc_plan(w, k, m, l, bitmatrix, sources, targets,
+    &plan, NULL);
+  assert(repairable);
+  (void) repairable;
+  uint32_t reads = 0;
+  for (int i = 0; i < k; i++) {
+    if (plan.local & (1 << i)) {
+      const int g = lrc_group(k, l, i);
+      for (int j = 0; j < k; j++) {
+        if (lrc_group(k, l, j) == g) reads |= 1 << j;
+      }
+      reads |= 1 << (k + g);
+    }
+  }
+  if (plan.global) {
+    for (int i = 0; i < k; i++) reads |= 1 << plan.selected[i];
+  }
+  for (int j = 0; j < m; j++) {
+    if (!(targets & (1 << (k + j)))) continue;
+    for (int i = 0; i < k; i++) {
+      if (j >= l || lrc_group(k, l, i) == j) reads |= 1 << i;
+    }
+  }
+  // Repaired shards are written before they are read:
+  return reads & sources;
+}
+
+static uint32_t piggyback_reads(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  const uint32_t sources,
+  const uint32_t targets,
+  const int substripe
+) {
+  // The sources read by piggyback_encode_range(), which this must mirror:
+  const int single = piggyback_single(k, m, sources, targets);
+  if (single >= 0) {
+    const int j = piggyback_parity(k, m, single);
+    if (substripe == 1) {
+      const uint32_t data = ((uint32_t) 1 << k) - 1;
+      return (data & ~targets) | (1 << k) | (1 << (k + j));
+    }
+    uint32_t reads = 0;
+    for (int i = 0; i < k; i++) {
+      if (i != single && piggyback_parity(k, m, i) == j) reads |= 1 << i;
+    }
+    return reads;
+  }
+  const uint32_t reads = cauchy_reads(w, k, m, bitmatrix, sources, targets);
+  if (substripe == 1) return reads;
+  // Substripe a of each group whose piggyback is removed or added:
+  uint32_t groups = 0;
+  for (int j = 1; j < m; j++) {
+    if ((reads | targets) & (1 << (k + j))) {
+      for (int i = 0; i < k; i++) {
+        if (piggyback_parity(k, m, i) == j) groups |= 1 << i;
+      }
+    }
+  }
+  return (reads | groups) & sources;
+}
+
+static void encode_shards(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSizeWhole,
+  const uint32_t offset,
+  const uint32_t shardSize
+) {
+  // Encodes shards which start at offset, for a context without substripes:
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const uint8_t* bitmatrix = context + 3;
+  assert(!context_piggyback(context, contextSize));
+  const int l = context_lrc(context, contextSize);
+  if (l) {
+    lrc_encode_range(w, k, m, l, bitmatrix, sources, targets, shards,
+      shardLengths, shardSizeWhole, offset, shardSize);
+  } else {
+    cauchy_encode_range(w, k, m, bitmatrix, sources, targets, shards,
+      shardLengths, shardSizeWhole, offset, shardSize);
+  }
+}
+
+void reed_solomon_encode_range(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shardsWhole,
+  const uint32_t* shardLengthsWhole,
+  const uint32_t shardSizeWhole,
+  const uint32_t offset,
+  const uint32_t shardSize
+) {
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const uint8_t* bitmatrix = context + 3;
+  if (context_piggyback(context, contextSize)) {
+    piggyback_encode_range(w, k, m, bitmatrix, sources, targets, shardsWhole,
+      shardLengthsWhole, shardSizeWhole, offset, shardSize);
+    return;
+  }
+  uint8_t* shards[MAX_K + MAX_M];
+  uint32_t shardLengths[MAX_K + MAX_M];
+  shards_range(k + m, shardsWhole, shardLengthsWhole, offset, shardSize,
+    shards, shardLengths);
+  encode_shards(context, contextSize, sources, targets, shards, shardLengths,
+    shardSizeWhole, offset, shardSize);
+}
+
+static void layout_copy(
+  const int k,
+  uint8_t* data,
+  const uint64_t stride,
+  const uint32_t unit,
+  const uint32_t rotation,
+  const int i,
+  uint32_t offset,
+  uint32_t size,
+  uint8_t* shard,
+  const int gather
+) {
+  // Copies [offset, offset + size) of data shard i to (or from) shard:
+  while (size > 0) {
+    const uint64_t row = offset / unit;
+    const uint32_t within = offset % unit;
+    const uint32_t length = unit - within < size ? unit - within : size;
+    uint8_t* bytes = data + row * stride +
+      (uint64_t) ((i + row * rotation) % k) * unit + within;
+    if (gather) {
+      memcpy(shard, bytes, length);
+    } else {
+      memcpy(bytes, shard, length);
+    }
+    shard += length;
+    offset += length;
+    size -= length;
+  }
+}
+
+void reed_solomon_encode_layout(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t* data,
+  const uint64_t stride,
+  const uint32_t unit,
+  const uint32_t rotation,
+  uint8_t** parity,
+  const uint32_t shardSize,
+  const uint32_t offset,
+  const uint32_t size,
+  uint8_t* scratch
+) {
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  assert(!context_piggyback(context, contextSize));
+  assert(unit > 0);
+  assert(stride >= (uint64_t) k * unit);
+  assert(rotation < (uint32_t) k);
+  assert(shardSize % unit == 0);
+  const uint32_t regionSize = reed_solomon_region_size(w, k, shardSize);
+  assert(offset % regionSize == 0);
+  assert(size % regionSize == 0);
+  assert((uint64_t) offset + size <= shardSize);
+  uint8_t* shards[MAX_K + MAX_M];
+  uint32_t shardLengths[MAX_K + MAX_M];
+  const uint32_t end = offset + size;
+  uint32_t position = offset;
+  while (position < end) {
+    uint32_t length = 0;
+    if (unit % regionSize == 0) {
+      // Encode the shards in place, a unit (of whole regions) at a time:
+      const uint64_t row = position / unit;
+      const uint32_t within = position % unit;
+      length = unit - within < end - position ? unit - within : end - position;
+      for (int i = 0; i < k; i++) {
+        shards[i] = data + row * stride +
+          (uint64_t) ((i + row * rotation) % k) * unit + within;
+        shardLengths[i] = length;
+      }
+    } else {
+      // Units are smaller than a region (or straddle regions), so gather the
+      // sources of each region into scratch (k regions), which stays in cache,
+      // and scatter the targets afterwards:
+      assert(scratch != NULL);
+      length = regionSize;
+      for (int i = 0; i < k; i++) {
+        shards[i] = scratch + (size_t) i * regionSize;
+        shardLengths[i] = length;
+        if (!(sources & (1 << i))) continue;
+        layout_copy(k, data, stride, unit, rotation, i, position, length,
+          shards[i], 1);
+      }
+    }
+    for (int j = 0; j < m; j++) {
+      shards[k + j] = parity[j] + position;
+      shardLengths[k + j] = length;
+    }
+    encode_shards(context, contextSize, sources, targets, shards, shardLengths,
+      shardSize, position, length);
+    if (unit % regionSize != 0) {
+      for (int i = 0; i < k; i++) {
+        if (!(targets & (1 << i))) continue;
+        layout_copy(k, data, stride, unit, rotation, i, position, length,
+          shards[i], 0);
+      }
+    }
+    position += length;
+  }
+}
+
+int reed_solomon_substripes(
+  const uint8_t* context,
+  const uint32_t contextSize
+) {
+  const int substripes = context_piggyback(context, contextSize);
+  return substripes ? substripes : 1;
+}
+
+uint32_t reed_solomon_reads_substripe(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  const int substripe
+) {
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const uint8_t* bitmatrix = context + 3;
+  assert(substripe >= 0);
+  assert(substripe < reed_solomon_substripes(context, contextSize));
+  const int l = context_lrc(context, contextSize);
+  if (l) return lrc_reads(w, k, m, l, bitmatrix, sources, targets);
+  if (context_piggyback(context, contextSize)) {
+    return piggyback_reads(w, k, m, bitmatrix, sources, targets, substripe);
+  }
+  return cauchy_reads(w, k, m, bitmatrix, sources, targets);
+}
+
+uint32_t reed_solomon_reads(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets
+) {
+  uint32_t reads = 0;
+  const int substripes = reed_solomon_substripes(context, contextSize);
+  for (int substripe = 0; substripe < substripes; substripe++) {
+    reads |= reed_solomon_reads_substripe(context, contextSize, sources,
+      targets, substripe);
+  }
+  return reads;
+}
+
+static int locate_zero(const uint8_t* bytes, const uint32_t size) {
+  for (uint32_t index = 0; index < size; index++) {
+    if (bytes[index]) return 0;
+  }
+  return 1;
+}
+
+static int locate_identity(
+  const int w,
+  const int k,
+  const uint8_t* bitmatrix,
+  const int j,
+  const int i
+) {
+  // Returns 1 if the block of parity j for data shard i is the identity:
+  const int kw = k * w;
+  for (int a = 0; a < w; a++) {
+    for (int c = 0; c < w; c++) {
+      if (bitmatrix[j * kw * w + a * kw + i * w + c] != (a == c)) return 0;
+    }
+  }
+  return 1;
+}
+
+static int locate_data(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  uint8_t** syndromes,
+  const uint32_t shardLength,
+  const uint32_t chunkSize,
+  const uint32_t offset,
+  const int i,
+  uint8_t* scratch
+) {
+  // Returns 1 if an error in data shard i alone explains the syndromes of the
+  // region at offset. The error is the syndrome of a parity whose block for
+  // shard i is the identity (row 0 of a Cauchy context, or the local parity of
+  // an LRC group), and each other syndrome must be its block times the error:
+  int e = -1;
+  for (int j = 0; j < m && e < 0; j++) {
+    if (locate_identity(w, k, bitmatrix, j, i)) e = j;
+  }
+  if (e < 0) return 0;
+  const uint8_t* error = syndromes[e] + offset;
+  // An error cannot be in the virtual padding of a short data shard:
+  for (int c = 0; c < w; c++) {
+    const uint32_t length = dot_clip(shardLength, offset + c * chunkSize,
+      chunkSize);
+    if (!locate_zero(error + c * chunkSize + length, chunkSize - length)) {
+      return 0;
+    }
+  }
+  const int kw = k * w;
+  for (int j = 0; j < m; j++) {
+    if (j == e) continue;
+    for (int a = 0; a < w; a++) {
+      memset(scratch, 0, chunkSize);
+      for (int c = 0; c < w; c++) {
+        if (bitmatrix[j * kw * w + a * kw + i * w + c]) {
+          dot_xor((uint8_t*) error + c * chunkSize, scratch, chunkSize);
+        }
+      }
+      const uint8_t* syndrome = syndromes[j] + offset + a * chunkSize;
+      if (memcmp(scratch, syndrome, chunkSize) != 0) return 0;
+    }
+  }
+  return 1;
+}
+
+static int locate_regions(
+  const int w,
+  const int k,
+  const int m,
+  const uint8_t* bitmatrix,
+  uint8_t** syndromes,
+  const uint32_t* shardLengths,
+  const uint32_t chunkSize,
+  const uint32_t shardSize,
+  int* located,
+  uint8_t* product
+) {
+  // Locates each region of the syndromes, returning the inconsistent count:
+  const uint32_t regionSize = w * chunkSize;
+  int inconsistent = 0;
+  for (uint32_t region = 0; region < shardSize / regionSize; region++) {
+    const uint32_t offset = region * regionSize;
+    uint32_t nonzero = 0;
+    for (int j = 0; j < m; j++) {
+      if (!locate_zero(syndromes[j] + offset, regionSize)) nonzero |= 1 << j;
+    }
+    if (nonzero == 0) {
+      located[region] = REED_SOLOMON_LOCATE_CONSISTENT;
+      continue;
+    }
+    inconsistent++;
+    // Exactly one shard must explain the syndromes for it to be located:
+    int candidates = 0;
+    int candidate = REED_SOLOMON_LOCATE_UNKNOWN;
+    if (flags_count(nonzero) == 1) {
+      candidates++;
+      candidate = k + flags_first(nonzero);
+    }
+    for (int i = 0; i < k && candidates < 2; i++) {
+      if (shardLengths[i] <= offset) continue;
+      if (locate_data(w, k, m, bitmatrix, syndromes, shardLengths[i],
+        chunkSize, offset, i, product)) {
+        candidates++;
+        candidate = i;
+      }
+    }
+    located[region] = candidates == 1 ? candidate :
+      REED_SOLOMON_LOCATE_UNKNOWN;
+  }
+  return inconsistent;
+}
+
+int reed_solomon_locate(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSize,
+  int* located
+) {
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const uint8_t* bitmatrix = context + 3;
+  const int substripes = reed_solomon_substripes(context, contextSize);
+  assert(shardSize > 0);
+  assert(shardSize % (8 * substripes) == 0);
+  const uint32_t half = shardSize / substripes;
+  const uint32_t chunkSize = dot_chunk_size(w, k, half);
+  // Encode the parity of the data afresh, and XOR the parity of the stripe into
+  // it, leaving the syndrome of each parity shard:
+  uint8_t* scratch = malloc((size_t) m * shardSize + chunkSize);
+  if (scratch == NULL) return -1;
+  uint8_t* encoding[MAX_K + MAX_M];
+  uint32_t encodingLengths[MAX_K + MAX_M];
+  uint8_t* syndromes[MAX_M];
+  for (int i = 0; i < k + m; i++) {
+    if (i < k) {
+      encoding[i] = shards[i];
+      encodingLengths[i] = shardLengths[i];
+    } else {
+      syndromes[i - k] = scratch + (size_t) (i - k) * shardSize;
+      encoding[i] = syndromes[i - k];
+      encodingLengths[i] = shardSize;
+    }
+  }
+  reed_solomon_encode(context, contextSize, (1 << k) - 1,
+    ((1 << m) - 1) << k, encoding, encodingLengths, shardSize);
+  for (int j = 0; j < m; j++) {
+    assert(shardLengths[k + j] == shardSize);
+    dot_xor(shards[k + j], syndromes[j], shardSize);
+  }
+  uint8_t* product = scratch + (size_t) m * shardSize;
+  if (substripes == 1) {
+    const int inconsistent = locate_regions(w, k, m, bitmatrix, syndromes,
+      shardLengths, chunkSize, shardSize, located, product);
+    free(scratch);
+    return inconsistent;
+  }
+  // Locate substripe a first. A corrupt region of substripe a of data shard i
+  // also corrupts the piggyback in substripe b of its parity, by the same
+  // error (the syndrome of parity 0), which is then removed from substripe b:
+  assert(substripes == PIGGYBACK_SUBSTRIPES);
+  const uint32_t regionSize = w * chunkSize;
+  const uint32_t regions = half / regionSize;
+  uint8_t* a[MAX_K + MAX_M];
+  uint32_t aLengths[MAX_K + MAX_M];
+  uint8_t* b[MAX_K + MAX_M];
+  uint32_t bLengths[MAX_K + MAX_M];
+  piggyback_views(k, shards, shardLengths, half, a, aLengths, b, bLengths);
+  piggyback_views(m, syndromes, encodingLengths + k, half, a + k, aLengths + k,
+    b + k, bLengths + k);
+  int inconsistent = locate_regions(w, k, m, bitmatrix, a + k, aLengths,
+    chunkSize, half, located, product);
+  for (uint32_t region = 0; region < regions; region++) {
+    const int i = located[region];
+    if (i < 0 || i >= k) continue;
+    const int j = piggyback_parity(k, m, i);
+    const uint32_t offset = region * regionSize;
+    dot_xor(a[k] + offset, b[k + j] + offset, regionSize);
+  }
+  inconsistent += locate_regions(w, k, m, bitmatrix, b + k, bLengths,
+    chunkSize, half, located + regions, product);
+  // Substripe b cannot be located where substripe a was not:
+  for (uint32_t region = 0; region < regions; region++) {
+    if (
+      located[region] == REED_SOLOMON_LOCATE_UNKNOWN &&
+      located[regions + region] != REED_SOLOMON_LOCATE_CONSISTENT
+    ) {
+      located[regions + region] = REED_SOLOMON_LOCATE_UNKNOWN;
+    }
+  }
+  free(scratch);
+  return inconsistent;
+}
+
+const char* reed_solomon_check_context(
+  const uint8_t* context,
+  const uint32_t contextLength
+) {
+  if (contextLength < 3) return "context.length < 3";
+  const int w = (int) context[0];
+  const int k = (int) context[1];
+  const int m = (int) context[2];
+  if (w != 2 && w != 4 && w != 8) return "w != 2, 4, 8";
+  if (k < 1) return "k < 1";
+  if (k > MAX_K) return "k > MAX_K";
+  if (m < 1) return "m < 1";
+  if (m > MAX_M) return "m > MAX_M";
+  const int l = context_lrc(context, contextLength);
+  if (l) {
+    // Local parities need no symbols of the field:
+    if (l > k) return "l > k";
+    if (l > m) return "l > m";
+    if (k + (m - l) + 1 > (1 << w)) return "k + r + 1 > (1 << w)";
+    // Local parities must be the XOR of their group (see lrc_xor_group()):
+    const int kw = k * w;
+    for (int g = 0; g < l; g++) {
+      const uint8_t* row = context + 3 + g * kw * w;
+      for (int a = 0; a < w; a++) {
+        for (int column = 0; column < kw; column++) {
+          const int bit = lrc_group(k, l, column / w) == g && column % w == a;
+          if (row[a * kw + column] != bit) return "bitmatrix not LRC";
+        }
+      }
+    }
+    return NULL;
+  }
+  if (k + m > (1 << w)) return "k + m > (1 << w)";
+  const int substripes = context_piggyback(context, contextLength);
+  if (substripes) {
+    // Parity 0 (all ones) repairs substripe b, and parity 1 is a piggyback:
+    if (substripes != PIGGYBACK_SUBSTRIPES) return "substripes != 2";
+    if (m < 2) return "m < 2";
+  } else if (contextLength != (uint32_t) (3 + k * w * m * w)) {
+    return "context.length is bad";
+  }
+  if (bitmatrix_m0_optimized(w, k, context + 3) != 1) {
+    return "bitmatrix not optimized";
+  }
+  return NULL;
+}
+
+const char* reed_solomon_check_flags(
+  const uint8_t* context,
+  const uint32_t contextLength,
+  const uint32_t sources,
+  const uint32_t targets
+) {
+  // The context must have been checked by reed_solomon_check_context():
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const int l = context_lrc(context, contextLength);
+  assert(k + m < 31);
+  if (sources >= (uint32_t) 1 << (k + m)) return "sources > k + m";
+  const int sourcesCount = flags_count(sources);
+  if (sourcesCount == 0) return "sources == 0";
+  // An LRC context may repair a shard from its local group (fewer than k):
+  if (sourcesCount < k && !l) return "sources < k";
+  assert(k + m < 31);
+  if (targets >= (uint32_t) 1 << (k + m)) return "targets > k + m";
+  const int targetsCount = flags_count(targets);
+  if (targetsCount == 0) return "targets == 0";
+  if (targetsCount > m) return "targets > m";
+  if ((sources & targets) != 0) return "(sources & targets) != 0";
+  if (l) {
+    struct lrc_plan plan;
+    if (!lrc_plan(w, k, m, l, context + 3, sources, targets, &plan, NULL)) {
+      return "sources cannot repair targets";
+    }
+  }
+  return NULL;
+}
+
+static int create_encoding(const int k, const int m, uint8_t* bitmatrix) {
+  // Writes the encoding bitmatrix for (k, m) and returns w:
+  assert(k >= 1);
+  assert(k <= MAX_K);
+  assert(m >= 1);
+  assert(m <= MAX_M);
+  assert(sizeof(PARAMETERS) == MAX_K * MAX_M * 7 * sizeof(int));
+  assert(PARAMETERS[k - 1][m - 1][0] == k);
+  assert(PARAMETERS[k - 1][m - 1][1] == m);
+  int w = PARAMETERS[k - 1][m - 1][2];
+  assert(w <= MAX_W);
+  assert(w == 2 || w == 4 || w == 8);
+  assert(k + m <= (1 << w));
+  int p = PARAMETERS[k - 1][m - 1][3];
+  int x = PARAMETERS[k - 1][m - 1][4];
+  int y = PARAMETERS[k - 1][m - 1][5];
+  (void) x; // Used only by asserts.
+  (void) y; // Used only by asserts.
+  if (m <= 2) {
+    assert(x == -1);
+    assert(y == -1);
+  } else {
+    assert(y != x);
+  }
+  const int b = PARAMETERS[k - 1][m - 1][6];
+  assert(b >= 1);
+  assert(b <= k * w * m * w);
+  (void) b; // Used only by asserts.
+  int log[1 << MAX_W];
+  int exp[1 << MAX_W];
+  create_tables_field(w, p, log, exp);
+  const uint8_t* matrix = MATRICES[k - 1][m - 1];
+  // Cross-check the baked matrix against the full search only in the checked
+  // build, since the search is O(2^w * 2^w) and every create() would pay it:
+  #ifdef REED_SOLOMON_CHECKED
+    int bit[1 << MAX_W];
+    int min[1 << MAX_W];
+    create_tables(w, p, log, exp, bit, min);
+    uint8_t search[MAX_K * MAX_M];
+    const int matrixCost = create_matrix(log, exp, bit, min, w, k, m, x, y,
+      search);
+    assert(matrixCost == b);
+    assert(memcmp(search, matrix, k * m) == 0);
+    (void) matrixCost; // Used only by asserts.
+  #endif
+  const int bitmatrixCost = create_bitmatrix_encoding(log, exp, w, k, m,
+    matrix, bitmatrix);
+  assert(bitmatrixCost == b);
+  (void) bitmatrixCost;
+  assert(bitmatrix_m0_optimized(w, k, bitmatrix) == 1);
+  return w;
+}
+
+int reed_solomon_abi_version(void) {
+  return REED_SOLOMON_ABI_VERSION;
+}
+
+uint32_t reed_solomon_create(const int k, const int m, uint8_t* context) {
+  if (k < 1 || k > MAX_K || m < 1 || m > MAX_M) return 0;
+  uint8_t bitmatrix[MAX_K * MAX_W * MAX_M * MAX_W];
+  const int w = create_encoding(k, m, bitmatrix);
+  const uint32_t contextSize = 3 + k * w * m * w;
+  assert(contextSize <= REED_SOLOMON_CONTEXT_SIZE);
+  context[0] = w;
+  context[1] = k;
+  context[2] = m;
+  memcpy(context + 3, bitmatrix, k * w * m * w);
+  assert(reed_solomon_check_context(context, contextSize) == NULL);
+  return contextSize;
+}
+
+uint32_t reed_solomon_create_lrc(
+  const int k,
+  const int l,
+  const int r,
+  uint8_t* context
+) {
+  if (k < 1 || k > MAX_K || l < 1 || l > k || r < 0 || l + r > MAX_M) {
+    return 0;
+  }
+  const int m = l + r;
+  // Global parities are rows 1 to r of the code for (k, r + 1):
+  uint8_t global[MAX_K * MAX_W * MAX_M * MAX_W];
+  const int w = create_encoding(k, r + 1, global);
+  const int kw = k * w;
+  const uint32_t contextSize = 3 + k * w * m * w + 2;
+  assert(contextSize <= REED_SOLOMON_CONTEXT_SIZE);
+  context[0] = w;
+  context[1] = k;
+  context[2] = m;
+  uint8_t* bitmatrix = context + 3;
+  for (int g = 0; g < l; g++) {
+    uint8_t* row = bitmatrix + g * kw * w;
+    for (int a = 0; a < w; a++) {
+      for (int column = 0; column < kw; column++) {
+        row[a * kw + column] = lrc_group(k, l, column / w) == g &&
+          column % w == a;
+      }
+    }
+  }
+  memcpy(bitmatrix + l * kw * w, global + kw * w, r * kw * w);
+  context[contextSize - 2] = CONTEXT_LRC;
+  context[contextSize - 1] = l;
+  assert(context_lrc(context, contextSize) == l);
+  assert(reed_solomon_check_context(context, contextSize) == NULL);
+  return contextSize;
+}
+
+uint32_t reed_solomon_create_piggyback(
+  const int k,
+  const int m,
+  uint8_t* context
+) {
+  if (k < 1 || k > MAX_K || m < 2 || m > MAX_M) return 0;
+  // Each substripe is encoded by the Cauchy code for (k, m):
+  const uint32_t cauchySize = reed_solomon_create(k, m, context);
+  const uint32_t contextSize = cauchySize + 2;
+  assert(contextSize <= REED_SOLOMON_CONTEXT_SIZE);
+  context[contextSize - 2] = CONTEXT_PIGGYBACK;
+  context[contextSize - 1] = PIGGYBACK_SUBSTRIPES;
+  assert(context_piggyback(context, contextSize) == PIGGYBACK_SUBSTRIPES);
+  assert(reed_solomon_check_context(context, contextSize) == NULL);
+  return contextSize;
+}
+
+void reed_solomon_encode(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSize
+) {
+  reed_solomon_encode_range(
+    context,
+    contextSize,
+    sources,
+    targets,
+    shards,
+    shardLengths,
+    shardSize,
+    0,
+    shardSize / reed_solomon_substripes(context, contextSize)
+  );
+}
+
+void reed_solomon_xor(uint8_t* source, uint8_t* target, const uint32_t size) {
+  // Target is a source of its own combination (each block is loaded before it
+  // is stored), so that both are loaded a vector at a time:
+  uint8_t* sources[2] = { target, source };
+  if (size > 0) dot_combine(sources, 2, target, size);
+}
+
+// Region operations over GF(2^w), for codes and checksums of applications.
+// Elements are packed into bytes (one for w = 8, two for w = 4 and four for
+// w = 2, from the low bits), and the product of an element and every element
+// of a byte is looked up by each half of the byte in a table of 16 bytes, as
+// PSHUFB does 32 bytes at a time (AVX2, where the CPU supports it):
+#if defined(__x86_64__) && defined(__GNUC__)
+  #define GF_AVX2 1
+  #include <immintrin.h>
+#else
+  #define GF_AVX2 0
+#endif
+
+// The number of bytes of each source combined into the target at a time, so
+// that the target stays in cache across sources:
+#define GF_BLOCK 16384
+
+// The number of coefficients whose tables are computed at a time:
+#define GF_TABLES 32
+
+static int gf_multiply(const int w, const int p, int a, int b) {
+  // Multiplies a and b without tables (p may include or exclude x^w):
+  const int y = (1 << w) - 1;
+  int product = 0;
+  while (b) {
+    if (b & 1) product ^= a;
+    b >>= 1;
+    a <<= 1;
+    if (a & (1 << w)) a = (a ^ p) & y;
+  }
+  return product;
+}
+
+static void gf_tables(
+  const int w,
+  const int p,
+  const int c,
+  uint8_t* low,
+  uint8_t* high
+) {
+  // Products of c and the elements in each value of the low and high nibbles:
+  for (int n = 0; n < 16; n++) {
+    if (w == 8) {
+      low[n] = (uint8_t) gf_multiply(w, p, c, n);
+      high[n] = (uint8_t) gf_multiply(w, p, c, n << 4);
+    } else if (w == 4) {
+      low[n] = (uint8_t) gf_multiply(w, p, c, n);
+      high[n] = (uint8_t) (low[n] << 4);
+    } else {
+      low[n] = (uint8_t) (gf_multiply(w, p, c, n & 3) |
+        (gf_multiply(w, p, c, n >> 2) << 2));
+      high[n] = (uint8_t) (low[n] << 4);
+    }
+  }
+}
+
+#if GF_AVX2
+__attribute__((target("avx2")))
+static uint32_t gf_region_avx2(
+  const uint8_t* low,
+  const uint8_t* high,
+  const uint8_t* source,
+  uint8_t* target,
+  const uint32_t size,
+  const int accumulate
+) {
+  // Returns the number of bytes multiplied (a multiple of 32):
+  const __m256i tableLow = _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i*) low));
+  const __m256i tableHigh = _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i*) high));
+  const __m256i mask = _mm256_set1_epi8(15);
+  uint32_t index = 0;
+  for (; index + 32 <= size; index += 32) {
+    const __m256i bytes = _mm256_loadu_si256(
+      (const __m256i*) (source + index));
+    __m256i product = _mm256_xor_si256(
+      _mm256_shuffle_epi8(tableLow, _mm256_and_si256(bytes, mask)),
+      _mm256_shuffle_epi8(tableHigh,
+        _mm256_and_si256(_mm256_srli_epi64(bytes, 4), mask))
+    );
+    if (accumulate) {
+      product = _mm256_xor_si256(product,
+        _mm256_loadu_si256((const __m256i*) (target + index)));
+    }
+    _mm256_storeu_si256((__m256i*) (target + index), product);
+  }
+  return index;
+}
+#endif
+
+static void gf_region(
+  const uint8_t* low,
+  const uint8_t* high,
+  const uint8_t* source,
+  uint8_t* target,
+  const uint32_t size,
+  const int accumulate
+) {
+  // Multiplies source into target (which may be source) by tables:
+  uint32_t index = 0;
+  #if GF_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+      index = gf_region_avx2(low, high, source, target, size, accumulate);
+    }
+  #endif
+  for (; index < size; index++) {
+    const uint8_t product = low[source[index] & 15] ^ high[source[index] >> 4];
+    target[index] = accumulate ? target[index] ^ product : product;
+  }
+}
+
+const char* reed_solomon_gf_check(const int w, const int polynomial) {
+  if (w != 2 && w != 4 && w != 8) return "w != 2, 4, 8";
+  if (polynomial < 0 || polynomial >= (1 << (w + 1))) {
+    return "polynomial >= (1 << (w + 1))";
+  }
+  // The powers of x must reach every element before returning to 1:
+  const int y = (1 << w) - 1;
+  int power = 1;
+  for (int a = 1; a <= y; a++) {
+    power = gf_multiply(w, polynomial, power, 2);
+    if (power == 1 && a < y) return "polynomial is not primitive";
+  }
+  if (power != 1) return "polynomial is not primitive";
+  return NULL;
+}
+
+void reed_solomon_gf_multiply(
+  const int w,
+  const int polynomial,
+  const int c,
+  uint8_t* source,
+  uint8_t* target,
+  const uint32_t size,
+  const int accumulate
+) {
+  assert(reed_solomon_gf_check(w, polynomial) == NULL);
+  assert(c >= 0 && c < (1 << w));
+  if (size == 0) return;
+  if (c == 0) {
+    if (!accumulate) memset(target, 0, size);
+    return;
+  }
+  if (c == 1 && source != target) {
+    if (accumulate) {
+      dot_xor(source, target, size);
+    } else {
+      memmove(target, source, size);
+    }
+    return;
+  }
+  uint8_t low[16];
+  uint8_t high[16];
+  gf_tables(w, polynomial, c, low, high);
+  gf_region(low, high, source, target, size, accumulate);
+}
+
+void reed_solomon_gf_combine(
+  const int w,
+  const int polynomial,
+  const int count,
+  const uint8_t* coefficients,
+  uint8_t** sources,
+  uint8_t* target,
+  const uint32_t size
+) {
+  assert(reed_solomon_gf_check(w, polynomial) == NULL);
+  assert(count >= 1);
+  // Sources are combined block by block, GF_TABLES sources at a time:
+  uint8_t low[GF_TABLES][16];
+  uint8_t high[GF_TABLES][16];
+  for (int first = 0; first < count; first += GF_TABLES) {
+    const int group = count - first < GF_TABLES ? count - first : GF_TABLES;
+    for (int g = 0; g < group; g++) {
+      assert(coefficients[first + g] < (1 << w));
+      gf_tables(w, polynomial, coefficients[first + g], low[g], high[g]);
+    }
+    for (uint32_t offset = 0; offset < size; offset += GF_BLOCK) {
+      const uint32_t length = size - offset < GF_BLOCK ?
+        size - offset : GF_BLOCK;
+      for (int g = 0; g < group; g++) {
+        gf_region(low[g], high[g], sources[first + g] + offset,
+          target + offset, length, first + g > 0);
+      }
+    }
+  }
+}
+
+int reed_solomon_jit(const int enable) {
+  #if JIT_SUPPORTED
+    pthread_once(&jit_once, jit_init);
+    __atomic_store_n(&jit.enabled, enable ? 1 : 0, __ATOMIC_RELAXED);
+    return enable ? 1 : 0;
+  #else
+    (void) enable;
+    return 0;
+  #endif
+}
+
+static uint64_t calibrate_clock(void) {
+  // Returns a monotonic time in nanoseconds:
+  #ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) (
+      (double) counter.QuadPart * 1000000000.0 / (double) frequency.QuadPart
+    );
+  #else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + (uint64_t) time.tv_nsec;
+  #endif
+}
+
+// Each kernel encodes about this many bytes of data shards per trial:
+#define CALIBRATE_BYTES 16777216
+#define CALIBRATE_TRIALS 3
+
+int reed_solomon_calibrate(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t shardSize,
+  double* nanoseconds
+) {
+  // The context must have been checked by reed_solomon_check_context():
+  const int w = context[0];
+  const int k = context[1];
+  const int m = context[2];
+  const int l = context_lrc(context, contextSize);
+  const int substripes = reed_solomon_substripes(context, contextSize);
+  assert(shardSize > 0);
+  assert(shardSize % (8 * substripes) == 0);
+  // Substripes are encoded as shards of their own size, by the Cauchy code:
+  if (substripes > 1) {
+    return reed_solomon_calibrate(context, 3 + k * w * m * w,
+      shardSize / substripes, nanoseconds);
+  }
+  for (int kernel = 0; kernel < 4; kernel++) nanoseconds[kernel] = 0;
+  // Local parities of an LRC context are XORed by lrc_xor_group():
+  if (l == m) return REED_SOLOMON_KERNEL_DEFAULT;
+  uint8_t* stripe = malloc((size_t) (k + m) * shardSize);
+  if (!stripe) return -1;
+  uint8_t* shards[MAX_K + MAX_M];
+  uint32_t shardLengths[MAX_K + MAX_M];
+  for (int i = 0; i < k + m; i++) {
+    shards[i] = stripe + (size_t) i * shardSize;
+    shardLengths[i] = shardSize;
+  }
+  uint32_t seed = 2166136261u;
+  for (size_t index = 0; index < (size_t) k * shardSize; index++) {
+    seed = seed * 1664525 + 1013904223;
+    stripe[index] = (uint8_t) (seed >> 24);
+  }
+  int s[MAX_K];
+  for (int si = 0; si < k; si++) s[si] = si;
+  const uint8_t* bitmatrix = context + 3;
+  const uint32_t chunkSize = dot_chunk_size(w, k, shardSize);
+  uint64_t repeat = CALIBRATE_BYTES / ((uint64_t) k * shardSize);
+  if (repeat < 1) repeat = 1;
+  int fastest = REED_SOLOMON_KERNEL_DEFAULT;
+  for (int kernel = 1; kernel < 4; kernel++) {
+    if (
+      kernel == REED_SOLOMON_KERNEL_SPECIALIZED &&
+      dot_select(w, k) == dot
+    ) {
+      continue;
+    }
+    if (kernel == REED_SOLOMON_KERNEL_JIT) {
+      int compiled = 1;
+      for (int j = l; j < m; j++) {
+        if (jit_find(w, k, bitmatrix + k * w * w * j) == NULL) compiled = 0;
+      }
+      if (!compiled) continue;
+    }
+    uint64_t best = 0;
+    for (int trial = 0; trial < CALIBRATE_TRIALS; trial++) {
+      const uint64_t start = calibrate_clock();
+      for (uint64_t count = 0; count < repeat; count++) {
+        for (int j = l; j < m; j++) {
+          dot_run(
+            dispatch_kernel(kernel, w, k),
+            kernel,
+            w,
+            k,
+            shards,
+            shardLengths,
+            chunkSize,
+            shardSize,
+            bitmatrix + k * w * w * j,
+            s,
+            k + j
+          );
+        }
+      }
+      const uint64_t elapsed = calibrate_clock() - start;
+      if (trial == 0 || elapsed < best) best = elapsed;
+    }
+    nanoseconds[kernel] = (double) best / (double) repeat;
+    if (
+      fastest == REED_SOLOMON_KERNEL_DEFAULT ||
+      nanoseconds[kernel] < nanoseconds[fastest]
+    ) {
+      fastest = kernel;
+    }
+  }
+  free(stripe);
+  *dispatch_entry(w, k, shardSize) = (uint8_t) fastest;
+  return fastest;
+}
+
+int reed_solomon_dispatch_get(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+) {
+  return *dispatch_entry(w, k, shardSize);
+}
+
+void reed_solomon_dispatch_set(
+  const int w,
+  const int k,
+  const uint32_t shardSize,
+  const int kernel
+) {
+  assert(kernel >= 0 && kernel < 4);
+  *dispatch_entry(w, k, shardSize) = (uint8_t) kernel;
+}
+
+const char* reed_solomon_kernel_name(const int kernel) {
+  assert(kernel >= 0 && kernel < 4);
+  return DISPATCH_NAMES[kernel];
+}
+
+// The first line of a saved dispatch table, followed by a line of
+// "w k shardSize kernel" for every calibrated entry:
+#define DISPATCH_HEADER "reed-solomon dispatch 1"
+
+int reed_solomon_dispatch_save(const char* path) {
+  FILE* file = fopen(path, "w");
+  if (!file) return -1;
+  int error = fprintf(file, "%s\n", DISPATCH_HEADER) < 0;
+  const int ws[] = { 2, 4, 8 };
+  for (int wi = 0; wi < 3; wi++) {
+    for (int k = 1; k <= MAX_K; k++) {
+      for (int size = 0; size < DISPATCH_CLASSES; size++) {
+        const int kernel = dispatch_table[wi][k - 1][size];
+        if (kernel == REED_SOLOMON_KERNEL_DEFAULT) continue;
+        if (
+          fprintf(
+            file,
+            "%d %d %lu %s\n",
+            ws[wi],
+            k,
+            1UL << size,
+            DISPATCH_NAMES[kernel]
+          ) < 0
+        ) {
+          error = 1;
+        }
+      }
+    }
+  }
+  if (fclose(file) != 0) error = 1;
+  return error ? -1 : 0;
+}
+
+int reed_solomon_dispatch_load(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (!file) return -1;
+  uint8_t table[3][MAX_K][DISPATCH_CLASSES];
+  memset(table, 0, sizeof(table));
+  char line[256];
+  int valid = fgets(line, sizeof(line), file) != NULL &&
+    strncmp(line, DISPATCH_HEADER "\n", sizeof(line)) == 0;
+  while (valid && fgets(line, sizeof(line), file) != NULL) {
+    int w = 0;
+    int k = 0;
+    unsigned long shardSize = 0;
+    char name[16];
+    int kernel = -1;
+    if (sscanf(line, "%d %d %lu %15s", &w, &k, &shardSize, name) == 4) {
+      for (int index = 0; index < 4; index++) {
+        if (strcmp(name, DISPATCH_NAMES[index]) == 0) kernel = index;
+      }
+    }
+    if (
+      kernel < 0 ||
+      (w != 2 && w != 4 && w != 8) ||
+      k < 1 ||
+      k > MAX_K ||
+      shardSize == 0 ||
+      shardSize > 4294967295UL
+    ) {
+      valid = 0;
+      break;
+    }
+    int size = 0;
+    while ((shardSize >> size) > 1) size++;
+    table[w == 2 ? 0 : w == 4 ? 1 : 2][k - 1][size] = (uint8_t) kernel;
+  }
+  if (ferror(file)) valid = 0;
+  fclose(file);
+  if (!valid) {
+    errno = EINVAL;
+    return -1;
+  }
+  for (int wi = 0; wi < 3; wi++) {
+    for (int k = 0; k < MAX_K; k++) {
+      for (int size = 0; size < DISPATCH_CLASSES; size++) {
+        dispatch_table[wi][k][size] = table[wi][k][size];
+      }
+    }
+  }
+  return 0;
+}
+
+static void search_print_matrices(uint8_t matrices[24][6][MAX_K * MAX_M]) {
+  // Prints the MATRICES table, 12 elements to a line:
+  printf("static const uint8_t MATRICES[%i][%i][MAX_K * MAX_M] = {\n", 24, 6);
+  for (int k = 1; k <= 24; k++) {
+    printf("  {\n");
+    for (int m = 1; m <= 6; m++) {
+      printf("    {");
+      for (int index = 0; index < k * m; index++) {
+        if (index % 12 == 0) printf("\n     ");
+        printf(" %3i", matrices[k - 1][m - 1][index]);
+        if (index < k * m - 1) printf(",");
+      }
+      printf(m < 6 ? "\n    },\n" : "\n    }\n");
+    }
+    printf(k < 24 ? "  },\n" : "  }\n");
+  }
+  printf("};\n");
+}
+
+void reed_solomon_search(void) {
+  const int kl = 24;
+  const int ks[] = {
+     1,  2,  3,  4,  5,  6,  7,  8,  9, 10,
+    11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+    21, 22, 23, 24
+  };
+  const int ml = 6;
+  const int ms[] = { 1, 2, 3, 4, 5, 6 };
+  const int wl = 3;
+  const int ws[] = { 2, 4, 8 };
+  const int pl2 = 1;
+  const int ps2[] = { 7 };
+  const int pl4 = 1;
+  const int ps4[] = { 19 };
+  const int pl8 = 16;
+  const int ps8[] = {
+     29,  43,  45,  77,  95,  99, 101, 105,
+    113, 135, 141, 169, 195, 207, 231, 245
+  };
+  const int pl[] = { pl2, pl4, pl8 };
+  const int* ps[] = { ps2, ps4, ps8 };
+  int log[256];
+  int exp[256];
+  int bit[256];
+  int min[256];
+  uint8_t matrix[65536];
+  static uint8_t matrices[24][6][MAX_K * MAX_M];
+  printf("static const int PARAMETERS[%i][%i][7] = {\n", kl, ml);
+  for (int ki = 0; ki < kl; ki++) {
+    int k = ks[ki];
+    assert(k >= 1);
+    assert(k <= 24);
+    printf("  {\n");
+    for (int mi = 0; mi < ml; mi++) {
+      int m = ms[mi];
+      assert(m >= 1);
+      assert(m <= 6);
+      int minB = -1;
+      int minW = -1;
+      int minP = -1;
+      int minX = -1;
+      int minY = -1;
+      for (int wi = 0; wi < wl; wi++) {
+        int w = ws[wi];
+        assert(w <= MAX_W);
+        assert(w == 2 || w == 4 || w == 8);
+        if (k + m > (1 << w)) continue;
+        for (int pi = 0; pi < pl[wi]; pi++) {
+          int p = ps[wi][pi];
+          assert(p >= 1);
+          create_tables(w, p, log, exp, bit, min);
+          if (m <= 2) {
+            int x = -1;
+            int y = -1;
+            int b = create_matrix(log, exp, bit, min, w, k, m, x, y, matrix);
+            if (b < minB || minB == -1) {
+              minB = b;
+              minW = w;
+              minP = p;
+              minX = -1;
+              minY = -1;
+            }
+            continue;
+          }
+          int z = (1 << w);
+          for (int x = 0; x + k <= z; x++) {
+            for (int y = 0; y + m <= z; y++) {
+              if (x == y) continue;
+              if (x < y && (x + k) > y) continue;
+              if (y < x && (y + m) > x) continue;
+              int b = create_matrix(log, exp, bit, min, w, k, m, x, y, matrix);
+              if (b < minB || minB == -1) {
+                minB = b;
+                minW = w;
+                minP = p;
+                minX = x;
+                minY = y;
+              }
+            }
+          }
+        }
+      }
+      create_tables(minW, minP, log, exp, bit, min);
+      create_matrix(log, exp, bit, min, minW, k, m, minX, minY,
+        matrices[ki][mi]);
+      printf(
+        "    { %2i, %1i, %1i, %3i, %3i, %3i, %4i }",
+        k, m, minW, minP, minX, minY, minB
+      );
+      printf(mi < ml - 1 ? ",\n" : "\n");
+    }
+    printf(ki < kl - 1 ? "  },\n" : "  }\n");
+  }
+  printf("};\n\n");
+  search_print_matrices(matrices);
+}
@@ -0,0 +1,294 @@
+// Cauchy Reed-Solomon and Local Reconstruction Code (LRC) erasure coding.
+//
+// This is the codec behind binding.c, with no dependency on Node, N-API or
+// libuv, so that native programs can encode and repair exactly the same parity
+// as the Node addon. Contexts are plain bytes (and are the same bytes as the
+// context buffers returned by create(), createLRC() and createPiggyback() in
+// JavaScript).
+//
+// Every function is thread-safe. Contexts may be shared between threads.
+
+#ifndef REED_SOLOMON_H
+#define REED_SOLOMON_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Incremented whenever a function or the layout of a context changes:
+#define REED_SOLOMON_ABI_VERSION 5
+
+#define REED_SOLOMON_MAX_K 24
+#define REED_SOLOMON_MAX_M 6
+#define REED_SOLOMON_MAX_W 8
+
+// The largest context (an LRC context, with its trailer), in bytes:
+#define REED_SOLOMON_CONTEXT_SIZE (                                            \
+  3 +                                                                          \
+  REED_SOLOMON_MAX_K * REED_SOLOMON_MAX_W *                                    \
+  REED_SOLOMON_MAX_M * REED_SOLOMON_MAX_W +                                    \
+  2                                                                            \
+)
+
+// Returns REED_SOLOMON_ABI_VERSION as compiled into the library:
+int reed_solomon_abi_version(void);
+
+// Writes a context for k data shards and m parity shards to context (of at
+// least REED_SOLOMON_CONTEXT_SIZE bytes) and returns its size, or 0 if k or m
+// is out of range:
+uint32_t reed_solomon_create(const int k, const int m, uint8_t* context);
+
+// Writes an LRC context for k data shards in l local groups, with l local
+// parities and r global parities (m = l + r), and returns its size, or 0 if k,
+// l or r is out of range:
+uint32_t reed_solomon_create_lrc(
+  const int k,
+  const int l,
+  const int r,
+  uint8_t* context
+);
+
+// Writes a piggyback context for k data shards and m parity shards (m >= 2),
+// and returns its size, or 0 if k or m is out of range. Every shard of a
+// piggyback stripe is two substripes (its first and second half), and parity
+// shards 1 to m - 1 of the second substripe carry the XOR of the first
+// substripe of a group of data shards, so that a single data shard is repaired
+// from fewer bytes than k shards (see reed_solomon_reads_substripe()):
+uint32_t reed_solomon_create_piggyback(
+  const int k,
+  const int m,
+  uint8_t* context
+);
+
+// Returns the number of substripes in each shard of a stripe (2 for a
+// piggyback context, else 1):
+int reed_solomon_substripes(
+  const uint8_t* context,
+  const uint32_t contextSize
+);
+
+// Returns NULL if a context is valid, else an error message:
+const char* reed_solomon_check_context(
+  const uint8_t* context,
+  const uint32_t contextSize
+);
+
+// Returns NULL if the targets of a valid context can be encoded (or repaired)
+// from the sources, else an error message. Bit i of sources and targets is
+// shard i, where data shards are [0, k) and parity shards are [k, k + m):
+const char* reed_solomon_check_flags(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets
+);
+
+// Returns the size (per shard) of a region, which is the unit in which
+// reed_solomon_encode_range() may encode a stripe:
+uint32_t reed_solomon_region_size(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+);
+
+// Encodes the targets of a stripe from its sources, given a context and flags
+// which have been checked. shards[i] points to shard i, of shardLengths[i]
+// bytes. Data shards may be short (or empty) and are padded virtually with
+// zeroes to shardSize, which must be a multiple of 8 bytes. Parity shards are
+// always shardSize bytes. The parity is the same for the same shardSize,
+// however the stripe is encoded:
+void reed_solomon_encode(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSize
+);
+
+// Encodes only [offset, offset + size) of every shard of a stripe, where
+// offset and size are multiples of reed_solomon_region_size() (except that
+// the last range may end at shardSize), so that threads may encode a large
+// stripe in ranges. Where a context has substripes, shardSize must be a
+// multiple of 8 bytes per substripe, and the range (and the region size) is
+// of each substripe of shardSize / substripes bytes:
+void reed_solomon_encode_range(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSize,
+  const uint32_t offset,
+  const uint32_t size
+);
+
+// Encodes [offset, offset + size) of a stripe (as for
+// reed_solomon_encode_range()) whose data shards are interleaved in data as
+// stripe units of unit bytes, RAID-style. Byte x of data shard i is at
+//
+//   data + (x / unit) * stride + ((i + (x / unit) * rotation) % k) * unit +
+//   x % unit
+//
+// where stride >= k * unit and rotation < k. Data shards are shardSize bytes (a
+// multiple of unit and of 8), and parity[j] points to parity shard j, of
+// shardSize bytes. Units which are a multiple of reed_solomon_region_size() are
+// encoded in place. Otherwise, scratch (of k region sizes) holds the sources
+// of a region at a time. The parity is the same as for contiguous shards, and
+// contexts with substripes are not supported:
+void reed_solomon_encode_layout(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  uint8_t* data,
+  const uint64_t stride,
+  const uint32_t unit,
+  const uint32_t rotation,
+  uint8_t** parity,
+  const uint32_t shardSize,
+  const uint32_t offset,
+  const uint32_t size,
+  uint8_t* scratch
+);
+
+// Returns the shards (as flags) which reed_solomon_encode() reads from the
+// sources to encode the targets, given a context and flags which have been
+// checked. Where more than k shards survive, the decoder reads the k whose
+// decoding matrix has the fewest ones (the fewest XORs), choosing them once
+// for each pattern of sources:
+uint32_t reed_solomon_reads(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets
+);
+
+// Returns the shards (as flags) whose substripe, in [0,
+// reed_solomon_substripes()), reed_solomon_encode() reads. reed_solomon_reads()
+// is the union over every substripe:
+uint32_t reed_solomon_reads_substripe(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t sources,
+  const uint32_t targets,
+  const int substripe
+);
+
+// Results of reed_solomon_locate() for each region:
+#define REED_SOLOMON_LOCATE_CONSISTENT -1 // The parity matches the data.
+#define REED_SOLOMON_LOCATE_UNKNOWN -2 // Corrupt, but the shard is not located.
+
+// Checks every shard of a stripe (all k data shards and all m parity shards,
+// each parity shard of shardSize bytes, a multiple of 8) in a single pass, by
+// encoding the parity afresh and comparing it with the parity of the stripe.
+// Writes to located[r] for each region r of reed_solomon_region_size() bytes
+// per shard (shardSize / region size regions) either a result above or the
+// index of the one shard which explains the syndromes of the region. Where a
+// context has substripes, regions are of each substripe in turn. Locating
+// a shard needs m >= 2 (or an LRC group of 1), and at most one corrupt shard
+// per region. Returns the number of regions which are not consistent, or -1 if
+// there is insufficient memory:
+int reed_solomon_locate(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  uint8_t** shards,
+  const uint32_t* shardLengths,
+  const uint32_t shardSize,
+  int* located
+);
+
+// XORs size bytes of source into target:
+void reed_solomon_xor(uint8_t* source, uint8_t* target, const uint32_t size);
+
+// Returns NULL if polynomial (with or without its x^w term) is primitive and
+// so defines GF(2^w), for w of 2, 4 or 8, else an error message. The fields of
+// contexts use the polynomials 7 (w = 2), 19 (w = 4) and 29, 101, 113, 135,
+// 169 or 195 (w = 8):
+const char* reed_solomon_gf_check(const int w, const int polynomial);
+
+// Multiplies size bytes of source by c over GF(2^w), where each byte packs
+// 8 / w elements (from the low bits), writing the product to target (or XORing
+// it into target if accumulate is 1). Source may be target, but may not
+// otherwise overlap it:
+void reed_solomon_gf_multiply(
+  const int w,
+  const int polynomial,
+  const int c,
+  uint8_t* source,
+  uint8_t* target,
+  const uint32_t size,
+  const int accumulate
+);
+
+// Writes the sum over GF(2^w) of coefficients[i] times sources[i] (for count
+// sources, each of size bytes) to target in a single pass over target:
+void reed_solomon_gf_combine(
+  const int w,
+  const int polynomial,
+  const int count,
+  const uint8_t* coefficients,
+  uint8_t** sources,
+  uint8_t* target,
+  const uint32_t size
+);
+
+// Enables (or disables) the JIT, returning 1 if the JIT is supported (x86-64
+// Linux only) and enabled, else 0:
+int reed_solomon_jit(const int enable);
+
+// Kernels which encode the rows of a bitmatrix, chosen per (w, k) and class
+// of shard size (a power of 2) by the dispatch table:
+#define REED_SOLOMON_KERNEL_DEFAULT 0 // Specialized, and the JIT if enabled.
+#define REED_SOLOMON_KERNEL_GENERIC 1 // The portable loop over any (w, k).
+#define REED_SOLOMON_KERNEL_SPECIALIZED 2 // Unrolled for (w, k), if compiled.
+#define REED_SOLOMON_KERNEL_JIT 3 // Compiled for each row (x86-64 Linux).
+
+// Times every kernel available for a context and shard size (a multiple of 8
+// bytes) and records the fastest in the dispatch table, returning it, or -1 if
+// there is insufficient memory. Writes the nanoseconds taken to encode a
+// stripe to nanoseconds[kernel] (0 if the kernel is not available), except for
+// REED_SOLOMON_KERNEL_DEFAULT. Every kernel encodes exactly the same parity:
+int reed_solomon_calibrate(
+  const uint8_t* context,
+  const uint32_t contextSize,
+  const uint32_t shardSize,
+  double* nanoseconds
+);
+
+// Returns (or sets) the kernel in the dispatch table for (w, k) and the class
+// of shardSize:
+int reed_solomon_dispatch_get(
+  const int w,
+  const int k,
+  const uint32_t shardSize
+);
+void reed_solomon_dispatch_set(
+  const int w,
+  const int k,
+  const uint32_t shardSize,
+  const int kernel
+);
+
+// Returns the name of a kernel ("default", "generic", "specialized" or "jit"):
+const char* reed_solomon_kernel_name(const int kernel);
+
+// Saves (or loads) every calibrated entry of the dispatch table to (or from) a
+// text file, for a fast restart on the same machine, returning 0 on success or
+// -1 on failure (with errno set). A file which cannot be parsed is not loaded:
+int reed_solomon_dispatch_save(const char* path);
+int reed_solomon_dispatch_load(const char* path);
+
+// Searches for the optimal parameters of every (k, m), printing them to stdout
+// as the PARAMETERS table (this takes several minutes):
+void reed_solomon_search(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,8 +1,15 @@
 var assert = require('assert');
 
-var Node = { crypto: require('crypto') };
+var Node = {
+  crypto: require('crypto'),
+  fs: require('fs'),
+  os: require('os'),
+  path: require('path'),
+  worker_threads: require('worker_threads')
+};
 var Queue = require('@ronomon/queue');
-var ReedSolomon = require('./binding.node');
+// The checked build asserts the arguments of kernels for every chunk:
+var ReedSolomon = require('./binding_checked.node');
 
 function Args(options) {
   var w = options.w === undefined ? 4 : options.w;
@@ -71,12 +78,52 @@ function Args(options) {
 }
 
 var BadArgs = {
+  allocStripe: 'bad arguments, expected: (int k, int m, int shardSize)',
   create: 'bad arguments, expected: (int k, int m)',
+  createLRC: 'bad arguments, expected: (int k, int l, int r)',
+  createPiggyback: 'bad arguments, expected: (int k, int m)',
   encode: 'bad arguments, expected: (Buffer context, int sources, ' +
           'int targets, Buffer buffer, int bufferOffset, int bufferSize, ' +
+          'Buffer parity, int parityOffset, int paritySize, ' +
+          '[int priority], function end)',
+  encodeLayout: 'bad arguments, expected: (Buffer context, Array layout, ' +
+                'int sources, int targets, Buffer buffer, int bufferOffset, ' +
+                'int bufferSize, Buffer parity, int parityOffset, ' +
+                'int paritySize, [int priority], function end)',
+  createEncoder: 'bad arguments, expected: (Buffer context, int slots)',
+  createVolume: 'bad arguments, expected: (Buffer context, int shardSize, ' +
+                'Buffer buffer, Buffer parity, int concurrency)',
+  run: 'bad arguments, expected: (int sources, int targets, ' +
+       'Buffer buffer, int bufferOffset, int bufferSize, ' +
+       'Buffer parity, int parityOffset, int paritySize, ' +
+       '[int priority], function end)',
+  locate: 'bad arguments, expected: (Buffer context, ' +
+          'Buffer buffer, int bufferOffset, int bufferSize, ' +
           'Buffer parity, int parityOffset, int paritySize, function end)',
+  reads: 'bad arguments, expected: (Buffer context, int sources, ' +
+         'int targets, [int substripe])',
+  schedule: 'bad arguments, expected: (int concurrency, int background)',
+  cancel: 'bad arguments, expected: (int id)',
+  calibrate: 'bad arguments, expected: (Buffer context, int shardSize, ' +
+    'function end)',
+  dispatchFile: 'bad arguments, expected: (string path)',
+  threads: 'bad arguments, expected: (int threads, int pin)',
+  completions: 'bad arguments, expected: (int batch, int reuse)',
+  jit: 'bad arguments, expected: (int enable)',
   XOR:    'bad arguments, expected: (Buffer source, int sourceOffset, ' +
-          'Buffer target, int targetOffset, int size)'
+          'Buffer target, int targetOffset, int size)',
+  gfMultiply: 'bad arguments, expected: (int w, int polynomial, int c, ' +
+              'Buffer source, int sourceOffset, ' +
+              'Buffer target, int targetOffset, int size, [function end])',
+  gfCombine: 'bad arguments, expected: (int w, int polynomial, ' +
+             'Array coefficients, Array sources, ' +
+             'Buffer target, int targetOffset, int size, [function end])',
+  encodeFile: 'bad arguments, expected: (Buffer context, int shardSize, ' +
+              'int fd, int fdOffset, int fdSize, ' +
+              'Array parityFds, int parityOffset, function end)',
+  repairFile: 'bad arguments, expected: (Buffer context, int sources, ' +
+              'int targets, int shardSize, int fd, int fdOffset, ' +
+              'int fdSize, Array parityFds, int parityOffset, function end)'
 };
 
 function Bits(flags) {
@@ -210,6 +257,51 @@ var B16 = Buffer.alloc(16);
   [ 'create', [ReedSolomon.MAX_K + 1, 1], 'k > MAX_K' ],
   [ 'create', [1, 0], 'm < 1' ],
   [ 'create', [1, ReedSolomon.MAX_M + 1], 'm > MAX_M' ],
+  [ 'createLRC', [], BadArgs.createLRC ],
+  [ 'createLRC', [4, 2], BadArgs.createLRC ],
+  [ 'createLRC', [0, 1, 1], 'k < 1' ],
+  [ 'createLRC', [25, 1, 1], 'k > MAX_K' ],
+  [ 'createLRC', [4, 0, 1], 'l < 1' ],
+  [ 'createLRC', [4, 5, 1], 'l > k' ],
+  [ 'createLRC', [20, 2, 5], 'l + r > MAX_M' ],
+  [ 'createPiggyback', [], BadArgs.createPiggyback ],
+  [ 'createPiggyback', [4, 2.5], BadArgs.createPiggyback ],
+  [ 'createPiggyback', [0, 2], 'k < 1' ],
+  [ 'createPiggyback', [25, 2], 'k > MAX_K' ],
+  [ 'createPiggyback', [4, 1], 'm < 2' ],
+  [ 'createPiggyback', [4, 7], 'm > MAX_M' ],
+  [
+    'encode',
+    [
+      ReedSolomon.createPiggyback(2, 2),
+      3,
+      12,
+      B16,
+      0,
+      16,
+      B16,
+      0,
+      16,
+      function() {}
+    ],
+    'paritySize / m != paddedShardSize'
+  ],
+  [
+    'encode',
+    [
+      ReedSolomon.createLRC(4, 2, 1),
+      3,
+      12,
+      B16,
+      0,
+      16,
+      B16,
+      0,
+      16,
+      function() {}
+    ],
+    'sources cannot repair targets'
+  ],
   [ 'encode', [], BadArgs.encode ],
   [ 'encode', Args({ context: B1 }), 'context.length < 3' ],
   [
@@ -245,14 +337,35 @@ var B16 = Buffer.alloc(16);
   [ 'encode', Args({ bufferSize: 0 }), 'bufferSize == 0' ],
   [
     'encode',
-    Args({ bufferOffset: 4294967296, bufferSize: 8, buffer: B8 }),
+    Args({}).slice(0, 9).concat([0.5, function() {}]),
     BadArgs.encode
   ],
   [
     'encode',
-    Args({ bufferOffset: 0, bufferSize: 4294967296, buffer: B8 }),
+    Args({}).slice(0, 9).concat([2, function() {}]),
+    'priority != 0, 1'
+  ],
+  [ 'encode', Args({}).concat([0]), BadArgs.encode ],
+  [
+    'encode',
+    Args({ bufferOffset: 9007199254740992, bufferSize: 8, buffer: B8 }),
+    BadArgs.encode
+  ],
+  [
+    'encode',
+    Args({ bufferOffset: 0, bufferSize: 9007199254740992, buffer: B8 }),
     BadArgs.encode
   ],
+  [
+    'encode',
+    Args({ bufferOffset: 4294967296, bufferSize: 8, buffer: B8 }),
+    'bufferOffset + bufferSize > buffer.length'
+  ],
+  [
+    'encode',
+    Args({ bufferOffset: 0, bufferSize: 4294967296, buffer: B8 }),
+    'bufferOffset + bufferSize > buffer.length'
+  ],
   [
     'encode',
     Args({ bufferOffset: 1, bufferSize: 8, buffer: B8 }),
@@ -263,22 +376,30 @@ var B16 = Buffer.alloc(16);
     Args({ bufferOffset: 4294967295, bufferSize: 8, buffer: B8 }),
     'bufferOffset + bufferSize > buffer.length'
   ],
-  [ 'encode', Args({ bufferSize: 16 }), 'bufferSize % k != 0' ],
-  [ 'encode', Args({ bufferSize: 30 }), 'shardSize % w != 0' ],
-  [ 'encode', Args({ bufferSize: 12 }), 'shardSize % 8 != 0' ],
   [ 'encode', Args({ paritySize: 0 }), 'paritySize == 0' ],
   [ 'encode', Args({ paritySize: 7 }), 'paritySize % m != 0' ],
-  [ 'encode', Args({ paritySize: 8 }), 'paritySize / m != bufferSize / k' ],
+  [ 'encode', Args({ paritySize: 8 }), 'paritySize / m != paddedShardSize' ],
+  [ 'encode', Args({ bufferSize: 30 }), 'paritySize / m != paddedShardSize' ],
   [
     'encode',
-    Args({ parityOffset: 4294967296, paritySize: 16, parity: B16 }),
+    Args({ bufferSize: 30, paritySize: 20 }),
+    'paritySize / m != paddedShardSize'
+  ],
+  [
+    'encode',
+    Args({ parityOffset: 9007199254740992, paritySize: 16, parity: B16 }),
     BadArgs.encode
   ],
   [
     'encode',
-    Args({ parityOffset: 0, paritySize: 4294967296, parity: B16 }),
+    Args({ parityOffset: 0, paritySize: 9007199254740992, parity: B16 }),
     BadArgs.encode
   ],
+  [
+    'encode',
+    Args({ parityOffset: 4294967296, paritySize: 16, parity: B16 }),
+    'parityOffset + paritySize > parity.length'
+  ],
   [
     'encode',
     Args({ parityOffset: 1, paritySize: 16, parity: B16 }),
@@ -289,19 +410,264 @@ var B16 = Buffer.alloc(16);
     Args({ parityOffset: 4294967295, paritySize: 16, parity: B16 }),
     'parityOffset + paritySize > parity.length'
   ],
+  [ 'encodeFile', [], BadArgs.encodeFile ],
+  [
+    'encodeFile',
+    [ReedSolomon.create(2, 2), 8, 0, 0, 0, [0], 0, function() {}],
+    BadArgs.encodeFile
+  ],
+  [
+    'encodeFile',
+    [ReedSolomon.create(2, 2), 8, -1, 0, 0, [0, 0], 0, function() {}],
+    BadArgs.encodeFile
+  ],
+  [
+    'encodeFile',
+    [ReedSolomon.create(2, 2), 12, 0, 0, 0, [0, 0], 0, function() {}],
+    'shardSize % 8 != 0'
+  ],
+  [
+    'encodeFile',
+    [ReedSolomon.create(2, 2), 0, 0, 0, 0, [0, 0], 0, function() {}],
+    'shardSize == 0'
+  ],
+  [
+    'encodeFile',
+    [ReedSolomon.create(2, 2), 8, 0, 0, 0, [0, -1], 0, function() {}],
+    'parityFds[j] < 0'
+  ],
+  [ 'repairFile', [], BadArgs.repairFile ],
+  [
+    'repairFile',
+    [ReedSolomon.create(2, 2), 1, 2, 8, 0, 0, 0, [0, 0], 0, function() {}],
+    'sources < k'
+  ],
+  [
+    'repairFile',
+    [ReedSolomon.create(2, 2), 7, 12, 8, 0, 0, 0, [0, 0], 0, function() {}],
+    '(sources & targets) != 0'
+  ],
+  [ 'allocStripe', [], BadArgs.allocStripe ],
+  [ 'allocStripe', [0, 1, 8], 'k < 1' ],
+  [ 'allocStripe', [25, 1, 8], 'k > MAX_K' ],
+  [ 'allocStripe', [1, 0, 8], 'm < 1' ],
+  [ 'allocStripe', [1, 7, 8], 'm > MAX_M' ],
+  [ 'allocStripe', [1, 1, 0], 'shardSize == 0' ],
+  [ 'allocStripe', [24, 1, 4294967295], 'k * shardSize > 4294967295' ],
+  [ 'calibrate', [], BadArgs.calibrate ],
+  [ 'calibrate', [B1, -1, function() {}], BadArgs.calibrate ],
+  [ 'calibrate', [ReedSolomon.create(2, 2), 8], BadArgs.calibrate ],
+  [ 'calibrate', [B1, 8, function() {}], 'context.length < 3' ],
+  [
+    'calibrate',
+    [ReedSolomon.create(2, 2), 0, function() {}],
+    'shardSize == 0'
+  ],
+  [
+    'calibrate',
+    [ReedSolomon.create(2, 2), 12, function() {}],
+    'shardSize % 8 != 0'
+  ],
+  [
+    'calibrate',
+    [ReedSolomon.createPiggyback(2, 2), 8, function() {}],
+    'shardSize % 16 != 0'
+  ],
+  [ 'cancel', [], BadArgs.cancel ],
+  [ 'cancel', [-1], BadArgs.cancel ],
+  [ 'completions', [], BadArgs.completions ],
+  [ 'completions', [2, 0], 'batch != 0, 1' ],
+  [ 'completions', [0, 2], 'reuse != 0, 1' ],
+  [ 'createEncoder', [], BadArgs.createEncoder ],
+  [ 'createEncoder', [B1, -1], BadArgs.createEncoder ],
+  [ 'createEncoder', [B1, 1], 'context.length < 3' ],
+  [ 'createEncoder', [ReedSolomon.create(2, 2), 0], 'slots < 1' ],
+  [
+    'createEncoder',
+    [ReedSolomon.create(2, 2), 65537],
+    'slots > ENCODER_MAX_SLOTS'
+  ],
+  [ 'dispatch', [undefined], 'expected no arguments' ],
+  [ 'createVolume', [], BadArgs.createVolume ],
+  [ 'createVolume', [B1, 8, B8, B8], BadArgs.createVolume ],
+  [ 'createVolume', [B1, 8, B8, B8, -1], BadArgs.createVolume ],
+  [ 'createVolume', [B1, 8, null, B8, 1], BadArgs.createVolume ],
+  [ 'createVolume', [B1, 8, B8, B8, 1], 'context.length < 3' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 0, B8, B16, 1],
+    'shardSize == 0' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 4, B8, B16, 1],
+    'shardSize % 8 != 0' ],
+  [ 'createVolume', [ReedSolomon.createPiggyback(2, 2), 8, B8, B16, 1],
+    'shardSize % 16 != 0' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 8, B0, B16, 1],
+    'buffer.length == 0' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 8, B16, B8, 1],
+    'parity.length < stripes * m * shardSize' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 8, Buffer.alloc(17), B16, 1],
+    'parity.length < stripes * m * shardSize' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 8, B16, B16, 0],
+    'concurrency < 1' ],
+  [ 'createVolume', [ReedSolomon.create(2, 2), 8, B16, B16, 257],
+    'concurrency > VOLUME_MAX_CONCURRENCY' ],
+  [ 'jit', [], BadArgs.jit ],
+  [ 'loadDispatch', [], BadArgs.dispatchFile ],
+  [ 'loadDispatch', [''], BadArgs.dispatchFile ],
+  [ 'loadDispatch', ['a\u0000b'], BadArgs.dispatchFile ],
+  [
+    'loadDispatch',
+    [Node.path.join(Node.os.tmpdir(), 'reed-solomon-missing', 'dispatch')],
+    'loadDispatch: No such file or directory'
+  ],
+  [ 'saveDispatch', [1], BadArgs.dispatchFile ],
+  [ 'jit', [2], 'enable != 0, 1' ],
+  [ 'locate', [], BadArgs.locate ],
+  [ 'locate', [B1, B1, 0, 1, B1, 0, 1], BadArgs.locate ],
+  [ 'locate', [B1, B1, 0, 1, B1, 0, 1, function() {}], 'context.length < 3' ],
+  [
+    'locate',
+    [ReedSolomon.create(2, 2), B16, 0, 16, B16, 0, 8, function() {}],
+    'paritySize / m != paddedShardSize'
+  ],
+  [
+    'locate',
+    [ReedSolomon.create(2, 2), B16, 0, 17, B16, 0, 16, function() {}],
+    'bufferOffset + bufferSize > buffer.length'
+  ],
+  [ 'encodeLayout', [], BadArgs.encodeLayout ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    BadArgs.encodeLayout
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16, 0], 3, 4, B16, 0, 16, B8, 0, 8, 2,
+      function() {}],
+    'priority != 0, 1'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.createPiggyback(2, 2), [8, 16, 0], 3, 4, B16, 0, 16, B16, 0,
+      16, function() {}],
+    'layout of substripes'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [0, 16, 0], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    'unit == 0'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [4, 16, 0], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    'unit % 8 != 0'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 8, 0], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    'stride < k * unit'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16, 2], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    'rotation >= k'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16, 0], 3, 4, B16, 0, 24, B8, 0, 8,
+      function() {}],
+    'bufferOffset + bufferSize > buffer.length'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 24, 0], 3, 4, B16, 0, 16, B8, 0, 8,
+      function() {}],
+    'bufferSize % stride != 0'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16, 0], 3, 4, B16, 0, 16, B16, 0, 16,
+      function() {}],
+    'paritySize / m != shardSize'
+  ],
+  [
+    'encodeLayout',
+    [ReedSolomon.create(2, 1), [8, 16, 0], 3, 4, B16, 0, 16, B8, 1, 8,
+      function() {}],
+    'parityOffset + paritySize > parity.length'
+  ],
+  [ 'reads', [], BadArgs.reads ],
+  [ 'reads', [B1, 1, -1], BadArgs.reads ],
+  [ 'reads', [B1, 1, 2], 'context.length < 3' ],
+  [ 'reads', [ReedSolomon.create(2, 2), 1, 2], 'sources < k' ],
+  [ 'reads', [ReedSolomon.create(2, 2), 3, 3], '(sources & targets) != 0' ],
+  [ 'reads', [ReedSolomon.create(2, 2), 3, 4, -1], BadArgs.reads ],
+  [ 'reads', [ReedSolomon.create(2, 2), 3, 4, 1], 'substripe >= substripes' ],
+  [
+    'reads',
+    [ReedSolomon.createPiggyback(2, 2), 3, 4, 2],
+    'substripe >= substripes'
+  ],
+  [ 'schedule', [], BadArgs.schedule ],
+  [ 'schedule', [1, -1], BadArgs.schedule ],
   [ 'search', [undefined], 'expected no arguments' ],
+  [ 'stripeStats', [undefined], 'expected no arguments' ],
+  [ 'threads', [], BadArgs.threads ],
+  [ 'threads', [1.5, 0], BadArgs.threads ],
+  [ 'threads', [257, 0], 'threads > POOL_MAX_THREADS' ],
+  [ 'threads', [1, 2], 'pin != 0, 1' ],
   [ 'XOR', [], BadArgs.XOR ],
   [ 'XOR', [null, 0, null, 0, 0], BadArgs.XOR ],
   [ 'XOR', [B1, 0, B1, 0, -1], BadArgs.XOR ],
-  [ 'XOR', [B1, 4294967296, B1, 0, 1], BadArgs.XOR ],
-  [ 'XOR', [B1, 0, B1, 4294967296, 1], BadArgs.XOR ],
-  [ 'XOR', [B1, 0, B1, 0, 4294967296], BadArgs.XOR ],
+  [ 'XOR', [B1, 9007199254740992, B1, 0, 1], BadArgs.XOR ],
+  [ 'XOR', [B1, 0, B1, 9007199254740992, 1], BadArgs.XOR ],
+  [ 'XOR', [B1, 0, B1, 0, 9007199254740992], BadArgs.XOR ],
+  [ 'XOR', [B1, 4294967296, B1, 0, 1], 'sourceOffset + size > source.length' ],
+  [ 'XOR', [B1, 0, B1, 4294967296, 1], 'targetOffset + size > target.length' ],
+  [ 'XOR', [B1, 0, B1, 0, 4294967296], 'sourceOffset + size > source.length' ],
   [ 'XOR', [B0, 1, B0, 0, 0], 'sourceOffset + size > source.length' ],
   [ 'XOR', [B0, 0, B1, 0, 1], 'sourceOffset + size > source.length' ],
   [ 'XOR', [B1, 4294967295, B1, 0, 1], 'sourceOffset + size > source.length' ],
   [ 'XOR', [B0, 0, B0, 1, 0], 'targetOffset + size > target.length' ],
   [ 'XOR', [B1, 0, B0, 0, 1], 'targetOffset + size > target.length' ],
-  [ 'XOR', [B1, 0, B1, 4294967295, 1], 'targetOffset + size > target.length' ]
+  [ 'XOR', [B1, 0, B1, 4294967295, 1], 'targetOffset + size > target.length' ],
+  [ 'gfMultiply', [], BadArgs.gfMultiply ],
+  [ 'gfMultiply', [8, 29, 2, B1, 0, B1, 0], BadArgs.gfMultiply ],
+  [ 'gfMultiply', [8, 29, 2, B1, 0, B1, 0, 1, 1], BadArgs.gfMultiply ],
+  [ 'gfMultiply', [8, 29, -1, B1, 0, B1, 0, 1], BadArgs.gfMultiply ],
+  [ 'gfMultiply', [8, 29, 2, null, 0, B1, 0, 1], BadArgs.gfMultiply ],
+  [ 'gfMultiplyXOR', [8, 29, 2, B1, 0, B1, 0, -1], BadArgs.gfMultiply ],
+  [ 'gfMultiply', [3, 11, 2, B1, 0, B1, 0, 1], 'w != 2, 4, 8' ],
+  [ 'gfMultiply', [9, 29, 2, B1, 0, B1, 0, 1], 'w != 2, 4, 8' ],
+  [ 'gfMultiply', [4, 32, 2, B1, 0, B1, 0, 1], 'polynomial >= (1 << (w + 1))' ],
+  [ 'gfMultiply', [8, 1024, 2, B1, 0, B1, 0, 1], 'polynomial >= (1 << (w + 1))' ],
+  [ 'gfMultiply', [8, 27, 2, B1, 0, B1, 0, 1], 'polynomial is not primitive' ],
+  [ 'gfMultiply', [4, 31, 2, B1, 0, B1, 0, 1], 'polynomial is not primitive' ],
+  [ 'gfMultiply', [4, 19, 16, B1, 0, B1, 0, 1], 'c >= (1 << w)' ],
+  [ 'gfMultiply', [8, 29, 2, B1, 1, B8, 0, 1], 'sourceOffset + size > source.length' ],
+  [ 'gfMultiply', [8, 29, 2, B8, 0, B1, 0, 2], 'targetOffset + size > target.length' ],
+  [ 'gfMultiply', [8, 29, 2, B16, 0, B16, 1, 8], 'source overlaps target' ],
+  [ 'gfMultiplyXOR', [8, 29, 2, B16, 8, B16, 7, 8], 'source overlaps target' ],
+  [ 'gfCombine', [], BadArgs.gfCombine ],
+  [ 'gfCombine', [8, 29, 1, [B1], B1, 0, 1], BadArgs.gfCombine ],
+  [ 'gfCombine', [8, 29, [1], B1, B1, 0, 1], BadArgs.gfCombine ],
+  [ 'gfCombine', [8, 29, [1], [B1], B1, 0, 1, null], BadArgs.gfCombine ],
+  [ 'gfCombine', [2, 5, [1], [B1], B1, 0, 1], 'polynomial is not primitive' ],
+  [ 'gfCombine', [8, 29, [], [], B1, 0, 1], 'coefficients.length == 0' ],
+  [ 'gfCombine', [8, 29, [1, 2], [B1], B8, 0, 1],
+    'sources.length != coefficients.length' ],
+  [ 'gfCombine', [8, 29, [256], [B1], B8, 0, 1], 'coefficient >= (1 << w)' ],
+  [ 'gfCombine', [8, 29, [1.5], [B1], B8, 0, 1], 'coefficient >= (1 << w)' ],
+  [ 'gfCombine', [8, 29, [1], [null], B8, 0, 1], 'source must be a Buffer' ],
+  [ 'gfCombine', [8, 29, [1], [B1], B8, 0, 2], 'size > source.length' ],
+  [ 'gfCombine', [8, 29, [1], [B8], B8, 8, 1],
+    'targetOffset + size > target.length' ],
+  [ 'gfCombine', [8, 29, [1], [B16.slice(4)], B16, 0, 8],
+    'source overlaps target' ]
 ].forEach(
   function(exception) {
     var error;
@@ -350,6 +716,539 @@ var B16 = Buffer.alloc(16);
   }
 })();
 
+function Ragged(end) {
+  // Shard sizes which are not a multiple of 8 (or of w) and buffer sizes which
+  // are not a multiple of k must encode exactly as if the caller had padded
+  // every data shard with zeroes:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var bufferOffset = Math.floor(Random() * 16);
+    var bufferSize = 1 + Math.floor(
+      Random() * (Random() < 0.5 ? k * 16 : k * 4096)
+    );
+    var shardSize = Math.ceil(bufferSize / k);
+    var paddedSize = Math.ceil(shardSize / 8) * 8;
+    var paritySize = paddedSize * m;
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('ragged,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferOffset + bufferSize));
+    cipher.final();
+    var parity = Buffer.alloc(paritySize);
+    var padded = Buffer.alloc(paddedSize * k);
+    var paddedParity = Buffer.alloc(paritySize);
+    for (var i = 0; i < k; i++) {
+      var start = bufferOffset + i * shardSize;
+      var limit = Math.min(start + shardSize, bufferOffset + bufferSize);
+      if (start < limit) buffer.copy(padded, i * paddedSize, start, limit);
+    }
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      padded,
+      0,
+      padded.length,
+      paddedParity,
+      0,
+      paritySize,
+      function(error) {
+        if (error) return end(error);
+        ReedSolomon.encode(
+          context,
+          sources,
+          targets,
+          buffer,
+          bufferOffset,
+          bufferSize,
+          parity,
+          0,
+          paritySize,
+          function(error) {
+            if (error) return end(error);
+            assert(Hash(parity) === Hash(paddedParity));
+            var expectBuffer = Hash(buffer);
+            var expectParity = Hash(parity);
+            var indices = [];
+            for (var i = 0; i < k + m; i++) indices.push(i);
+            Shuffle(indices);
+            var targets = 0;
+            var targetsLength = Math.ceil(Random() * m);
+            for (var i = 0; i < targetsLength; i++) {
+              targets |= (1 << indices[i]);
+            }
+            var sources = 0;
+            for (var i = targetsLength; i < k + m; i++) {
+              sources |= (1 << indices[i]);
+            }
+            for (var i = 0; i < k + m; i++) {
+              if (!(targets & (1 << i))) continue;
+              if (i < k) {
+                var start = bufferOffset + i * shardSize;
+                var limit = Math.min(
+                  start + shardSize,
+                  bufferOffset + bufferSize
+                );
+                if (start < limit) buffer.fill(255, start, limit);
+              } else {
+                Slice(parity, 0, paddedSize, i - k).fill(255);
+              }
+            }
+            ReedSolomon.encode(
+              context,
+              sources,
+              targets,
+              buffer,
+              bufferOffset,
+              bufferSize,
+              parity,
+              0,
+              paritySize,
+              function(error) {
+                if (error) return end(error);
+                assert(Hash(buffer) === expectBuffer);
+                assert(Hash(parity) === expectParity);
+                end();
+              }
+            );
+          }
+        );
+      }
+    );
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 500; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Files(end) {
+  // Encode and repair files stripe by stripe, comparing against encode():
+  var directory = Node.fs.mkdtempSync(
+    Node.path.join(Node.os.tmpdir(), 'reed-solomon-')
+  );
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * 8);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var shardSize = 8 * (1 + Math.floor(Random() * 2048));
+    var stripeSize = k * shardSize;
+    var stripes = Math.floor(Random() * 8);
+    var fdOffset = Math.floor(Random() * 4096);
+    var fdSize = stripes * stripeSize;
+    if (Random() < 0.5) fdSize += 1 + Math.floor(Random() * stripeSize);
+    stripes = Math.ceil(fdSize / stripeSize);
+    var parityOffset = Math.floor(Random() * 4096);
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('files,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var data = cipher.update(Buffer.alloc(fdOffset + fdSize));
+    cipher.final();
+    var dataPath = Node.path.join(directory, 'data');
+    Node.fs.writeFileSync(dataPath, data);
+    var fd = Node.fs.openSync(dataPath, 'r+');
+    var parityFds = [];
+    for (var j = 0; j < m; j++) {
+      parityFds.push(
+        Node.fs.openSync(Node.path.join(directory, 'parity' + j), 'w+')
+      );
+    }
+    function close(error) {
+      Node.fs.closeSync(fd);
+      parityFds.forEach(function(fd) { Node.fs.closeSync(fd); });
+      end(error);
+    }
+    function read(fd, offset, size) {
+      var buffer = Buffer.alloc(size);
+      if (size) Node.fs.readSync(fd, buffer, 0, size, offset);
+      return buffer;
+    }
+    // Expect the parity of each stripe padded with zeroes:
+    var expect = [];
+    for (var j = 0; j < m; j++) expect.push(Buffer.alloc(stripes * shardSize));
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    var queue = new Queue(1);
+    queue.onData = function(stripe, end) {
+      var buffer = Buffer.alloc(stripeSize);
+      data.copy(
+        buffer,
+        0,
+        fdOffset + stripe * stripeSize,
+        Math.min(fdOffset + fdSize, fdOffset + (stripe + 1) * stripeSize)
+      );
+      var parity = Buffer.alloc(m * shardSize);
+      ReedSolomon.encode(
+        context,
+        sources,
+        targets,
+        buffer,
+        0,
+        buffer.length,
+        parity,
+        0,
+        parity.length,
+        function(error) {
+          if (error) return end(error);
+          for (var j = 0; j < m; j++) {
+            parity.copy(
+              expect[j],
+              stripe * shardSize,
+              j * shardSize,
+              (j + 1) * shardSize
+            );
+          }
+          end();
+        }
+      );
+    };
+    queue.onEnd = function(error) {
+      if (error) return close(error);
+      ReedSolomon.encodeFile(
+        context,
+        shardSize,
+        fd,
+        fdOffset,
+        fdSize,
+        parityFds,
+        parityOffset,
+        function(error) {
+          if (error) return close(error);
+          for (var j = 0; j < m; j++) {
+            var parity = read(parityFds[j], parityOffset, expect[j].length);
+            assert(Hash(parity) === Hash(expect[j]));
+          }
+          // Corrupt shards and repair them in place:
+          var indices = [];
+          for (var i = 0; i < k + m; i++) indices.push(i);
+          Shuffle(indices);
+          var targets = 0;
+          var targetsLength = Math.ceil(Random() * m);
+          for (var i = 0; i < targetsLength; i++) {
+            targets |= (1 << indices[i]);
+          }
+          var sources = 0;
+          for (var i = targetsLength; i < k + m; i++) {
+            sources |= (1 << indices[i]);
+          }
+          var garbage = Buffer.alloc(shardSize, 255);
+          for (var stripe = 0; stripe < stripes; stripe++) {
+            for (var i = 0; i < k + m; i++) {
+              if (!(targets & (1 << i))) continue;
+              if (i < k) {
+                var offset = stripe * stripeSize + i * shardSize;
+                var size = Math.min(shardSize, Math.max(0, fdSize - offset));
+                if (size) {
+                  Node.fs.writeSync(fd, garbage, 0, size, fdOffset + offset);
+                }
+              } else {
+                Node.fs.writeSync(
+                  parityFds[i - k],
+                  garbage,
+                  0,
+                  shardSize,
+                  parityOffset + stripe * shardSize
+                );
+              }
+            }
+          }
+          var repairFds = parityFds.map(
+            function(fd, j) {
+              return ((sources | targets) & (1 << (k + j))) ? fd : -1;
+            }
+          );
+          ReedSolomon.repairFile(
+            context,
+            sources,
+            targets,
+            shardSize,
+            fd,
+            fdOffset,
+            fdSize,
+            repairFds,
+            parityOffset,
+            function(error) {
+              if (error) return close(error);
+              assert(Hash(read(fd, 0, fdOffset + fdSize)) === Hash(data));
+              for (var j = 0; j < m; j++) {
+                var parity = read(parityFds[j], parityOffset, expect[j].length);
+                assert(Hash(parity) === Hash(expect[j]));
+              }
+              close();
+            }
+          );
+        }
+      );
+    };
+    for (var stripe = 0; stripe < stripes; stripe++) queue.push(stripe);
+    queue.end();
+  };
+  queue.onEnd = function(error) {
+    if (error) return end(error);
+    // I/O errors are passed to the callback:
+    var context = ReedSolomon.create(2, 1);
+    var dataPath = Node.path.join(directory, 'data');
+    var fd = Node.fs.openSync(dataPath, 'r');
+    ReedSolomon.encodeFile(context, 8, fd, 0, 16, [fd], 0,
+      function(error) {
+        Node.fs.closeSync(fd);
+        Node.fs.rmSync(directory, { recursive: true });
+        if (!error) return end(new Error('expected an error'));
+        assert(error.code === 'EBADF');
+        end();
+      }
+    );
+  };
+  for (var iteration = 0; iteration < 100; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Pool(end) {
+  // Encode and repair stripes in the dedicated pool, including large stripes
+  // which are split into ranges, comparing against Node's threadpool:
+  var stripes = [];
+  for (var iteration = 0; iteration < 60; iteration++) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var bufferSize = 1 + Math.floor(
+      Random() * (Random() < 0.5 ? k * 4096 : k * 262144)
+    );
+    var shardSize = Math.ceil(bufferSize / k);
+    var paritySize = Math.ceil(shardSize / 8) * 8 * m;
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('pool,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    stripes.push({
+      context: ReedSolomon.create(k, m),
+      k: k,
+      m: m,
+      sources: sources,
+      targets: targets,
+      buffer: buffer,
+      parity: Buffer.alloc(paritySize),
+      expect: undefined
+    });
+  }
+  function Encode(stripe, end) {
+    ReedSolomon.encode(
+      stripe.context,
+      stripe.sources,
+      stripe.targets,
+      stripe.buffer,
+      0,
+      stripe.buffer.length,
+      stripe.parity,
+      0,
+      stripe.parity.length,
+      end
+    );
+  }
+  var expect = new Queue(1);
+  expect.onData = function(stripe, end) {
+    Encode(stripe,
+      function(error) {
+        if (error) return end(error);
+        stripe.expect = Hash(stripe.parity);
+        stripe.parity.fill(0);
+        end();
+      }
+    );
+  };
+  expect.onEnd = function(error) {
+    if (error) return end(error);
+    ReedSolomon.threads(3, 1);
+    var busy;
+    var queue = new Queue(8);
+    queue.onData = function(stripe, end) {
+      Encode(stripe,
+        function(error) {
+          if (error) return end(error);
+          assert(Hash(stripe.parity) === stripe.expect);
+          var hash = Hash(stripe.buffer);
+          var indices = [];
+          for (var i = 0; i < stripe.k + stripe.m; i++) indices.push(i);
+          Shuffle(indices);
+          var targets = 0;
+          for (var i = 0; i < stripe.m; i++) targets |= (1 << indices[i]);
+          var sources = 0;
+          for (var i = stripe.m; i < stripe.k + stripe.m; i++) {
+            sources |= (1 << indices[i]);
+          }
+          var shardSize = Math.ceil(stripe.buffer.length / stripe.k);
+          var paddedSize = stripe.parity.length / stripe.m;
+          for (var i = 0; i < stripe.k + stripe.m; i++) {
+            if (!(targets & (1 << i))) continue;
+            if (i < stripe.k) {
+              stripe.buffer.fill(
+                255,
+                Math.min(i * shardSize, stripe.buffer.length),
+                Math.min((i + 1) * shardSize, stripe.buffer.length)
+              );
+            } else {
+              Slice(stripe.parity, 0, paddedSize, i - stripe.k).fill(255);
+            }
+          }
+          stripe.sources = sources;
+          stripe.targets = targets;
+          Encode(stripe,
+            function(error) {
+              if (error) return end(error);
+              assert(Hash(stripe.buffer) === hash);
+              assert(Hash(stripe.parity) === stripe.expect);
+              end();
+            }
+          );
+        }
+      );
+      if (busy === undefined) {
+        // The pool may not be reconfigured while tasks are pending:
+        try {
+          ReedSolomon.threads(1, 0);
+        } catch (e) {
+          busy = e.message;
+        }
+        assert(busy === 'pool is busy');
+      }
+    };
+    queue.onEnd = function(error) {
+      if (error) return end(error);
+      Throws();
+    };
+    queue.concat(stripes);
+    queue.end();
+  };
+  function Throws() {
+    // An end callback which throws is reported as an uncaught exception:
+    var thrown = new Error('end threw');
+    var caught = false;
+    process.once('uncaughtException',
+      function(error) {
+        assert(error === thrown);
+        caught = true;
+      }
+    );
+    Encode(stripes[0],
+      function(error) {
+        if (error) return end(error);
+        setImmediate(
+          function() {
+            assert(caught === true);
+            ReedSolomon.threads(0, 0);
+            end();
+          }
+        );
+        throw thrown;
+      }
+    );
+  }
+  expect.concat(stripes);
+  expect.end();
+}
+
+function PoolRanges(end) {
+  // Split medium stripes into ranges back to back, with several in flight, so
+  // that thieves race splitting threads for ranges as they are pushed:
+  var k = 10;
+  var m = 4;
+  var context = ReedSolomon.create(k, m);
+  var sources = 0;
+  var targets = 0;
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+  var stripes = [];
+  for (var index = 0; index < 4; index++) {
+    var shardSize = 262144 - 8 * index;
+    stripes.push({
+      buffer: Node.crypto.randomBytes(k * shardSize),
+      parity: Buffer.alloc(m * shardSize),
+      expect: undefined
+    });
+  }
+  function Encode(stripe, parity, end) {
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      stripe.buffer,
+      0,
+      stripe.buffer.length,
+      parity,
+      0,
+      parity.length,
+      end
+    );
+  }
+  var expect = new Queue(1);
+  expect.onData = function(stripe, end) {
+    Encode(stripe, stripe.parity,
+      function(error) {
+        if (error) return end(error);
+        stripe.expect = Hash(stripe.parity);
+        end();
+      }
+    );
+  };
+  expect.onEnd = function(error) {
+    if (error) return end(error);
+    ReedSolomon.threads(8, 0);
+    // Four lanes each encode a stripe back to back (with as little as possible
+    // on the JavaScript thread in between), checking every 100th encode:
+    var lanes = 4;
+    var encodes = 500;
+    var pending = lanes;
+    var failed;
+    function Lane(lane) {
+      var stripe = stripes[lane % stripes.length];
+      var parity = Buffer.alloc(stripe.parity.length);
+      var count = 0;
+      function Next() {
+        Encode(stripe, parity,
+          function(error) {
+            if (error && !failed) failed = error;
+            if (failed) return Finish();
+            if (++count % 100 === 0) {
+              assert(Hash(parity) === stripe.expect);
+              parity.fill(0);
+            }
+            if (count < encodes) return Next();
+            Finish();
+          }
+        );
+      }
+      Next();
+    }
+    function Finish() {
+      if (--pending > 0) return;
+      ReedSolomon.threads(0, 0);
+      end(failed);
+    }
+    for (var lane = 0; lane < lanes; lane++) Lane(lane);
+  };
+  expect.concat(stripes);
+  expect.end();
+}
+
 var queue = new Queue(1);
 queue.onData = function(args, end) {
   // Use this to regenerate the fixed test vectors:
@@ -525,15 +1424,1656 @@ queue.onData = function(args, end) {
     }
   );
 };
-queue.onEnd = function(error) {
-  if (error) throw error;
-  console.log(new Array(50).join('='));
-  console.log('        PASSED');
-  console.log(new Array(50).join('='));
-};
-assert(typeof ReedSolomon.search === 'function');
-assert(ReedSolomon.MAX_K === 24);
-assert(ReedSolomon.MAX_M === 6);
+function Batch(end) {
+  // Batch completions (with reused references to a shared context and a
+  // shared callback) in Node's threadpool and in the dedicated pool:
+  var k = 10;
+  var m = 4;
+  var context = ReedSolomon.create(k, m);
+  var sources = 0;
+  var targets = 0;
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+  var stripes = [];
+  for (var index = 0; index < 500; index++) {
+    var bufferSize = 1 + Math.floor(Random() * k * 1024);
+    var shardSize = Math.ceil(bufferSize / k);
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('batch,' + index).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    stripes.push({
+      buffer: buffer,
+      parity: Buffer.alloc(Math.ceil(shardSize / 8) * 8 * m),
+      expect: undefined
+    });
+  }
+  var modes = [[0, 0, 0], [1, 0, 0], [1, 1, 0], [1, 1, 2], [0, 0, 2]];
+  function Mode() {
+    if (modes.length === 0) {
+      ReedSolomon.completions(0, 0);
+      ReedSolomon.threads(0, 0);
+      return end();
+    }
+    var mode = modes.shift();
+    ReedSolomon.completions(mode[0], mode[1]);
+    ReedSolomon.threads(mode[2], 0);
+    var pending = stripes.length;
+    function Callback(error) {
+      if (error) throw error;
+      if (--pending > 0) return;
+      stripes.forEach(
+        function(stripe) {
+          var hash = Hash(stripe.parity);
+          if (stripe.expect === undefined) stripe.expect = hash;
+          assert(hash === stripe.expect);
+          stripe.parity.fill(0);
+        }
+      );
+      ReedSolomon.threads(0, 0);
+      Mode();
+    }
+    stripes.forEach(
+      function(stripe) {
+        ReedSolomon.encode(
+          context,
+          sources,
+          targets,
+          stripe.buffer,
+          0,
+          stripe.buffer.length,
+          stripe.parity,
+          0,
+          stripe.parity.length,
+          Callback
+        );
+      }
+    );
+  }
+  Mode();
+}
+
+function Jit(end) {
+  // Encode and repair with the JIT (where supported), comparing against the
+  // portable kernels, including shards which are short or not a multiple of
+  // the JIT's block size:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var bufferSize = 1 + Math.floor(
+      Random() * (Random() < 0.5 ? k * 512 : k * 131072)
+    );
+    var shardSize = Math.ceil(bufferSize / k);
+    var paritySize = Math.ceil(shardSize / 8) * 8 * m;
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('jit,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    var parity = Buffer.alloc(paritySize);
+    var expect = Buffer.alloc(paritySize);
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    function Encode(jit, sources, targets, buffer, parity, end) {
+      ReedSolomon.jit(jit);
+      ReedSolomon.encode(
+        context,
+        sources,
+        targets,
+        buffer,
+        0,
+        buffer.length,
+        parity,
+        0,
+        parity.length,
+        end
+      );
+    }
+    Encode(0, sources, targets, buffer, expect,
+      function(error) {
+        if (error) return end(error);
+        Encode(1, sources, targets, buffer, parity,
+          function(error) {
+            if (error) return end(error);
+            assert(Hash(parity) === Hash(expect));
+            // Repair as many data shards as possible:
+            var repaired = Buffer.from(buffer);
+            var targets = 0;
+            var sources = 0;
+            for (var i = 0; i < Math.min(k, m); i++) {
+              targets |= (1 << i);
+              repaired.fill(
+                0,
+                Math.min(i * shardSize, bufferSize),
+                Math.min((i + 1) * shardSize, bufferSize)
+              );
+            }
+            for (var i = 0; i < k + m; i++) {
+              if (!(targets & (1 << i))) sources |= (1 << i);
+            }
+            Encode(1, sources, targets, repaired, parity,
+              function(error) {
+                if (error) return end(error);
+                assert(Hash(repaired) === Hash(buffer));
+                end();
+              }
+            );
+          }
+        );
+      }
+    );
+  };
+  queue.onEnd = function(error) {
+    ReedSolomon.jit(0);
+    end(error);
+  };
+  for (var iteration = 0; iteration < 200; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function LRC(end) {
+  // Encode with LRC contexts, repair single failures from their local group
+  // alone, and repair multiple failures through global decoding:
+  function Group(k, l, i) {
+    return Math.floor(i * l / k);
+  }
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var l = 1 + Math.floor(Random() * Math.min(k, ReedSolomon.MAX_M));
+    var r = Math.floor(Random() * (ReedSolomon.MAX_M - l + 1));
+    var m = l + r;
+    var context = ReedSolomon.createLRC(k, l, r);
+    var bufferSize = 1 + Math.floor(Random() * k * 4096);
+    var shardSize = Math.ceil(bufferSize / k);
+    var paddedSize = Math.ceil(shardSize / 8) * 8;
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('lrc,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    var parity = Buffer.alloc(paddedSize * m);
+    function Shard(i) {
+      if (i < k) {
+        return buffer.slice(
+          Math.min(i * shardSize, bufferSize),
+          Math.min((i + 1) * shardSize, bufferSize)
+        );
+      }
+      return Slice(parity, 0, paddedSize, i - k);
+    }
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      buffer,
+      0,
+      bufferSize,
+      parity,
+      0,
+      parity.length,
+      function(error) {
+        if (error) return end(error);
+        // Each local parity is the XOR of its group:
+        for (var g = 0; g < l; g++) {
+          var sources = [Buffer.alloc(paddedSize)];
+          for (var i = 0; i < k; i++) {
+            if (Group(k, l, i) === g) sources.push(Shard(i));
+          }
+          assert(Hash(Shard(k + g)) === Hash(XOR(sources)));
+        }
+        var expectBuffer = Hash(buffer);
+        var expectParity = Hash(parity);
+        var indices = [];
+        for (var i = 0; i < k + m; i++) indices.push(i);
+        Shuffle(indices);
+        var targets = 0;
+        var sources = 0;
+        if (Random() < 0.5) {
+          // A single failure, repaired from its local group alone:
+          var target = indices[0];
+          while (target >= k + l) target = Math.floor(Random() * (k + l));
+          var g = target < k ? Group(k, l, target) : target - k;
+          targets = (1 << target);
+          for (var i = 0; i < k; i++) {
+            if (Group(k, l, i) === g && i !== target) sources |= (1 << i);
+          }
+          if (target !== k + g) sources |= (1 << (k + g));
+        } else {
+          var count = 1 + Math.floor(Random() * m);
+          for (var i = 0; i < count; i++) targets |= (1 << indices[i]);
+          for (var i = count; i < k + m; i++) sources |= (1 << indices[i]);
+        }
+        for (var i = 0; i < k + m; i++) {
+          if (targets & (1 << i)) Shard(i).fill(255);
+        }
+        try {
+          ReedSolomon.encode(
+            context,
+            sources,
+            targets,
+            buffer,
+            0,
+            bufferSize,
+            parity,
+            0,
+            parity.length,
+            function(error) {
+              if (error) return end(error);
+              assert(Hash(buffer) === expectBuffer);
+              assert(Hash(parity) === expectParity);
+              end();
+            }
+          );
+        } catch (error) {
+          // Any r + 1 failures are repairable, but not every m failures:
+          assert(error.message === 'sources cannot repair targets');
+          assert(Bits(targets) > r + 1);
+          end();
+        }
+      }
+    );
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 500; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Reads(end) {
+  // Repair with more than k sources, corrupting every source which reads()
+  // says is not read:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    if (Random() < 0.5) {
+      var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+      var context = ReedSolomon.create(k, m);
+    } else {
+      var l = 1 + Math.floor(Random() * Math.min(k, ReedSolomon.MAX_M));
+      var m = l + Math.floor(Random() * (ReedSolomon.MAX_M - l + 1));
+      var context = ReedSolomon.createLRC(k, l, m - l);
+    }
+    var shardSize = 8 * (1 + Math.floor(Random() * 512));
+    var buffer = Node.crypto.randomBytes(k * shardSize);
+    var parity = Buffer.alloc(m * shardSize);
+    function Shard(i) {
+      if (i < k) return Slice(buffer, 0, shardSize, i);
+      return Slice(parity, 0, shardSize, i - k);
+    }
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      buffer,
+      0,
+      buffer.length,
+      parity,
+      0,
+      parity.length,
+      function(error) {
+        if (error) return end(error);
+        var indices = [];
+        for (var i = 0; i < k + m; i++) indices.push(i);
+        Shuffle(indices);
+        var count = 1 + Math.floor(Random() * m);
+        var targets = 0;
+        var sources = 0;
+        for (var i = 0; i < count; i++) targets |= (1 << indices[i]);
+        for (var i = count; i < k + m; i++) sources |= (1 << indices[i]);
+        try {
+          var reads = ReedSolomon.reads(context, sources, targets);
+        } catch (error) {
+          assert(error.message === 'sources cannot repair targets');
+          return end();
+        }
+        assert((reads & ~sources) === 0);
+        var expect = {};
+        for (var i = 0; i < k + m; i++) {
+          if (targets & (1 << i)) {
+            expect[i] = Hash(Shard(i));
+            Shard(i).fill(255);
+          } else if (!(reads & (1 << i))) {
+            Shard(i).fill(170);
+          }
+        }
+        ReedSolomon.encode(
+          context,
+          sources,
+          targets,
+          buffer,
+          0,
+          buffer.length,
+          parity,
+          0,
+          parity.length,
+          function(error) {
+            if (error) return end(error);
+            for (var i in expect) assert(Hash(Shard(i)) === expect[i]);
+            end();
+          }
+        );
+      }
+    );
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 500; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Locate(end) {
+  // Corrupt a byte of a random shard, locate the shard from the syndromes of
+  // the stripe, and repair it:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var bufferSize = 1 + Math.floor(Random() * k * 65536);
+    var shardSize = Math.ceil(bufferSize / k);
+    var paddedSize = Math.ceil(shardSize / 8) * 8;
+    var buffer = Node.crypto.randomBytes(bufferSize);
+    var parity = Buffer.alloc(paddedSize * m);
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    function Locate(callback) {
+      ReedSolomon.locate(
+        context,
+        buffer,
+        0,
+        bufferSize,
+        parity,
+        0,
+        parity.length,
+        function(error, regions) {
+          if (error) return end(error);
+          callback(regions);
+        }
+      );
+    }
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      buffer,
+      0,
+      bufferSize,
+      parity,
+      0,
+      parity.length,
+      function(error) {
+        if (error) return end(error);
+        Locate(
+          function(regions) {
+            assert(regions.length === 0);
+            var expectBuffer = Hash(buffer);
+            var expectParity = Hash(parity);
+            // Corrupt a byte of a data shard (which is not padding) or parity:
+            do {
+              var shard = Math.floor(Random() * (k + m));
+            } while (shard < k && shard * shardSize >= bufferSize);
+            if (shard < k) {
+              var length = Math.min(shardSize, bufferSize - shard * shardSize);
+              var offset = Math.floor(Random() * length);
+              buffer[shard * shardSize + offset] ^= 1 + (iteration % 255);
+            } else {
+              var offset = Math.floor(Random() * paddedSize);
+              var index = (shard - k) * paddedSize + offset;
+              parity[index] ^= 1 + (iteration % 255);
+            }
+            Locate(
+              function(regions) {
+                assert(regions.length === 1);
+                assert(regions[0].offset <= offset);
+                assert(regions[0].offset + regions[0].size > offset);
+                assert(paddedSize % regions[0].size === 0);
+                if (m === 1) {
+                  // Corruption is detected but not located:
+                  assert(regions[0].shard === -1);
+                  return end();
+                }
+                assert(regions[0].shard === shard);
+                var targets = (1 << shard);
+                var sources = ((1 << (k + m)) - 1) & ~targets;
+                ReedSolomon.encode(
+                  context,
+                  sources,
+                  targets,
+                  buffer,
+                  0,
+                  bufferSize,
+                  parity,
+                  0,
+                  parity.length,
+                  function(error) {
+                    if (error) return end(error);
+                    assert(Hash(buffer) === expectBuffer);
+                    assert(Hash(parity) === expectParity);
+                    end();
+                  }
+                );
+              }
+            );
+          }
+        );
+      }
+    );
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 300; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Piggyback(end) {
+  // Encode a piggyback stripe, repair random shards (corrupting every
+  // substripe which reads() says is not read), and locate a corrupt byte:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 2 + Math.floor(Random() * (ReedSolomon.MAX_M - 1));
+    var context = ReedSolomon.createPiggyback(k, m);
+    var bufferSize = 1 + Math.floor(Random() * k * 16384);
+    var shardSize = Math.ceil(bufferSize / k);
+    // Parity shards are padded to a multiple of 8 bytes per substripe:
+    var paddedSize = Math.ceil(shardSize / 16) * 16;
+    var halfSize = paddedSize / 2;
+    var buffer = Node.crypto.randomBytes(bufferSize);
+    var parity = Buffer.alloc(paddedSize * m);
+    function Substripe(i, substripe) {
+      if (i < k) {
+        var start = Math.min(bufferSize, i * shardSize + substripe * halfSize);
+        var stop = Math.min(bufferSize, (i + 1) * shardSize);
+        return buffer.slice(start, Math.max(start, Math.min(stop,
+          start + halfSize)));
+      }
+      return Slice(parity, 0, paddedSize, i - k).slice(
+        substripe * halfSize,
+        substripe * halfSize + halfSize
+      );
+    }
+    function Encode(sources, targets, callback) {
+      ReedSolomon.encode(
+        context,
+        sources,
+        targets,
+        buffer,
+        0,
+        bufferSize,
+        parity,
+        0,
+        parity.length,
+        function(error) {
+          if (error) return end(error);
+          callback();
+        }
+      );
+    }
+    function Locate(callback) {
+      ReedSolomon.locate(
+        context,
+        buffer,
+        0,
+        bufferSize,
+        parity,
+        0,
+        parity.length,
+        function(error, regions) {
+          if (error) return end(error);
+          callback(regions);
+        }
+      );
+    }
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    Encode(sources, targets, function() {
+      // Parity 0 (all ones) has no piggyback and is the XOR of the data:
+      var data = Buffer.alloc(paddedSize * k);
+      buffer.copy(data, 0);
+      var shards = [];
+      for (var i = 0; i < k; i++) shards.push(Slice(data, 0, shardSize, i));
+      var parity0 = Slice(parity, 0, paddedSize, 0).slice(0, shardSize);
+      assert(parity0.equals(XOR(shards)));
+      // A single data shard is repaired from substripe b of k shards and
+      // substripe a of the rest of its group (rather than 2k substripes):
+      var all = ((1 << (k + m)) - 1) & ~1;
+      var halves = 0;
+      for (var substripe = 0; substripe < 2; substripe++) {
+        halves += Bits(ReedSolomon.reads(context, all, 1, substripe));
+      }
+      assert(halves === k + Math.ceil(k / (m - 1)));
+      var originalBuffer = Buffer.from(buffer);
+      var originalParity = Buffer.from(parity);
+      var indices = [];
+      for (var i = 0; i < k + m; i++) indices.push(i);
+      Shuffle(indices);
+      var count = 1 + Math.floor(Random() * m);
+      var targets = 0;
+      var sources = 0;
+      for (var i = 0; i < count; i++) targets |= (1 << indices[i]);
+      for (var i = count; i < k + m; i++) sources |= (1 << indices[i]);
+      if (Random() < 0.5) {
+        // Repair a single data shard from every other shard:
+        targets = 1 << Math.floor(Random() * k);
+        sources = ((1 << (k + m)) - 1) & ~targets;
+      }
+      var expect = {};
+      for (var i = 0; i < k + m; i++) {
+        if (!(targets & (1 << i))) continue;
+        expect[i] = Hash(Buffer.concat([Substripe(i, 0), Substripe(i, 1)]));
+      }
+      for (var substripe = 0; substripe < 2; substripe++) {
+        var reads = ReedSolomon.reads(context, sources, targets, substripe);
+        assert((reads & ~sources) === 0);
+        for (var i = 0; i < k + m; i++) {
+          if (targets & (1 << i)) {
+            Substripe(i, substripe).fill(255);
+          } else if (!(reads & (1 << i))) {
+            Substripe(i, substripe).fill(170);
+          }
+        }
+      }
+      Encode(sources, targets, function() {
+        for (var i = 0; i < k + m; i++) {
+          if (!(targets & (1 << i))) continue;
+          var shard = Buffer.concat([Substripe(i, 0), Substripe(i, 1)]);
+          assert(Hash(shard) === expect[i]);
+        }
+        // Restore the substripes which were not read, and locate a corrupt
+        // byte of a data shard (which is not padding) or parity:
+        originalBuffer.copy(buffer);
+        originalParity.copy(parity);
+        do {
+          var shard = Math.floor(Random() * (k + m));
+        } while (shard < k && shard * shardSize >= bufferSize);
+        if (shard < k) {
+          var length = Math.min(shardSize, bufferSize - shard * shardSize);
+          var offset = Math.floor(Random() * length);
+          buffer[shard * shardSize + offset] ^= 1 + (iteration % 255);
+        } else {
+          var offset = Math.floor(Random() * paddedSize);
+          var index = (shard - k) * paddedSize + offset;
+          parity[index] ^= 1 + (iteration % 255);
+        }
+        Locate(
+          function(regions) {
+            assert(regions.length === 1);
+            assert(regions[0].offset <= offset);
+            assert(regions[0].offset + regions[0].size > offset);
+            assert(halfSize % regions[0].size === 0);
+            assert(regions[0].shard === shard);
+            end();
+          }
+        );
+      });
+    });
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 300; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function GF(end) {
+  // Multiply, multiply-accumulate and combine regions over every field of the
+  // contexts (and others), synchronously and in the threadpool, against a
+  // multiply by shift and add, element by element:
+  var fields = [
+    [2, 7], [4, 19], [4, 25], [8, 29], [8, 101], [8, 113], [8, 135],
+    [8, 169], [8, 195], [8, 285]
+  ];
+  function Multiply(w, polynomial, a, b) {
+    var product = 0;
+    while (b) {
+      if (b & 1) product ^= a;
+      b >>= 1;
+      a <<= 1;
+      if (a & (1 << w)) a = (a ^ polynomial) & ((1 << w) - 1);
+    }
+    return product;
+  }
+  function MultiplyByte(w, polynomial, c, byte) {
+    var product = 0;
+    for (var shift = 0; shift < 8; shift += w) {
+      var element = (byte >> shift) & ((1 << w) - 1);
+      product |= Multiply(w, polynomial, c, element) << shift;
+    }
+    return product;
+  }
+  function Call(method, args, end) {
+    // Half of all calls are synchronous:
+    if (Random() < 0.5) {
+      ReedSolomon[method](...args);
+      return end();
+    }
+    ReedSolomon[method](...args.concat([end]));
+  }
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var field = fields[Math.floor(Random() * fields.length)];
+    var w = field[0];
+    var polynomial = field[1];
+    var size = Math.floor(Random() * (Random() < 0.5 ? 64 : 40000));
+    var c = Math.floor(Random() * (1 << w));
+    var source = Node.crypto.randomBytes(size + 16);
+    var sourceOffset = Math.floor(Random() * 16);
+    var target = Node.crypto.randomBytes(size + 16);
+    var targetOffset = Math.floor(Random() * 16);
+    var expect = Buffer.from(target);
+    var accumulate = Random() < 0.5;
+    for (var index = 0; index < size; index++) {
+      var product = MultiplyByte(w, polynomial, c, source[sourceOffset + index]);
+      if (accumulate) {
+        expect[targetOffset + index] ^= product;
+      } else {
+        expect[targetOffset + index] = product;
+      }
+    }
+    var sourceHash = Hash(source);
+    Call(
+      accumulate ? 'gfMultiplyXOR' : 'gfMultiply',
+      [w, polynomial, c, source, sourceOffset, target, targetOffset, size],
+      function(error) {
+        if (error) return end(error);
+        assert(Hash(source) === sourceHash);
+        assert(target.equals(expect));
+        // In place, where source is target:
+        var inPlace = Buffer.from(source);
+        Call(
+          'gfMultiply',
+          [w, polynomial, c, inPlace, 0, inPlace, 0, inPlace.length],
+          function(error) {
+            if (error) return end(error);
+            for (var index = 0; index < inPlace.length; index++) {
+              assert(
+                inPlace[index] === MultiplyByte(w, polynomial, c, source[index])
+              );
+            }
+            Combine();
+          }
+        );
+      }
+    );
+    function Combine() {
+      // More sources than the tables computed at a time:
+      var count = 1 + Math.floor(Random() * (Random() < 0.5 ? 4 : 40));
+      var coefficients = [];
+      var sources = [];
+      var expect = Buffer.alloc(size + 16);
+      for (var index = 0; index < count; index++) {
+        coefficients.push(Math.floor(Random() * (1 << w)));
+        sources.push(Node.crypto.randomBytes(size));
+        for (var offset = 0; offset < size; offset++) {
+          expect[targetOffset + offset] ^= MultiplyByte(
+            w,
+            polynomial,
+            coefficients[index],
+            sources[index][offset]
+          );
+        }
+      }
+      var target = Buffer.alloc(size + 16);
+      // Sources may be any view, and target is overwritten:
+      target.fill(255, targetOffset, targetOffset + size);
+      sources = sources.map(
+        function(source) {
+          return Random() < 0.5 ? source : new Uint8Array(source);
+        }
+      );
+      Call(
+        'gfCombine',
+        [w, polynomial, coefficients, sources, target, targetOffset, size],
+        function(error) {
+          if (error) return end(error);
+          assert(target.equals(expect));
+          end();
+        }
+      );
+    }
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 100; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Volume(end) {
+  // Mark writes to a volume of stripes and flush only the dirty stripes, with
+  // flushes and marks overlapping, to the same parity as encode():
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var shardSize = 8 * (1 + Math.floor(Random() * 512));
+    var stripeSize = k * shardSize;
+    var stripes = 1 + Math.floor(Random() * 200);
+    // The last stripe may be short:
+    var buffer = Node.crypto.randomBytes(
+      stripes * stripeSize - Math.floor(Random() * stripeSize)
+    );
+    var parity = Buffer.alloc(stripes * m * shardSize);
+    var concurrency = 1 + Math.floor(Random() * 8);
+    var volume = ReedSolomon.createVolume(
+      context,
+      shardSize,
+      buffer,
+      parity,
+      concurrency
+    );
+    assert.throws(
+      function() { volume.mark(0, buffer.length + 1); },
+      function(error) {
+        return error.message === 'offset + size > buffer.length';
+      }
+    );
+    assert.throws(
+      function() { volume.mark(0, -1); },
+      function(error) {
+        return error.message === 'bad arguments, expected: (int offset, ' +
+          'int size)';
+      }
+    );
+    assert.throws(
+      function() { volume.flush(null); },
+      function(error) {
+        return error.message === 'bad arguments, expected: (function end)';
+      }
+    );
+    function Expect(stripe) {
+      var data = Buffer.alloc(stripeSize);
+      buffer.copy(data, 0, stripe * stripeSize, (stripe + 1) * stripeSize);
+      return data;
+    }
+    function Check(stale, end) {
+      // Every stripe except those which are stale has the parity of encode():
+      var checks = new Queue(4);
+      checks.onData = function(stripe, end) {
+        var data = Expect(stripe);
+        var expect = Buffer.alloc(m * shardSize);
+        var sources = 0;
+        var targets = 0;
+        for (var i = 0; i < k; i++) sources |= (1 << i);
+        for (var i = k; i < k + m; i++) targets |= (1 << i);
+        ReedSolomon.encode(
+          context,
+          sources,
+          targets,
+          data,
+          0,
+          data.length,
+          expect,
+          0,
+          expect.length,
+          function(error) {
+            if (error) return end(error);
+            var actual = parity.slice(
+              stripe * m * shardSize,
+              (stripe + 1) * m * shardSize
+            );
+            assert(actual.equals(expect) !== (stripe in stale));
+            end();
+          }
+        );
+      };
+      checks.onEnd = end;
+      for (var stripe = 0; stripe < stripes; stripe++) checks.push(stripe);
+      checks.end();
+    }
+    // An empty volume flushes asynchronously:
+    assert(volume.dirty() === 0);
+    var flushed = false;
+    volume.flush(
+      function() {
+        flushed = true;
+        volume.mark(0, buffer.length);
+        assert(volume.dirty() === stripes);
+        volume.mark(0, 0);
+        assert(volume.dirty() === stripes);
+        volume.flush(
+          function() {
+            assert(volume.dirty() === 0);
+            Check({}, function(error) {
+              if (error) return end(error);
+              Rewrite();
+            });
+          }
+        );
+      }
+    );
+    assert(flushed === false);
+    function Rewrite() {
+      var stale = {};
+      var marked = {};
+      var writes = 1 + Math.floor(Random() * 8);
+      while (writes--) {
+        var offset = Math.floor(Random() * buffer.length);
+        var size = Math.floor(Random() * Math.min(
+          buffer.length - offset,
+          Random() < 0.5 ? 64 : 4 * stripeSize
+        ));
+        var first = Math.floor(offset / stripeSize);
+        if (Random() < 0.2) {
+          // A write which is not marked leaves its parity stale (unless its
+          // stripe is marked by another write):
+          if (first in marked || buffer[offset] === 255) continue;
+          buffer[offset] = 255;
+          stale[first] = true;
+          continue;
+        }
+        for (var index = offset; index < offset + size; index++) {
+          buffer[index] ^= 1;
+        }
+        volume.mark(offset, size);
+        for (var stripe = first; stripe * stripeSize < offset + size;
+          stripe++) {
+          marked[stripe] = true;
+          delete stale[stripe];
+        }
+      }
+      // Overlapping flushes each end once the volume is clean:
+      var pending = 2;
+      function Flushed() {
+        assert(volume.dirty() === 0);
+        if (--pending > 0) return;
+        Check(stale, end);
+      }
+      volume.flush(Flushed);
+      // Stripes marked while a flush drains are flushed before it ends:
+      volume.mark(0, 1);
+      delete stale[0];
+      volume.flush(Flushed);
+    }
+  };
+  queue.onEnd = function(error) {
+    if (error) return end(error);
+    Throws();
+  };
+  function Throws() {
+    // A flush which throws is reported without losing the flushes after it:
+    var context = ReedSolomon.create(2, 1);
+    var buffer = Node.crypto.randomBytes(2 * 64);
+    var parity = Buffer.alloc(64);
+    var volume = ReedSolomon.createVolume(context, 64, buffer, parity, 1);
+    var thrown = new Error('flush threw');
+    var caught = false;
+    process.once('uncaughtException',
+      function(error) {
+        assert(error === thrown);
+        caught = true;
+      }
+    );
+    volume.mark(0, buffer.length);
+    volume.flush(function() { throw thrown; });
+    volume.flush(
+      function() {
+        assert(volume.dirty() === 0);
+        // The exception thrown by the first flush has been reported:
+        setImmediate(
+          function() {
+            assert(caught === true);
+            end();
+          }
+        );
+      }
+    );
+  }
+  for (var iteration = 0; iteration < 50; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Layout(end) {
+  // Encode and repair data interleaved RAID-style in stripe units (rotating
+  // across shards), exactly as if the shards were contiguous:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    // Units both smaller and larger than a region:
+    var unit = 8 * (1 + Math.floor(Random() * (Random() < 0.5 ? 64 : 16384)));
+    var rows = 1 + Math.floor(Random() * 8);
+    var stride = k * unit + 8 * Math.floor(Random() * 3);
+    var rotation = Math.floor(Random() * k);
+    var layout = [unit, stride, rotation];
+    var shardSize = rows * unit;
+    var buffer = Node.crypto.randomBytes(rows * stride);
+    var parity = Buffer.alloc(m * shardSize);
+    function Unit(i, row) {
+      var offset = row * stride + ((i + row * rotation) % k) * unit;
+      return buffer.slice(offset, offset + unit);
+    }
+    // The same data as contiguous shards:
+    var shards = Buffer.alloc(k * shardSize);
+    for (var i = 0; i < k; i++) {
+      for (var row = 0; row < rows; row++) {
+        Unit(i, row).copy(shards, i * shardSize + row * unit);
+      }
+    }
+    var expect = Buffer.alloc(m * shardSize);
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      shards,
+      0,
+      shards.length,
+      expect,
+      0,
+      expect.length,
+      function(error) {
+        if (error) return end(error);
+        ReedSolomon.encodeLayout(
+          context,
+          layout,
+          sources,
+          targets,
+          buffer,
+          0,
+          buffer.length,
+          parity,
+          0,
+          parity.length,
+          function(error) {
+            if (error) return end(error);
+            assert(parity.equals(expect));
+            Repair();
+          }
+        );
+      }
+    );
+    function Repair() {
+      var expectBuffer = Hash(buffer);
+      var indices = [];
+      for (var i = 0; i < k + m; i++) indices.push(i);
+      Shuffle(indices);
+      var count = 1 + Math.floor(Random() * m);
+      var targets = 0;
+      var sources = 0;
+      for (var i = 0; i < count; i++) targets |= (1 << indices[i]);
+      for (var i = count; i < k + m; i++) sources |= (1 << indices[i]);
+      for (var i = 0; i < k + m; i++) {
+        if (!(targets & (1 << i))) continue;
+        if (i >= k) {
+          Slice(parity, 0, shardSize, i - k).fill(255);
+          continue;
+        }
+        for (var row = 0; row < rows; row++) Unit(i, row).fill(255);
+      }
+      ReedSolomon.encodeLayout(
+        context,
+        layout,
+        sources,
+        targets,
+        buffer,
+        0,
+        buffer.length,
+        parity,
+        0,
+        parity.length,
+        function(error) {
+          if (error) return end(error);
+          assert(Hash(buffer) === expectBuffer);
+          assert(parity.equals(expect));
+          end();
+        }
+      );
+    }
+  };
+  queue.onEnd = end;
+  for (var iteration = 0; iteration < 200; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Stripes(end) {
+  // Encode stripes allocated from the native arena, comparing against stripes
+  // allocated by Node:
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var shardSize = 1 + Math.floor(Random() * 65536);
+    var bufferSize = k * shardSize;
+    var paddedSize = Math.ceil(shardSize / 8) * 8;
+    var stripe = ReedSolomon.allocStripe(k, m, shardSize);
+    assert(stripe.buffer === stripe.parity);
+    assert(stripe.bufferOffset === 0);
+    assert(stripe.bufferSize === bufferSize);
+    assert(stripe.parityOffset % 64 === 0);
+    assert(stripe.parityOffset % 4096 !== 0);
+    assert(stripe.parityOffset >= bufferSize);
+    assert(stripe.paritySize === paddedSize * m);
+    assert(stripe.buffer.length === stripe.parityOffset + stripe.paritySize);
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('stripe,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    buffer.copy(stripe.buffer, stripe.bufferOffset);
+    // Reused stripes are not zeroed:
+    stripe.buffer.fill(
+      255,
+      stripe.parityOffset,
+      stripe.parityOffset + stripe.paritySize
+    );
+    var parity = Buffer.alloc(paddedSize * m);
+    var sources = 0;
+    var targets = 0;
+    for (var i = 0; i < k; i++) sources |= (1 << i);
+    for (var i = k; i < k + m; i++) targets |= (1 << i);
+    ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      buffer,
+      0,
+      bufferSize,
+      parity,
+      0,
+      parity.length,
+      function(error) {
+        if (error) return end(error);
+        ReedSolomon.encode(
+          context,
+          sources,
+          targets,
+          stripe.buffer,
+          stripe.bufferOffset,
+          stripe.bufferSize,
+          stripe.parity,
+          stripe.parityOffset,
+          stripe.paritySize,
+          function(error) {
+            if (error) return end(error);
+            assert(
+              Hash(stripe.parity.slice(
+                stripe.parityOffset,
+                stripe.parityOffset + stripe.paritySize
+              )) === Hash(parity)
+            );
+            end();
+          }
+        );
+      }
+    );
+  };
+  queue.onEnd = function(error) {
+    if (error) return end(error);
+    var stats = ReedSolomon.stripeStats();
+    assert(stats.allocations === 200);
+    assert(stats.reserved >= stats.allocated);
+    assert(stats.free === stats.reserved - stats.allocated);
+    assert(stats.reservedHuge <= stats.reserved);
+    assert(stats.reuses <= stats.allocations);
+    end();
+  };
+  for (var iteration = 0; iteration < 200; iteration++) queue.push(iteration);
+  queue.end();
+}
+
+function Priority(end) {
+  // Serve foreground tasks before background tasks held by the scheduler, and
+  // cancel held tasks:
+  var k = 4;
+  var m = 2;
+  var context = ReedSolomon.create(k, m);
+  var sources = 0;
+  var targets = 0;
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+  var shardSize = 8192;
+  var order = [];
+  var pending = 0;
+  var expect = undefined;
+  function Encode(name, priority, callback) {
+    var buffer = Buffer.alloc(k * shardSize, 1);
+    var parity = Buffer.alloc(m * shardSize);
+    pending++;
+    return ReedSolomon.encode(
+      context,
+      sources,
+      targets,
+      buffer,
+      0,
+      buffer.length,
+      parity,
+      0,
+      parity.length,
+      priority,
+      function(error) {
+        if (error) {
+          assert(error.message === 'cancelled');
+          assert(Hash(parity) === Hash(Buffer.alloc(parity.length)));
+        } else {
+          if (expect === undefined) expect = Hash(parity);
+          assert(Hash(parity) === expect);
+        }
+        order.push(error ? name + '!' : name);
+        if (--pending === 0) callback();
+      }
+    );
+  }
+  ReedSolomon.schedule(1, 0);
+  function Done() {
+    // Cancelled tasks are dispatched at once and may call back in any order:
+    var cancelled = order.filter(function(name) { return /!$/.test(name); });
+    assert(cancelled.sort().join(',') === 'b2!,f3!');
+    var encoded = order.filter(function(name) { return !/!$/.test(name); });
+    assert(encoded.join(',') === 'b0,f0,f1,f2,b1,b3,b4');
+    assert(ReedSolomon.cancel(ids.b1) === false);
+    assert(ReedSolomon.cancel(0) === false);
+    assert(ReedSolomon.cancel(4294967295) === false);
+    ReedSolomon.schedule(0, 0);
+    end();
+  }
+  var ids = {};
+  for (var i = 0; i < 5; i++) ids['b' + i] = Encode('b' + i, 1, Done);
+  for (var i = 0; i < 4; i++) ids['f' + i] = Encode('f' + i, 0, Done);
+  assert(typeof ids.b0 === 'number');
+  assert(ids.b1 === ids.b0 + 1);
+  // Cancelled held tasks call back with an error, without encoding:
+  assert(ReedSolomon.cancel(ids.b2) === true);
+  assert(ReedSolomon.cancel(ids.b2) === false);
+  assert(ReedSolomon.cancel(ids.f3) === true);
+}
+
+function Encoder(end) {
+  // Run stripes through an encoder's slots (including from its callbacks) and
+  // encode the same parity as encode():
+  var k = 6;
+  var m = 3;
+  var context = ReedSolomon.create(k, m);
+  var sources = 0;
+  var targets = 0;
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+  var shardSize = 4096;
+  var encoder = ReedSolomon.createEncoder(context, 2);
+  var run = encoder.run;
+  assert.throws(
+    function() { run(0, 0, B1, 0, 0, B1, 0, 0, function() {}); },
+    function(error) { return error.message === BadArgs.run; }
+  );
+  assert.throws(
+    function() { encoder.run(sources, targets, B1, 0, 1, B1, 0, 8); },
+    function(error) { return error.message === BadArgs.run; }
+  );
+  assert.throws(
+    function() {
+      encoder.run(sources, targets, B1, 0, 1, B1, 0, 8, 2, function() {});
+    },
+    function(error) { return error.message === 'priority != 0, 1'; }
+  );
+  assert.throws(
+    function() { encoder.run(sources, targets, B1, 0, 1, B1, 0, 8, null); },
+    function(error) { return error.message === BadArgs.run; }
+  );
+  assert.throws(
+    function() { encoder.run(0, targets, B1, 0, 1, B1, 0, 8, function() {}); },
+    function(error) { return error.message === 'sources == 0'; }
+  );
+  assert.throws(
+    function() { encoder.run(sources, targets, B1, 0, 0, B1, 0, 8, null); },
+    function(error) { return error.message === BadArgs.run; }
+  );
+  var stripes = 32;
+  var buffers = [];
+  for (var i = 0; i < stripes; i++) {
+    buffers.push(Node.crypto.randomBytes(k * shardSize - (i % 8)));
+  }
+  var encoded = 0;
+  var expected = buffers.map(
+    function(buffer) {
+      var parity = Buffer.alloc(m * shardSize);
+      ReedSolomon.encode(
+        context,
+        sources,
+        targets,
+        buffer,
+        0,
+        buffer.length,
+        parity,
+        0,
+        parity.length,
+        function(error) {
+          if (error) throw error;
+          if (++encoded === stripes) Start();
+        }
+      );
+      return parity;
+    }
+  );
+  var index = 0;
+  var pending = 0;
+  function Run() {
+    var buffer = buffers[index];
+    var parity = Buffer.alloc(m * shardSize);
+    var expect = expected[index++];
+    pending++;
+    return encoder.run(
+      sources,
+      targets,
+      buffer,
+      0,
+      buffer.length,
+      parity,
+      0,
+      parity.length,
+      index % 2,
+      function(error) {
+        if (error) throw error;
+        assert(Hash(parity) === Hash(expect));
+        // The slot is free again before the callback:
+        if (index < stripes) Run();
+        if (--pending === 0) {
+          assert(index === stripes);
+          end();
+        }
+      }
+    );
+  }
+  function Start() {
+    assert(typeof Run() === 'number');
+    assert(typeof Run() === 'number');
+    assert.throws(
+      function() {
+        var parity = Buffer.alloc(m * shardSize);
+        encoder.run(
+          sources,
+          targets,
+          buffers[0],
+          0,
+          buffers[0].length,
+          parity,
+          0,
+          parity.length,
+          function() {}
+        );
+      },
+      function(error) { return error.message === 'encoder is busy'; }
+    );
+  }
+}
+
+function ViewsWorker() {
+  // Runs in a worker (as source), encoding every workers-th stripe of input:
+  var input = require('worker_threads').workerData;
+  var ReedSolomon = require(input.binding);
+  var context = ReedSolomon.create(input.k, input.m);
+  var stripes = [];
+  for (var s = input.index; s < input.stripes; s += input.workers) {
+    stripes.push(s);
+  }
+  (function next() {
+    if (stripes.length === 0) return;
+    var offset = stripes.shift() * input.stripeSize;
+    ReedSolomon.encode(
+      context,
+      input.sources,
+      input.targets,
+      input.arena,
+      offset,
+      input.k * input.shardSize,
+      input.arena,
+      offset + input.k * input.shardSize,
+      input.m * input.shardSize,
+      function(error) {
+        if (error) throw error;
+        next();
+      }
+    );
+  })();
+}
+
+function Views(end) {
+  // Encode from TypedArrays, DataViews, ArrayBuffers and SharedArrayBuffers
+  // (at any byteOffset) exactly as from Buffers, and from several workers
+  // sharing one SharedArrayBuffer arena without copies:
+  var k = 5;
+  var m = 3;
+  var context = ReedSolomon.create(k, m);
+  var sources = 0;
+  var targets = 0;
+  for (var i = 0; i < k; i++) sources |= (1 << i);
+  for (var i = k; i < k + m; i++) targets |= (1 << i);
+  var shardSize = 1024;
+  var data = Node.crypto.randomBytes(k * shardSize);
+  var expect = Buffer.alloc(m * shardSize);
+  function View(type, bytes) {
+    if (type === 'ArrayBuffer' || type === 'SharedArrayBuffer') {
+      var arena = new global[type](bytes.length);
+      new Uint8Array(arena).set(bytes);
+      return { value: arena, bytes: new Uint8Array(arena) };
+    }
+    // A view at a byteOffset of 8 into a larger ArrayBuffer:
+    var arena = new ArrayBuffer(8 + bytes.length);
+    var view = new Uint8Array(arena, 8, bytes.length);
+    view.set(bytes);
+    if (type === 'DataView') {
+      return { value: new DataView(arena, 8, bytes.length), bytes: view };
+    }
+    var elements = bytes.length / global[type].BYTES_PER_ELEMENT;
+    return { value: new global[type](arena, 8, elements), bytes: view };
+  }
+  var types = [
+    'Uint8Array',
+    'Int16Array',
+    'Uint32Array',
+    'Float64Array',
+    'BigInt64Array',
+    'DataView',
+    'ArrayBuffer',
+    'SharedArrayBuffer'
+  ];
+  var queue = new Queue(1);
+  queue.onData = function(type, end) {
+    var buffer = View(type, data);
+    var parity = View(type, Buffer.alloc(m * shardSize));
+    // Offsets and sizes are in bytes, whatever the type of element, but the
+    // length of a context need not be a multiple of 8:
+    var contextType = /Buffer$/.test(type) ? type : 'DataView';
+    ReedSolomon.encode(
+      View(contextType, context).value,
+      sources,
+      targets,
+      buffer.value,
+      0,
+      data.length,
+      parity.value,
+      0,
+      m * shardSize,
+      function(error) {
+        if (error) return end(error);
+        assert(Buffer.from(parity.bytes).equals(expect));
+        var target = View(type, Buffer.alloc(16));
+        ReedSolomon.XOR(parity.value, 8, target.value, 0, 8);
+        assert(Buffer.from(target.bytes).equals(
+          Buffer.concat([expect.slice(8, 16), Buffer.alloc(8)])
+        ));
+        end();
+      }
+    );
+  };
+  queue.onEnd = function(error) {
+    if (error) return end(error);
+    Workers(end);
+  };
+  function Workers(end) {
+    // Each worker encodes its own stripes of one shared arena:
+    var workers = 4;
+    var stripes = 8;
+    var stripeSize = (k + m) * shardSize;
+    var arena = new SharedArrayBuffer(stripes * stripeSize);
+    for (var stripe = 0; stripe < stripes; stripe++) {
+      new Uint8Array(arena, stripe * stripeSize, k * shardSize).set(data);
+    }
+    var pending = workers;
+    for (var index = 0; index < workers; index++) {
+      var worker = new Node.worker_threads.Worker(
+        '(' + ViewsWorker.toString() + ')();',
+        {
+          eval: true,
+          workerData: {
+            arena: arena,
+            binding: Node.path.resolve(__dirname, 'binding_checked.node'),
+            index: index,
+            k: k,
+            m: m,
+            shardSize: shardSize,
+            sources: sources,
+            stripes: stripes,
+            stripeSize: stripeSize,
+            targets: targets,
+            workers: workers
+          }
+        }
+      );
+      worker.on('error', end);
+      worker.on('exit', function() {
+        if (--pending > 0) return;
+        for (var stripe = 0; stripe < stripes; stripe++) {
+          var parity = Buffer.from(
+            arena,
+            stripe * stripeSize + k * shardSize,
+            m * shardSize
+          );
+          assert(parity.equals(expect));
+        }
+        end();
+      });
+    }
+  }
+  ReedSolomon.encode(
+    context,
+    sources,
+    targets,
+    data,
+    0,
+    data.length,
+    expect,
+    0,
+    expect.length,
+    function(error) {
+      if (error) return end(error);
+      queue.concat(types);
+      queue.end();
+    }
+  );
+}
+
+function Dispatch(end) {
+  // Calibrate kernels, save and load the dispatch table, and encode the same
+  // parity with every kernel:
+  var directory = Node.fs.mkdtempSync(
+    Node.path.join(Node.os.tmpdir(), 'reed-solomon-')
+  );
+  var path = Node.path.join(directory, 'dispatch');
+  var empty = Node.path.join(directory, 'empty');
+  Node.fs.writeFileSync(empty, 'reed-solomon dispatch 1\n');
+  ReedSolomon.loadDispatch(empty);
+  assert(ReedSolomon.dispatch().length === 0);
+  var kernels = ['generic', 'specialized', 'jit'];
+  // Kernels are timed off the JavaScript thread:
+  var timed = false;
+  ReedSolomon.calibrate(ReedSolomon.create(10, 4), 4096,
+    function(error, calibrated) {
+      if (error) return end(error);
+      timed = true;
+      assert(kernels.indexOf(calibrated.kernel) >= 0);
+      assert(calibrated[calibrated.kernel] > 0);
+      assert(calibrated.generic > 0);
+      kernels.forEach(
+        function(kernel) {
+          if (calibrated[kernel] === undefined) return;
+          assert(calibrated[kernel] >= calibrated[calibrated.kernel]);
+        }
+      );
+      // Only local parities (no kernel):
+      ReedSolomon.calibrate(ReedSolomon.createLRC(6, 2, 0), 4096,
+        function(error, local) {
+          if (error) return end(error);
+          assert(local.kernel === 'default');
+          Table(calibrated);
+        }
+      );
+    }
+  );
+  assert(timed === false);
+  function Table(calibrated) {
+    var entries = ReedSolomon.dispatch();
+    assert(entries.length === 1);
+    assert(entries[0].w === 4);
+    assert(entries[0].k === 10);
+    assert(entries[0].shardSize === 4096);
+    assert(entries[0].kernel === calibrated.kernel);
+    ReedSolomon.saveDispatch(path);
+    ReedSolomon.loadDispatch(empty);
+    assert(ReedSolomon.dispatch().length === 0);
+    ReedSolomon.loadDispatch(path);
+    assert(JSON.stringify(ReedSolomon.dispatch()) === JSON.stringify(entries));
+    // A file which cannot be parsed is not loaded:
+    var invalid = Node.path.join(directory, 'invalid');
+    Node.fs.writeFileSync(
+      invalid,
+      'reed-solomon dispatch 1\n4 10 4096 fast\n'
+    );
+    assert.throws(
+      function() { ReedSolomon.loadDispatch(invalid); },
+      /^Error: loadDispatch: Invalid argument$/
+    );
+    assert(JSON.stringify(ReedSolomon.dispatch()) === JSON.stringify(entries));
+    for (var iteration = 0; iteration < 200; iteration++) {
+      queue.push(iteration);
+    }
+    queue.end();
+  }
+  var queue = new Queue(1);
+  queue.onData = function(iteration, end) {
+    var k = 1 + Math.floor(Random() * ReedSolomon.MAX_K);
+    var m = 1 + Math.floor(Random() * ReedSolomon.MAX_M);
+    var context = ReedSolomon.create(k, m);
+    var w = context[0];
+    var bufferSize = 1 + Math.floor(Random() * k * 16384);
+    var shardSize = Math.ceil(bufferSize / k);
+    var paddedSize = Math.ceil(shardSize / 8) * 8;
+    var cipher = Node.crypto.createCipheriv(
+      'AES-256-CTR',
+      Node.crypto.createHash('SHA256').update('dispatch,' + iteration).digest(),
+      Buffer.alloc(16)
+    );
+    var buffer = cipher.update(Buffer.alloc(bufferSize));
+    cipher.final();
+    var sources = 0;
+    var targets = 0;
+    var indices = [];
+    for (var i = 0; i < k + m; i++) indices.push(i);
+    Shuffle(indices);
+    var count = 1 + Math.floor(Random() * m);
+    for (var i = 0; i < count; i++) targets |= (1 << indices[i]);
+    for (var i = count; i < k + m; i++) sources |= (1 << indices[i]);
+    var expect = undefined;
+    var index = 0;
+    function Encode() {
+      if (index === kernels.length) return end();
+      // Force the kernel for this (w, k) and shard size:
+      Node.fs.writeFileSync(
+        path,
+        'reed-solomon dispatch 1\n' +
+        w + ' ' + k + ' ' + paddedSize + ' ' + kernels[index++] + '\n'
+      );
+      ReedSolomon.loadDispatch(path);
+      var parity = Buffer.alloc(paddedSize * m);
+      var stripe = Buffer.from(buffer);
+      ReedSolomon.encode(
+        context,
+        (1 << k) - 1,
+        ((1 << m) - 1) << k,
+        stripe,
+        0,
+        bufferSize,
+        parity,
+        0,
+        parity.length,
+        function(error) {
+          if (error) return end(error);
+          var hash = Hash(parity);
+          // Repair from a random pattern of sources:
+          for (var i = 0; i < k + m; i++) {
+            if (!(targets & (1 << i))) continue;
+            if (i < k) {
+              stripe.fill(
+                255,
+                Math.min(i * shardSize, bufferSize),
+                Math.min((i + 1) * shardSize, bufferSize)
+              );
+            } else {
+              parity.fill(255, (i - k) * paddedSize, (i - k + 1) * paddedSize);
+            }
+          }
+          ReedSolomon.encode(
+            context,
+            sources,
+            targets,
+            stripe,
+            0,
+            bufferSize,
+            parity,
+            0,
+            parity.length,
+            function(error) {
+              if (error) return end(error);
+              assert(Hash(parity) === hash);
+              assert(Hash(stripe) === Hash(buffer));
+              if (expect === undefined) expect = hash;
+              assert(hash === expect);
+              Encode();
+            }
+          );
+        }
+      );
+    }
+    Encode();
+  };
+  queue.onEnd = function(error) {
+    ReedSolomon.loadDispatch(empty);
+    Node.fs.rmSync(directory, { recursive: true });
+    end(error);
+  };
+}
+
+queue.onEnd = function(error) {
+  if (error) throw error;
+  var suites = new Queue(1);
+  suites.onData = function(suite, end) { suite(end); };
+  suites.onEnd = function(error) {
+    if (error) throw error;
+    console.log(new Array(50).join('='));
+    console.log('        PASSED');
+    console.log(new Array(50).join('='));
+  };
+  suites.concat([
+    Ragged, Files, Pool, PoolRanges, Batch, Jit, LRC, Reads, Locate,
+    Piggyback, Layout, GF, Stripes, Priority, Encoder, Volume, Views, Dispatch
+  ]);
+  suites.end();
+};
+assert(typeof ReedSolomon.search === 'function');
+assert(ReedSolomon.MAX_K === 24);
+assert(ReedSolomon.MAX_M === 6);
+// Contexts are created from the MATRICES table, which the checked build
+// asserts against a search of each matrix, for every (k, m):
+for (var k = 1; k <= ReedSolomon.MAX_K; k++) {
+  for (var m = 1; m <= ReedSolomon.MAX_M; m++) {
+    var context = ReedSolomon.create(k, m);
+    assert(context.length === 3 + k * context[0] * m * context[0]);
+  }
+}
 queue.concat([
   [ 1, 1,  3,  2,      8, '8f2f6338f7f86123959816e8fbb3ce1f'],
   [ 1, 1,  4,  2,  77856, '47b8befeab9ff4548d46121e3fd311e4'],